@@ -0,0 +1,409 @@
+/* host_dma.c
+   SPI slave + DMA emulation for the QLU host build
+   - the channel paced by an SPI RX DREQ is written by a feeder task that
+     reads the capture source (QLU_HOST_IQ: file, FIFO or stdin) at the SPI
+     clock, straight into the channel's write address with its ring wrap
+   - end of transfer: the chained channel runs (the firmware's control
+     channel re-arms the data channel through al1_transfer_count_trig), the
+     INTS0 bit is set and DMA_IRQ_0 is raised, all with the scheduler
+     suspended so tasks see the same register states as on the chip
+   - DREQ_FORCE channels complete inside the call that starts them; the
+     sniffer implements CRC32R with output reverse / invert (frame v2 CRC)
+
+   Environment:
+     QLU_HOST_IQ       capture to stream, "-" or unset = stdin
+     QLU_HOST_IQ_LOOP  0 = stop at the end of a regular file (default loops)
+     QLU_HOST_SPI_HZ   SPI clock override, default the spi_init() baud rate
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include "qlu_crc32.h"
+
+// Largest read() into the ring: the granularity at which the write pointer
+// (and transfer_count) moves, as the parser sees it
+#define HOST_DMA_BURST 256
+
+// SPI
+
+spi_hw_t host_spi_hw[2];
+
+static uint spi_baud[2];
+
+uint spi_init(spi_inst_t* spi, uint baudrate){
+    spi_baud[spi_get_index(spi)] = baudrate;
+    return baudrate;
+}
+
+void spi_deinit(spi_inst_t* spi){
+    (void)spi;
+}
+
+void spi_set_format(spi_inst_t* spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order){
+    (void)spi; (void)data_bits; (void)cpol; (void)cpha; (void)order;
+}
+
+void spi_set_slave(spi_inst_t* spi, bool slave){
+    (void)spi; (void)slave;
+}
+
+uint host_spi_baudrate_for_dreq(uint dreq){
+    if (dreq == DREQ_SPI0_RX) return spi_baud[0];
+    if (dreq == DREQ_SPI1_RX) return spi_baud[1];
+    return 0;
+}
+
+// DMA channels
+
+dma_hw_t host_dma_hw;
+
+typedef struct {
+    bool                     claimed;
+    bool                     busy;
+    dma_channel_config       cfg;
+    volatile uint8_t*        write_addr;
+    const volatile uint8_t*  read_addr;
+} host_dma_channel_t;
+
+static host_dma_channel_t channels[NUM_DMA_CHANNELS];
+
+typedef struct {
+    bool     enabled;
+    uint     channel;
+    uint     mode;
+    bool     reverse;
+    bool     invert;
+    uint32_t state;         // CRC register, kept bit-reflected for CRC32R
+} host_dma_sniffer_t;
+
+static host_dma_sniffer_t sniffer;
+
+static void channel_trigger(uint ch);
+
+static uint32_t bit_reverse32(uint32_t v){
+    uint32_t r = 0;
+    for (int k = 0; k < 32; k++) {
+        r = (r << 1) | (v & 1u);
+        v >>= 1;
+    }
+    return r;
+}
+
+// Next address after `step` bytes, wrapping inside a 2^bits aligned ring
+static inline uintptr_t ring_advance(uintptr_t addr, uint32_t step, uint8_t bits){
+    if (bits == 0) return addr + step;
+    uintptr_t mask = ((uintptr_t)1 << bits) - 1u;
+    return (addr & ~mask) | ((addr + step) & mask);
+}
+
+static void sniff_bytes(const volatile uint8_t* src, uint32_t len){
+    if (sniffer.mode == DMA_SNIFF_CTRL_CALC_VALUE_CRC32R) {
+        sniffer.state = ~qlu_crc32_update(~sniffer.state, (const uint8_t*)src, len);
+        return;
+    }
+    // CRC32, MSB first (not used by the firmware, kept bit-exact anyway)
+    for (uint32_t k = 0; k < len; k++) {
+        uint32_t c = bit_reverse32(sniffer.state) ^ ((uint32_t)src[k] << 24);
+        for (int b = 0; b < 8; b++) c = (c & 0x80000000u) ? (c << 1) ^ 0x04C11DB7u : (c << 1);
+        sniffer.state = bit_reverse32(c);
+    }
+}
+
+// A write landing on a trigger alias of a channel register block starts
+// that channel, as the control channel's write to al1_transfer_count_trig
+static void register_write_hook(volatile uint8_t* addr){
+    uintptr_t a    = (uintptr_t)addr;
+    uintptr_t base = (uintptr_t)&host_dma_hw.ch[0];
+    if (a < base || a >= base + sizeof(host_dma_hw.ch)) return;
+
+    uint   k   = (uint)((a - base) / sizeof(dma_channel_hw_t));
+    size_t off = (size_t)((a - base) % sizeof(dma_channel_hw_t));
+    if (off == offsetof(dma_channel_hw_t, al1_transfer_count_trig)) {
+        host_dma_hw.ch[k].transfer_count = host_dma_hw.ch[k].al1_transfer_count_trig;
+        channel_trigger(k);
+    }
+}
+
+static void channel_complete(uint ch){
+    host_dma_channel_t* c = &channels[ch];
+    c->busy = false;
+
+    if (c->cfg.chain_to != ch) channel_trigger(c->cfg.chain_to);
+
+    if (!c->cfg.irq_quiet && ((host_dma_hw.inte0 >> ch) & 1u)) {
+        __atomic_fetch_or(&host_dma_hw.ints0, 1u << ch, __ATOMIC_SEQ_CST);
+        host_irq_raise(DMA_IRQ_0);
+    }
+}
+
+// DREQ_FORCE: the whole transfer at once
+static void channel_run_now(uint ch){
+    host_dma_channel_t* c   = &channels[ch];
+    const uint32_t     size = 1u << c->cfg.size;
+    const bool        sniff = sniffer.enabled && sniffer.channel == ch && c->cfg.sniff;
+
+    while (host_dma_hw.ch[ch].transfer_count > 0) {
+        uint8_t word[4];
+        memcpy(word, (const void*)c->read_addr, size);
+        if (sniff) sniff_bytes(word, size);
+        memcpy((void*)c->write_addr, word, size);
+        register_write_hook(c->write_addr);
+
+        bool ring_r = c->cfg.ring_bits && !c->cfg.ring_write;
+        bool ring_w = c->cfg.ring_bits &&  c->cfg.ring_write;
+        if (c->cfg.read_incr)  c->read_addr  = (const volatile uint8_t*)ring_advance((uintptr_t)c->read_addr, size, ring_r ? c->cfg.ring_bits : 0);
+        if (c->cfg.write_incr) c->write_addr = (volatile uint8_t*)ring_advance((uintptr_t)c->write_addr, size, ring_w ? c->cfg.ring_bits : 0);
+        host_dma_hw.ch[ch].transfer_count--;
+    }
+    channel_complete(ch);
+}
+
+static void feed_attach(uint ch);
+
+static void channel_trigger(uint ch){
+    host_dma_channel_t* c = &channels[ch];
+    if (!c->cfg.enable) return;
+    if (host_dma_hw.ch[ch].transfer_count == 0) {
+        channel_complete(ch);
+        return;
+    }
+    c->busy = true;
+
+    if (c->cfg.dreq == DREQ_FORCE) channel_run_now(ch);
+    else if (host_spi_baudrate_for_dreq(c->cfg.dreq) > 0) feed_attach(ch);
+    // other DREQs have no source on the host: the channel just waits
+}
+
+int dma_claim_unused_channel(bool required){
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        if (!channels[ch].claimed) {
+            channels[ch].claimed = true;
+            return (int)ch;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "[HOST] no free DMA channel\n");
+        abort();
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel){
+    channels[channel].claimed = false;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config* config, volatile void* write_addr,
+                           const volatile void* read_addr, uint transfer_count, bool trigger){
+    host_dma_channel_t* c = &channels[channel];
+    c->cfg        = *config;
+    c->write_addr = (volatile uint8_t*)write_addr;
+    c->read_addr  = (const volatile uint8_t*)read_addr;
+    host_dma_hw.ch[channel].transfer_count = transfer_count;
+    if (trigger) channel_trigger(channel);
+}
+
+void dma_channel_start(uint channel){
+    channel_trigger(channel);
+}
+
+void dma_channel_abort(uint channel){
+    channels[channel].busy = false;
+}
+
+bool dma_channel_is_busy(uint channel){
+    return channels[channel].busy;
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void* read_addr, uint32_t transfer_count){
+    channels[channel].read_addr = (const volatile uint8_t*)read_addr;
+    host_dma_hw.ch[channel].transfer_count = transfer_count;
+    channel_trigger(channel);
+}
+
+void dma_channel_transfer_to_buffer_now(uint channel, volatile void* write_addr, uint32_t transfer_count){
+    channels[channel].write_addr = (volatile uint8_t*)write_addr;
+    host_dma_hw.ch[channel].transfer_count = transfer_count;
+    channel_trigger(channel);
+}
+
+// Sniffer
+
+void dma_sniffer_enable(uint channel, uint mode, bool force_channel_enable){
+    sniffer.enabled = true;
+    sniffer.channel = channel;
+    sniffer.mode    = mode;
+    if (force_channel_enable) channels[channel].cfg.sniff = true;
+}
+
+void dma_sniffer_disable(void){
+    sniffer.enabled = false;
+}
+
+void dma_sniffer_set_output_reverse_enabled(bool enable){
+    sniffer.reverse = enable;
+}
+
+void dma_sniffer_set_output_invert_enabled(bool enable){
+    sniffer.invert = enable;
+}
+
+void dma_sniffer_set_data_accumulator(uint32_t seed){
+    sniffer.state = bit_reverse32(seed);
+}
+
+uint32_t dma_sniffer_get_data_accumulator(void){
+    uint32_t out = sniffer.reverse ? sniffer.state : bit_reverse32(sniffer.state);
+    return sniffer.invert ? ~out : out;
+}
+
+// SPI RX feeder
+
+typedef struct {
+    int          channel;       // DMA channel on the SPI RX DREQ, -1 = none yet
+    int          fd;
+    bool         loop;
+    bool         ended;
+    uint32_t     rate_Bps;
+    uint64_t     t0_us;         // pacing origin
+    uint64_t     fed;           // bytes written since t0_us
+    uint64_t     lap_bytes;     // bytes since the last rewind
+    uint64_t     total;
+    TaskHandle_t task;
+} host_spi_feed_t;
+
+static host_spi_feed_t feed = { .channel = -1, .fd = -1 };
+
+static bool feed_open_source(void){
+    const char* path = getenv("QLU_HOST_IQ");
+    const char* loop = getenv("QLU_HOST_IQ_LOOP");
+
+    if (path == NULL || strcmp(path, "-") == 0) {
+        feed.fd = STDIN_FILENO;
+        path = "stdin";
+    } else {
+        feed.fd = open(path, O_RDONLY);
+        if (feed.fd < 0) {
+            fprintf(stderr, "[HOST] cannot open %s: %s\n", path, strerror(errno));
+            return false;
+        }
+    }
+    // A stalled pipe must not block the scheduler: poll it instead
+    fcntl(feed.fd, F_SETFL, fcntl(feed.fd, F_GETFL) | O_NONBLOCK);
+
+    struct stat st;
+    feed.loop = (fstat(feed.fd, &st) == 0) && S_ISREG(st.st_mode) && !(loop && strcmp(loop, "0") == 0);
+
+    printf("[HOST] SPI source %s at %u B/s%s\n", path, feed.rate_Bps, feed.loop ? ", looping" : "");
+    return true;
+}
+
+static void feed_write(uint ch, uint32_t n){
+    host_dma_channel_t* c = &channels[ch];
+
+    // Bytes are already in memory; the count and the pointer move together,
+    // and a finished transfer chains and interrupts before anyone looks
+    vTaskSuspendAll();
+    c->write_addr = (volatile uint8_t*)ring_advance((uintptr_t)c->write_addr, n,
+                                                    c->cfg.ring_write ? c->cfg.ring_bits : 0);
+    host_dma_hw.ch[ch].transfer_count -= n;
+    if (host_dma_hw.ch[ch].transfer_count == 0) channel_complete(ch);
+    xTaskResumeAll();
+
+    feed.fed       += n;
+    feed.lap_bytes += n;
+    feed.total     += n;
+}
+
+static void feed_task(void* params){
+    (void)params;
+    static uint8_t scratch[HOST_DMA_BURST];
+
+    if (!feed_open_source()) feed.ended = true;
+    feed.t0_us = time_us_64();
+
+    for (;;) {
+        const int ch = feed.channel;
+        if (feed.ended || ch < 0 || !channels[ch].busy) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            feed.t0_us = time_us_64();
+            feed.fed   = 0;
+            continue;
+        }
+
+        uint64_t now = time_us_64();
+        uint64_t due = (now - feed.t0_us) * feed.rate_Bps / 1000000u;
+        if (due <= feed.fed) {
+            vTaskDelay(1);
+            continue;
+        }
+
+        host_dma_channel_t* c = &channels[ch];
+        uint64_t n = due - feed.fed;
+        if (n > HOST_DMA_BURST) n = HOST_DMA_BURST;
+        if (n > host_dma_hw.ch[ch].transfer_count) n = host_dma_hw.ch[ch].transfer_count;
+
+        uint8_t* dst = scratch;
+        if (c->cfg.write_incr) {
+            dst = (uint8_t*)c->write_addr;
+            if (c->cfg.ring_write && c->cfg.ring_bits) {
+                uint32_t ring = 1u << c->cfg.ring_bits;
+                uint32_t room = ring - (uint32_t)((uintptr_t)dst & (ring - 1u));
+                if (n > room) n = room;
+            }
+        }
+
+        ssize_t r = read(feed.fd, dst, (size_t)n);
+        if (r > 0) {
+            if (!c->cfg.write_incr) *c->write_addr = scratch[r - 1];
+            feed_write((uint)ch, (uint32_t)r);
+        } else if (r == 0) {
+            if (feed.loop && feed.lap_bytes > 0 && lseek(feed.fd, 0, SEEK_SET) == 0) {
+                feed.lap_bytes = 0;
+                continue;
+            }
+            printf("[HOST] SPI source ended after %llu bytes\n", (unsigned long long)feed.total);
+            feed.ended = true;
+        } else if (errno == EAGAIN || errno == EINTR) {
+            // Nothing from the writer: the master is idle, pacing restarts
+            // from now instead of bursting to catch up
+            feed.t0_us = now;
+            feed.fed   = 0;
+            vTaskDelay(1);
+        } else {
+            fprintf(stderr, "[HOST] SPI source read failed: %s\n", strerror(errno));
+            feed.ended = true;
+        }
+    }
+}
+
+static void feed_attach(uint ch){
+    if (feed.channel == (int)ch) return;
+    feed.channel = (int)ch;
+
+    const char* hz = getenv("QLU_HOST_SPI_HZ");
+    uint32_t bits_per_s = (hz != NULL) ? (uint32_t)strtoul(hz, NULL, 0) : host_spi_baudrate_for_dreq(channels[ch].cfg.dreq);
+    feed.rate_Bps = (bits_per_s > 8u) ? bits_per_s / 8u : 1u;
+
+    if (feed.task == NULL) {
+        xTaskCreate(feed_task, "Host SPI DMA Feed", QLU_HOST_DMA_TASK_STACK, NULL,
+                    QLU_HOST_DMA_TASK_PRIORITY, &feed.task);
+    }
+}
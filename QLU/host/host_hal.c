@@ -0,0 +1,86 @@
+/* host_hal.c
+   pico-sdk basics for the QLU host build: time base, sleeps, stdio, board
+   id and the IRQ table the emulated peripherals raise through
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "pico/stdlib.h"
+#include "pico/unique_id.h"
+#include "hardware/irq.h"
+
+// Time
+
+static uint64_t monotonic_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Microseconds since the first call, as the RP2040 timer counts from boot
+uint64_t time_us_64(void){
+    static uint64_t boot_ns = 0;
+    uint64_t now = monotonic_ns();
+    if (boot_ns == 0) boot_ns = now;
+    return (now - boot_ns) / 1000u;
+}
+
+void sleep_us(uint64_t us){
+    struct timespec ts = { .tv_sec = (time_t)(us / 1000000u), .tv_nsec = (long)(us % 1000000u) * 1000 };
+    // The POSIX port ticks with a signal; finish the sleep across it
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+void sleep_ms(uint32_t ms){
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+bool stdio_init_all(void){
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    time_us_64();
+    return true;
+}
+
+// Board id: the host id, so the AP SSID is stable across runs
+
+void pico_get_unique_board_id(pico_unique_board_id_t* id_out){
+    uint64_t id = ((uint64_t)(uint32_t)gethostid() << 32) | 0x514C5530u;   // "QLU0"
+    for (int k = 0; k < PICO_UNIQUE_BOARD_ID_SIZE_BYTES; k++) {
+        id_out->id[k] = (uint8_t)(id >> (8 * (PICO_UNIQUE_BOARD_ID_SIZE_BYTES - 1 - k)));
+    }
+}
+
+// IRQs
+
+static irq_handler_t irq_handlers[HOST_NUM_IRQS];
+static volatile bool irq_enabled[HOST_NUM_IRQS];
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler){
+    if (num < HOST_NUM_IRQS) irq_handlers[num] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled){
+    if (num < HOST_NUM_IRQS) irq_enabled[num] = enabled;
+}
+
+// The handler runs in the raising task's context. With the scheduler
+// suspended it cannot be preempted half way (on the chip the ISR runs on the
+// core of the task that reads its counters), and the yield it requests
+// through portYIELD_FROM_ISR happens in xTaskResumeAll().
+void host_irq_raise(uint num){
+    if (num >= HOST_NUM_IRQS || !irq_enabled[num] || irq_handlers[num] == NULL) return;
+
+    vTaskSuspendAll();
+    irq_handlers[num]();
+    xTaskResumeAll();
+}
@@ -0,0 +1,181 @@
+/* host_net.c
+   Network side of the QLU host build: lwIP (NO_SYS, the firmware's
+   lwipopts.h) on a Linux tap device in place of the cyw43 radio
+   - setup_access_point() replaces src/ap.c: same 192.168.4.1/24 address,
+     same DHCP and captive DNS servers, so a client on the tap side gets a
+     lease and the web UI exactly as a phone on the QLU access point
+   - cyw43_arch_poll() drains the tap (non-blocking) and runs the lwIP
+     timers; serverTask keeps calling it under lwip_mutex
+
+   The tap is opened by name; as root it is created on the fly, otherwise
+   create it once with
+       sudo ip tuntap add dev qlu0 mode tap user $USER
+       sudo ip link set qlu0 up
+   and either run a DHCP client on qlu0 or give it 192.168.4.2/24. Without
+   a tap the task graph still runs, the web side just has no link.
+
+   Environment:
+     QLU_HOST_TAP  tap device name, default qlu0
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "pico/unique_id.h"
+
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/etharp.h"
+#include "lwip/pbuf.h"
+#include "lwip/timeouts.h"
+#include "netif/ethernet.h"
+
+#include "ap.h"
+#include "dhcpserver.h"
+#include "dnsserver.h"
+
+#define HOST_TAP_FRAME_MAX  1518
+// Frames handled per cyw43_arch_poll(), so one poll cannot hold lwip_mutex
+// for a whole burst
+#define HOST_TAP_POLL_BUDGET 64
+
+char dnss_captive_site[64];
+
+static struct netif tap_netif;
+static int          tap_fd = -1;
+static bool         lwip_ready = false;
+
+u32_t sys_now(void){
+    return (u32_t)(time_us_64() / 1000u);
+}
+
+static int tap_open(const char* name){
+    int fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+    if (fd < 0) return -1;
+
+    struct ifreq ifr = {0};
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+    if (ioctl(fd, TUNSETIFF, &ifr) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static err_t tap_linkoutput(struct netif* netif, struct pbuf* p){
+    (void)netif;
+    uint8_t frame[HOST_TAP_FRAME_MAX];
+    u16_t len = pbuf_copy_partial(p, frame, sizeof(frame), 0);
+    if (write(tap_fd, frame, len) != (ssize_t)len) return ERR_IF;
+    return ERR_OK;
+}
+
+static err_t tap_netif_init(struct netif* netif){
+    pico_unique_board_id_t id;
+    pico_get_unique_board_id(&id);
+
+    netif->name[0]    = 't';
+    netif->name[1]    = 'p';
+    netif->output     = etharp_output;
+    netif->linkoutput = tap_linkoutput;
+    netif->mtu        = 1500;
+    netif->flags      = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+
+    // Locally administered, tail from the board id
+    netif->hwaddr_len = ETH_HWADDR_LEN;
+    netif->hwaddr[0]  = 0x02;
+    netif->hwaddr[1]  = 0x51;
+    netif->hwaddr[2]  = 0x4C;
+    netif->hwaddr[3]  = id.id[1];
+    netif->hwaddr[4]  = id.id[2];
+    netif->hwaddr[5]  = id.id[3];
+    return ERR_OK;
+}
+
+struct netif* host_net_netif(void){
+    return (tap_fd >= 0) ? &tap_netif : NULL;
+}
+
+int cyw43_arch_init(void){
+    if (!lwip_ready) {
+        lwip_init();
+        lwip_ready = true;
+    }
+    return 0;
+}
+
+void cyw43_arch_deinit(void){
+    if (tap_fd >= 0) {
+        netif_remove(&tap_netif);
+        close(tap_fd);
+        tap_fd = -1;
+    }
+}
+
+void cyw43_arch_poll(void){
+    if (tap_fd >= 0) {
+        uint8_t frame[HOST_TAP_FRAME_MAX];
+        for (int k = 0; k < HOST_TAP_POLL_BUDGET; k++) {
+            ssize_t n = read(tap_fd, frame, sizeof(frame));
+            if (n <= 0) break;   // EAGAIN: drained
+
+            struct pbuf* p = pbuf_alloc(PBUF_RAW, (u16_t)n, PBUF_POOL);
+            if (p == NULL) break;
+            pbuf_take(p, frame, (u16_t)n);
+            if (tap_netif.input(p, &tap_netif) != ERR_OK) pbuf_free(p);
+        }
+    }
+    sys_check_timeouts();
+}
+
+int setup_access_point(const char *ssid, const char *password, const char *site_name){
+    (void)password;
+    cyw43_arch_init();
+
+    const char* tap_name = getenv("QLU_HOST_TAP");
+    if (tap_name == NULL || tap_name[0] == '\0') tap_name = "qlu0";
+
+    ip4_addr_t ip, mask, gw;
+    IP4_ADDR(&ip,   192,168,4,1);
+    IP4_ADDR(&mask, 255,255,255,0);
+    IP4_ADDR(&gw,    0,  0,  0,0);
+
+    tap_fd = tap_open(tap_name);
+    if (tap_fd < 0) {
+        printf("[HOST] tap %s unavailable (%s): running without network\n", tap_name, strerror(errno));
+    } else {
+        netif_add(&tap_netif, &ip, &mask, &gw, NULL, tap_netif_init, ethernet_input);
+        netif_set_default(&tap_netif);
+        netif_set_up(&tap_netif);
+        netif_set_link_up(&tap_netif);
+    }
+
+    static dhcp_server_t dhcp;
+    ip_addr_t dip, dnm;
+    IP_ADDR4(&dip, 192,168,4,1);
+    IP_ADDR4(&dnm, 255,255,255,0);
+    dhcp_server_init(&dhcp, &dip, &dnm);
+
+    static dns_server_t dns;
+    if(site_name != NULL){
+        strncpy(dnss_captive_site,site_name,sizeof(dnss_captive_site) - 1);
+    } else {
+        strncpy(dnss_captive_site,"picow.local",sizeof(dnss_captive_site) - 1);
+    }
+    dns_server_init(&dns, (ip_addr_t*)&ip, site_name);
+
+    printf("[INFO] AP pronto (host): SSID='%s', tap=%s, IP=192.168.4.1\n", ssid, tap_fd >= 0 ? tap_name : "-");
+    return 0;
+}
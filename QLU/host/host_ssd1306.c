@@ -0,0 +1,182 @@
+/* host_ssd1306.c
+   I2C master + SSD1306 for the QLU host build
+   - writes to the display address are decoded as the controller does:
+     control byte (Co / D#C), command stream with its argument counts,
+     GDDRAM writes through the column / page window in the selected
+     addressing mode
+   - after every data write the 128x64 GDDRAM is dumped as a binary PBM
+     (lit pixels white), replaced atomically so a viewer can poll it
+
+   Environment:
+     QLU_HOST_FB  dump path, default qlu_screen.pbm; empty = no dump
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+#define SSD1306_ADDR   0x3C
+#define SSD1306_WIDTH  128
+#define SSD1306_PAGES  8
+#define SSD1306_HEIGHT (SSD1306_PAGES * 8)
+
+i2c_inst_t host_i2c_inst[2] = { { .index = 0 }, { .index = 1 } };
+
+typedef struct {
+    uint8_t  gddram[SSD1306_PAGES][SSD1306_WIDTH];
+    uint8_t  mode;              // 0 horizontal, 1 vertical, 2 page
+    uint8_t  col, col_start, col_end;
+    uint8_t  page, page_start, page_end;
+    bool     display_on;
+    bool     inverted;
+
+    // Command in progress: opcode and the arguments still expected
+    uint8_t  cmd;
+    uint8_t  args[6];
+    uint8_t  n_args, want_args;
+
+    uint32_t frames;
+    const char* dump_path;
+    bool     dump_checked;
+} ssd1306_model_t;
+
+static ssd1306_model_t oled = {
+    .col_end  = SSD1306_WIDTH - 1,
+    .page_end = SSD1306_PAGES - 1,
+    .mode     = 2,
+};
+
+static uint8_t command_arg_count(uint8_t cmd){
+    switch (cmd) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        case 0x21: case 0x22: case 0xA3:
+            return 2;
+        case 0x29: case 0x2A:
+            return 5;
+        case 0x26: case 0x27:
+            return 6;
+        default:
+            return 0;
+    }
+}
+
+static void command_execute(ssd1306_model_t* d){
+    const uint8_t c = d->cmd;
+
+    if      (c == 0x20) d->mode = d->args[0] & 0x03u;
+    else if (c == 0x21) { d->col_start  = d->args[0] & 0x7Fu; d->col_end  = d->args[1] & 0x7Fu; d->col  = d->col_start;  }
+    else if (c == 0x22) { d->page_start = d->args[0] & 0x07u; d->page_end = d->args[1] & 0x07u; d->page = d->page_start; }
+    else if (c >= 0xB0 && c <= 0xB7) d->page = c & 0x07u;
+    else if (c <= 0x0F) d->col = (uint8_t)((d->col & 0xF0u) | (c & 0x0Fu));
+    else if (c <= 0x1F) d->col = (uint8_t)((d->col & 0x0Fu) | ((c & 0x07u) << 4));
+    else if (c == 0xAE || c == 0xAF) d->display_on = (c == 0xAF);
+    else if (c == 0xA6 || c == 0xA7) d->inverted   = (c == 0xA7);
+    // contrast, charge pump, scroll, multiplex...: no effect on the dump
+}
+
+static void command_byte(ssd1306_model_t* d, uint8_t b){
+    if (d->want_args > d->n_args) {
+        d->args[d->n_args++] = b;
+    } else {
+        d->cmd       = b;
+        d->n_args    = 0;
+        d->want_args = command_arg_count(b);
+    }
+    if (d->n_args == d->want_args) {
+        command_execute(d);
+        d->want_args = d->n_args = 0;
+    }
+}
+
+static void data_byte(ssd1306_model_t* d, uint8_t b){
+    d->gddram[d->page & 0x07u][d->col & 0x7Fu] = b;
+
+    if (d->mode == 1) {                                   // vertical
+        if (d->page++ >= d->page_end) {
+            d->page = d->page_start;
+            d->col  = (d->col >= d->col_end) ? d->col_start : (uint8_t)(d->col + 1);
+        }
+    } else {
+        if (d->col++ >= ((d->mode == 0) ? d->col_end : SSD1306_WIDTH - 1)) {
+            d->col = (d->mode == 0) ? d->col_start : 0;
+            if (d->mode == 0) d->page = (d->page >= d->page_end) ? d->page_start : (uint8_t)(d->page + 1);
+        }
+    }
+}
+
+static void framebuffer_dump(ssd1306_model_t* d){
+    if (!d->dump_checked) {
+        const char* path = getenv("QLU_HOST_FB");
+        d->dump_path    = (path == NULL) ? "qlu_screen.pbm" : (path[0] ? path : NULL);
+        d->dump_checked = true;
+        if (d->dump_path) printf("[HOST] SSD1306 framebuffer -> %s\n", d->dump_path);
+    }
+    if (d->dump_path == NULL) return;
+
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", d->dump_path);
+    FILE* f = fopen(tmp, "wb");
+    if (!f) return;
+
+    // P4: 1 = black, rows MSB first; the panel shows lit pixels white
+    fprintf(f, "P4\n%d %d\n", SSD1306_WIDTH, SSD1306_HEIGHT);
+    for (int y = 0; y < SSD1306_HEIGHT; y++) {
+        uint8_t row[SSD1306_WIDTH / 8] = {0};
+        for (int x = 0; x < SSD1306_WIDTH; x++) {
+            bool lit = d->display_on && (((d->gddram[y / 8][x] >> (y % 8)) & 1u) != d->inverted);
+            if (!lit) row[x / 8] |= (uint8_t)(0x80u >> (x % 8));
+        }
+        fwrite(row, 1, sizeof(row), f);
+    }
+    fclose(f);
+    rename(tmp, d->dump_path);
+    d->frames++;
+}
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate){
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+void i2c_deinit(i2c_inst_t* i2c){
+    (void)i2c;
+}
+
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop){
+    (void)i2c; (void)nostop;
+    if (addr != SSD1306_ADDR) return (int)len;
+
+    bool wrote_data = false;
+    size_t k = 0;
+    while (k < len) {
+        const uint8_t ctrl = src[k++];
+        const bool    data = (ctrl & 0x40u) != 0;
+        const bool    co   = (ctrl & 0x80u) != 0;
+
+        // Co = 1: one byte, then another control byte; Co = 0: the rest of
+        // the transfer is a stream
+        size_t end = co ? ((k < len) ? k + 1 : k) : len;
+        for (; k < end; k++) {
+            if (data) data_byte(&oled, src[k]);
+            else      command_byte(&oled, src[k]);
+            wrote_data |= data;
+        }
+    }
+
+    if (wrote_data) framebuffer_dump(&oled);
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop){
+    (void)i2c; (void)addr; (void)nostop;
+    memset(dst, 0, len);
+    return (int)len;
+}
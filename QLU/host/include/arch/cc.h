@@ -0,0 +1,24 @@
+#ifndef HOST_LWIP_ARCH_CC_H
+
+#define HOST_LWIP_ARCH_CC_H
+
+// lwIP platform glue for the host build (NO_SYS, glibc)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#define LWIP_ERRNO_STDINCLUDE   1
+#define LWIP_TIMEVAL_PRIVATE    0
+
+typedef int sys_prot_t;
+
+#define LWIP_PLATFORM_DIAG(x)   do { printf x; } while (0)
+
+#define LWIP_PLATFORM_ASSERT(x) do { printf("[LWIP] assertion \"%s\" failed at %s:%d\n", \
+                                            x, __FILE__, __LINE__); fflush(NULL); abort(); } while (0)
+
+#define LWIP_RAND()             ((u32_t)rand())
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef HOST_CYW43_H
+
+#define HOST_CYW43_H
+
+// Constants of the cyw43 driver API that appear in QLU declarations; the
+// radio itself is replaced by the tap netif in host/host_net.c
+
+#define CYW43_AUTH_OPEN          (0)
+#define CYW43_AUTH_WPA_TKIP_PSK  (0x00200002)
+#define CYW43_AUTH_WPA2_AES_PSK  (0x00400004)
+#define CYW43_AUTH_WPA2_MIXED_PSK (0x00400006)
+
+#define CYW43_ITF_STA 0
+#define CYW43_ITF_AP  1
+
+#endif
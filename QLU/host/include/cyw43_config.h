@@ -0,0 +1,11 @@
+#ifndef HOST_CYW43_CONFIG_H
+
+#define HOST_CYW43_CONFIG_H
+
+// dhcpserver.c only needs the millisecond clock of the cyw43 HAL
+
+#include "pico/stdlib.h"
+
+#define cyw43_hal_ticks_ms() ((uint32_t)(time_us_64() / 1000u))
+
+#endif
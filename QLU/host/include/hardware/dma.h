@@ -0,0 +1,133 @@
+#ifndef HOST_HARDWARE_DMA_H
+
+#define HOST_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/regs/dreq.h"
+
+// ---------------------------------------------------------------------------
+// RP2040 DMA as far as QLU.c uses it, emulated in host/host_dma.c
+// ---------------------------------------------------------------------------
+//
+//   - transfer_count, ints0 and the aliases the firmware takes the address
+//     of live in a register block, so ring_bytes_written() reads the same
+//     fields it reads on the chip
+//   - a channel paced by an SPI RX DREQ is fed from the capture source at
+//     the SPI clock; at the end of each transfer the chained channel runs
+//     (re-arming through al1_transfer_count_trig) and DMA_IRQ_0 fires
+//   - DREQ_FORCE channels copy at once; the sniffer computes CRC32R
+//   - addresses stay host pointers next to the register block (64-bit)
+
+#define NUM_DMA_CHANNELS 12
+
+typedef struct {
+    volatile uint32_t read_addr;
+    volatile uint32_t write_addr;
+    volatile uint32_t transfer_count;
+    volatile uint32_t ctrl_trig;
+    volatile uint32_t al1_ctrl;
+    volatile uint32_t al1_read_addr;
+    volatile uint32_t al1_write_addr;
+    volatile uint32_t al1_transfer_count_trig;
+} dma_channel_hw_t;
+
+typedef struct {
+    dma_channel_hw_t  ch[NUM_DMA_CHANNELS];
+    volatile uint32_t intr;
+    volatile uint32_t inte0;
+    volatile uint32_t intf0;
+    volatile uint32_t ints0;
+    volatile uint32_t sniff_ctrl;
+    volatile uint32_t sniff_data;
+} dma_hw_t;
+
+extern dma_hw_t host_dma_hw;
+
+#define dma_hw (&host_dma_hw)
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8  = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC32  0x0
+#define DMA_SNIFF_CTRL_CALC_VALUE_CRC32R 0x1
+
+typedef struct {
+    uint8_t size;           // dma_channel_transfer_size
+    bool    read_incr;
+    bool    write_incr;
+    bool    ring_write;     // ring applies to the write address
+    uint8_t ring_bits;      // 0 = no ring
+    uint8_t dreq;
+    uint8_t chain_to;       // own channel = no chaining
+    bool    irq_quiet;
+    bool    sniff;
+    bool    enable;
+} dma_channel_config;
+
+static inline dma_channel_config dma_channel_get_default_config(uint channel){
+    return (dma_channel_config){
+        .size       = DMA_SIZE_32,
+        .read_incr  = true,
+        .write_incr = false,
+        .dreq       = DREQ_FORCE,
+        .chain_to   = (uint8_t)channel,
+        .enable     = true,
+    };
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config* c, enum dma_channel_transfer_size size){ c->size = (uint8_t)size; }
+static inline void channel_config_set_read_increment(dma_channel_config* c, bool incr){ c->read_incr = incr; }
+static inline void channel_config_set_write_increment(dma_channel_config* c, bool incr){ c->write_incr = incr; }
+static inline void channel_config_set_dreq(dma_channel_config* c, uint dreq){ c->dreq = (uint8_t)dreq; }
+static inline void channel_config_set_chain_to(dma_channel_config* c, uint chain_to){ c->chain_to = (uint8_t)chain_to; }
+static inline void channel_config_set_irq_quiet(dma_channel_config* c, bool quiet){ c->irq_quiet = quiet; }
+static inline void channel_config_set_sniff_enable(dma_channel_config* c, bool sniff){ c->sniff = sniff; }
+static inline void channel_config_set_enable(dma_channel_config* c, bool enable){ c->enable = enable; }
+
+static inline void channel_config_set_ring(dma_channel_config* c, bool write, uint size_bits){
+    c->ring_write = write;
+    c->ring_bits  = (uint8_t)size_bits;
+}
+
+int  dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+
+void dma_channel_configure(uint channel, const dma_channel_config* config, volatile void* write_addr,
+                           const volatile void* read_addr, uint transfer_count, bool trigger);
+void dma_channel_start(uint channel);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void* read_addr, uint32_t transfer_count);
+void dma_channel_transfer_to_buffer_now(uint channel, volatile void* write_addr, uint32_t transfer_count);
+
+// DREQ_FORCE transfers complete inside the call that starts them
+static inline void dma_channel_wait_for_finish_blocking(uint channel){
+    while (dma_channel_is_busy(channel)) tight_loop_contents();
+}
+
+static inline void dma_channel_set_irq0_enabled(uint channel, bool enabled){
+    if (enabled) __atomic_fetch_or(&dma_hw->inte0, 1u << channel, __ATOMIC_SEQ_CST);
+    else         __atomic_fetch_and(&dma_hw->inte0, ~(1u << channel), __ATOMIC_SEQ_CST);
+}
+
+static inline bool dma_channel_get_irq0_status(uint channel){
+    return (__atomic_load_n(&dma_hw->ints0, __ATOMIC_SEQ_CST) >> channel) & 1u;
+}
+
+// Write-1-to-clear on the chip
+static inline void dma_channel_acknowledge_irq0(uint channel){
+    __atomic_fetch_and(&dma_hw->ints0, ~(1u << channel), __ATOMIC_SEQ_CST);
+}
+
+void     dma_sniffer_enable(uint channel, uint mode, bool force_channel_enable);
+void     dma_sniffer_disable(void);
+void     dma_sniffer_set_output_reverse_enabled(bool enable);
+void     dma_sniffer_set_output_invert_enabled(bool enable);
+void     dma_sniffer_set_data_accumulator(uint32_t seed);
+uint32_t dma_sniffer_get_data_accumulator(void);
+
+#endif
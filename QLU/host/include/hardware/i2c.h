@@ -0,0 +1,26 @@
+#ifndef HOST_HARDWARE_I2C_H
+
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+// I2C master as seen by the host port: writes to the SSD1306 address are
+// decoded into a framebuffer (host/host_ssd1306.c), anything else is acked
+// and dropped
+
+typedef struct i2c_inst {
+    uint index;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t host_i2c_inst[2];
+
+#define i2c0 (&host_i2c_inst[0])
+#define i2c1 (&host_i2c_inst[1])
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t* i2c);
+int  i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src, size_t len, bool nostop);
+int  i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst, size_t len, bool nostop);
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef HOST_HARDWARE_IRQ_H
+
+#define HOST_HARDWARE_IRQ_H
+
+#include "pico/stdlib.h"
+
+// RP2040 IRQ numbers of the peripherals the host port emulates
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+
+#define HOST_NUM_IRQS 32
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+// Host only: runs the handler of `num` if it is installed and enabled, with
+// the scheduler suspended so no task observes a half-served interrupt
+void host_irq_raise(uint num);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef HOST_HARDWARE_REGS_DREQ_H
+
+#define HOST_HARDWARE_REGS_DREQ_H
+
+// RP2040 DMA request numbers (datasheet 2.5.3.1) used by the host port
+#define DREQ_SPI0_TX  16
+#define DREQ_SPI0_RX  17
+#define DREQ_SPI1_TX  18
+#define DREQ_SPI1_RX  19
+#define DREQ_FORCE    0x3f
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef HOST_HARDWARE_SPI_H
+
+#define HOST_HARDWARE_SPI_H
+
+#include "pico/stdlib.h"
+#include "hardware/regs/dreq.h"
+
+// SPI peripheral as seen by the host port: only the baud rate and the slave
+// flag matter, the bytes a slave receives come from the DMA feeder in
+// host/host_dma.c (the channel whose DREQ is the SPI RX request)
+
+typedef struct {
+    volatile uint32_t cr0, cr1, dr, sr, cpsr, imsc, ris, mis, icr, dmacr;
+} spi_hw_t;
+
+typedef struct spi_inst spi_inst_t;
+
+extern spi_hw_t host_spi_hw[2];
+
+#define spi0 ((spi_inst_t*)&host_spi_hw[0])
+#define spi1 ((spi_inst_t*)&host_spi_hw[1])
+
+typedef enum { SPI_CPOL_0 = 0, SPI_CPOL_1 = 1 } spi_cpol_t;
+typedef enum { SPI_CPHA_0 = 0, SPI_CPHA_1 = 1 } spi_cpha_t;
+typedef enum { SPI_LSB_FIRST = 0, SPI_MSB_FIRST = 1 } spi_order_t;
+
+uint spi_init(spi_inst_t* spi, uint baudrate);
+void spi_deinit(spi_inst_t* spi);
+void spi_set_format(spi_inst_t* spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+void spi_set_slave(spi_inst_t* spi, bool slave);
+
+static inline spi_hw_t* spi_get_hw(spi_inst_t* spi){
+    return (spi_hw_t*)spi;
+}
+
+static inline uint spi_get_index(const spi_inst_t* spi){
+    return (spi == spi1) ? 1u : 0u;
+}
+
+static inline uint spi_get_dreq(spi_inst_t* spi, bool is_tx){
+    return (spi_get_index(spi) ? DREQ_SPI1_TX : DREQ_SPI0_TX) + (is_tx ? 0u : 1u);
+}
+
+// Host only: clock of the SPI whose RX request is `dreq`, 0 if never set up
+uint host_spi_baudrate_for_dreq(uint dreq);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef HOST_LWIPOPTS_H
+
+#define HOST_LWIPOPTS_H
+
+// Host build: the firmware options (configs/lwipopts.h) as the cyw43 poll
+// arch builds them, plus the host differences below
+
+#define PICO_CYW43_ARCH_POLL 1
+
+#include_next <lwipopts.h>
+
+// Every lwIP call is made under lwip_mutex, as on the Pico W
+#define SYS_LIGHTWEIGHT_PROT 0
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef HOST_PICO_CYW43_ARCH_H
+
+#define HOST_PICO_CYW43_ARCH_H
+
+// ---------------------------------------------------------------------------
+// cyw43_arch (lwIP poll flavour) on the host: lwIP runs NO_SYS as on the
+// Pico W, on a Linux tap device instead of the radio (host/host_net.c).
+// cyw43_arch_poll() drains the tap and runs the lwIP timers; callers keep
+// taking lwip_mutex around it exactly as on the chip.
+// ---------------------------------------------------------------------------
+
+#include "pico/stdlib.h"
+#include "cyw43.h"
+
+#include "lwip/ip4_addr.h"
+#include "lwip/netif.h"
+#include "lwip/tcp.h"
+
+int  cyw43_arch_init(void);
+void cyw43_arch_deinit(void);
+void cyw43_arch_poll(void);
+
+static inline void cyw43_arch_lwip_begin(void){}
+static inline void cyw43_arch_lwip_end(void){}
+
+// The tap netif standing in for the AP interface
+struct netif* host_net_netif(void);
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef HOST_PICO_CYW43_DRIVER_H
+
+#define HOST_PICO_CYW43_DRIVER_H
+
+#include "cyw43.h"
+
+#endif
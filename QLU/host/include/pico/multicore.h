@@ -0,0 +1,10 @@
+#ifndef HOST_PICO_MULTICORE_H
+
+#define HOST_PICO_MULTICORE_H
+
+// Single core POSIX port: the tasks carry their core affinity, nothing else
+// from pico_multicore is used
+
+#include "pico/stdlib.h"
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef HOST_PICO_STDLIB_H
+
+#define HOST_PICO_STDLIB_H
+
+// ---------------------------------------------------------------------------
+// Host stand-in for the pico-sdk surface used by QLU.c and its headers
+// ---------------------------------------------------------------------------
+//
+//   Only what the firmware sources call, with the SDK signatures. Timing is
+//   CLOCK_MONOTONIC from process start (time_us_32 wraps as on the RP2040),
+//   GPIO setup is a no-op. Implemented in host/host_hal.c.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned int uint;
+
+#define _u(x) x ## u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define __isr
+#define __not_in_flash_func(f) f
+#define __time_critical_func(f) f
+
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+
+static inline uint32_t time_us_32(void){
+    return (uint32_t)time_us_64();
+}
+
+static inline absolute_time_t get_absolute_time(void){
+    return time_us_64();
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t){
+    return (uint32_t)(t / 1000u);
+}
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+static inline void tight_loop_contents(void){}
+
+bool stdio_init_all(void);
+
+enum gpio_function {
+    GPIO_FUNC_XIP  = 0,
+    GPIO_FUNC_SPI  = 1,
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_I2C  = 3,
+    GPIO_FUNC_PWM  = 4,
+    GPIO_FUNC_SIO  = 5,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+#define GPIO_OUT 1
+#define GPIO_IN  0
+
+static inline void gpio_set_function(uint gpio, enum gpio_function fn){ (void)gpio; (void)fn; }
+static inline void gpio_pull_up(uint gpio){ (void)gpio; }
+static inline void gpio_init(uint gpio){ (void)gpio; }
+static inline void gpio_set_dir(uint gpio, bool out){ (void)gpio; (void)out; }
+static inline void gpio_put(uint gpio, bool value){ (void)gpio; (void)value; }
+
+#endif
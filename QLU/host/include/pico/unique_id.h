@@ -0,0 +1,16 @@
+#ifndef HOST_PICO_UNIQUE_ID_H
+
+#define HOST_PICO_UNIQUE_ID_H
+
+#include "pico/stdlib.h"
+
+#define PICO_UNIQUE_BOARD_ID_SIZE_BYTES 8
+
+typedef struct {
+    uint8_t id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+} pico_unique_board_id_t;
+
+// Derived from the host id, stable across runs on one machine
+void pico_get_unique_board_id(pico_unique_board_id_t* id_out);
+
+#endif
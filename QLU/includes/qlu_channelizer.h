@@ -0,0 +1,271 @@
+#ifndef QLU_CHANNELIZER_H
+
+#define QLU_CHANNELIZER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+// ---------------------------------------------------------------------------
+// POLYPHASE FFT CHANNELIZER — critically sampled analysis filterbank
+// ---------------------------------------------------------------------------
+//
+//   Splits a complex stream at fs into M equal sub-bands at fs/M each. For
+//   every M input samples:
+//       1. reverse commutator: newest sample -> branch 0 ... oldest -> M-1
+//       2. each branch runs a P-tap FIR (the M·P prototype split in M phases)
+//       3. one M-point inverse-sign FFT across the branch outputs
+//   Output k is the band centred at k·fs/M (k >= M/2 are negative
+//   frequencies), mixed to DC and decimated by M:
+//
+//       y_k[n] = Σ_m e^{+j2πkm/M} Σ_p h[pM + m] · x[(n - p)M - m]
+//
+//   Cost per input sample: P complex·real MACs + (log2 M)/2 butterflies,
+//   independent of how many sub-bands are consumed downstream.
+//
+//   Two variants share the design code:
+//       pfb_f32_*  float, host tools and benchmarks (unity DC gain)
+//       pfb_q15_*  int16 I/Q, Q15 coefficients, per-stage FFT scaling, for
+//                  the RP2040 (output = PFB_Q15_GAIN · input)
+//
+//   RAM for the Q15 variant at the maximum size (M=16, P=8):
+//       coefficients 256 B + delay lines 1 KB + twiddles/bitrev 64 B
+
+#define PFB_MAX_BRANCHES  16
+#define PFB_MAX_TAPS      8
+#define PFB_Q15_GAIN      0.5
+
+typedef struct { float   re, im; } pfb_cf32_t;
+typedef struct { int16_t re, im; } pfb_cq15_t;
+
+// ---------------------------------------------------------------------------
+// Shared design helpers
+// ---------------------------------------------------------------------------
+
+// Windowed-sinc lowpass, cutoff fs/(2M), Blackman window, Σh = 1
+static inline void pfb_design_prototype(double* h, uint32_t m, uint32_t taps){
+    uint32_t len = m * taps;
+    double   fc  = 0.5 / (double)m;
+    double   mid = 0.5 * (double)(len - 1);
+    double   sum = 0.0;
+
+    for (uint32_t n = 0; n < len; n++) {
+        double t = (double)n - mid;
+        double sinc = (fabs(t) < 1e-12) ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t);
+        double w = 0.42 - 0.5 * cos(2.0 * M_PI * n / (len - 1)) + 0.08 * cos(4.0 * M_PI * n / (len - 1));
+        h[n] = sinc * w;
+        sum += h[n];
+    }
+    for (uint32_t n = 0; n < len; n++) h[n] /= sum;
+}
+
+static inline uint32_t pfb_log2(uint32_t m){
+    uint32_t bits = 0;
+    while ((1u << bits) < m) bits++;
+    return bits;
+}
+
+static inline void pfb_build_bitrev(uint8_t* bitrev, uint32_t m){
+    uint32_t bits = pfb_log2(m);
+    for (uint32_t k = 0; k < m; k++) {
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < bits; b++) {
+            if (k & (1u << b)) r |= 1u << (bits - 1 - b);
+        }
+        bitrev[k] = (uint8_t)r;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Float variant
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint16_t m;
+    uint16_t taps;
+    uint16_t head;
+    uint8_t  bitrev[PFB_MAX_BRANCHES];
+    // Per-branch coefficients, time reversed so the window runs oldest -> newest
+    float      coeffs[PFB_MAX_BRANCHES][PFB_MAX_TAPS];
+    // Doubled delay line: the last P samples are always contiguous
+    pfb_cf32_t delay[PFB_MAX_BRANCHES][2 * PFB_MAX_TAPS];
+    pfb_cf32_t twiddle[PFB_MAX_BRANCHES / 2];
+} pfb_f32_t;
+
+// m must be a power of two <= PFB_MAX_BRANCHES, taps <= PFB_MAX_TAPS
+static inline int pfb_f32_init(pfb_f32_t* pfb, uint32_t m, uint32_t taps){
+    if (m < 2 || m > PFB_MAX_BRANCHES || (m & (m - 1)) != 0) return -1;
+    if (taps < 1 || taps > PFB_MAX_TAPS) return -1;
+
+    double h[PFB_MAX_BRANCHES * PFB_MAX_TAPS];
+    pfb_design_prototype(h, m, taps);
+
+    memset(pfb, 0, sizeof(*pfb));
+    pfb->m    = (uint16_t)m;
+    pfb->taps = (uint16_t)taps;
+    for (uint32_t b = 0; b < m; b++) {
+        for (uint32_t p = 0; p < taps; p++) {
+            pfb->coeffs[b][taps - 1 - p] = (float)h[p * m + b];
+        }
+    }
+    for (uint32_t k = 0; k < m / 2; k++) {
+        pfb->twiddle[k].re = (float)cos(2.0 * M_PI * k / m);
+        pfb->twiddle[k].im = (float)sin(2.0 * M_PI * k / m);
+    }
+    pfb_build_bitrev(pfb->bitrev, m);
+    return 0;
+}
+
+// In-place radix-2 DIT, e^{+j...} kernel, input already in bit-reversed order
+static inline void pfb_f32_fft(pfb_cf32_t* x, const pfb_cf32_t* tw, uint32_t m){
+    for (uint32_t len = 2; len <= m; len <<= 1) {
+        uint32_t half = len >> 1;
+        uint32_t step = m / len;
+        for (uint32_t base = 0; base < m; base += len) {
+            for (uint32_t j = 0; j < half; j++) {
+                pfb_cf32_t w = tw[j * step];
+                pfb_cf32_t a = x[base + j];
+                pfb_cf32_t b = x[base + j + half];
+                float tr = b.re * w.re - b.im * w.im;
+                float ti = b.re * w.im + b.im * w.re;
+                x[base + j].re        = a.re + tr;
+                x[base + j].im        = a.im + ti;
+                x[base + j + half].re = a.re - tr;
+                x[base + j + half].im = a.im - ti;
+            }
+        }
+    }
+}
+
+// Consumes exactly m input samples, writes m sub-band samples
+static inline void pfb_f32_step(pfb_f32_t* pfb, const pfb_cf32_t* in, pfb_cf32_t* out){
+    const uint32_t m    = pfb->m;
+    const uint32_t taps = pfb->taps;
+    const uint32_t h    = pfb->head;
+
+    for (uint32_t b = 0; b < m; b++) {
+        pfb_cf32_t s = in[m - 1 - b];
+        pfb->delay[b][h]        = s;
+        pfb->delay[b][h + taps] = s;
+
+        const pfb_cf32_t* win = &pfb->delay[b][h + 1];
+        const float*      c   = pfb->coeffs[b];
+        float acc_re = 0.0f;
+        float acc_im = 0.0f;
+        for (uint32_t p = 0; p < taps; p++) {
+            acc_re += c[p] * win[p].re;
+            acc_im += c[p] * win[p].im;
+        }
+        out[pfb->bitrev[b]] = (pfb_cf32_t){acc_re, acc_im};
+    }
+    pfb->head = (uint16_t)((h + 1 == taps) ? 0 : h + 1);
+
+    pfb_f32_fft(out, pfb->twiddle, m);
+}
+
+// n_in must be a multiple of m; out receives n_in/m frames of m sub-bands
+static inline void pfb_f32_process(pfb_f32_t* pfb, const pfb_cf32_t* in, uint32_t n_in, pfb_cf32_t* out){
+    for (uint32_t n = 0; n + pfb->m <= n_in; n += pfb->m) {
+        pfb_f32_step(pfb, in + n, out + n);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Q15 variant
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint16_t m;
+    uint16_t taps;
+    uint16_t head;
+    uint8_t  bitrev[PFB_MAX_BRANCHES];
+    int16_t    coeffs[PFB_MAX_BRANCHES][PFB_MAX_TAPS];
+    pfb_cq15_t delay[PFB_MAX_BRANCHES][2 * PFB_MAX_TAPS];
+    pfb_cq15_t twiddle[PFB_MAX_BRANCHES / 2];
+} pfb_q15_t;
+
+static inline int16_t pfb_sat16(int32_t v){
+    if (v >  32767) return  32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+// Coefficients are h·M/2 in Q15 (branch DC gain ~0.5, peak tap ~0.5), the
+// FFT halves every stage, so the overall gain is PFB_Q15_GAIN.
+static inline int pfb_q15_init(pfb_q15_t* pfb, uint32_t m, uint32_t taps){
+    if (m < 2 || m > PFB_MAX_BRANCHES || (m & (m - 1)) != 0) return -1;
+    if (taps < 1 || taps > PFB_MAX_TAPS) return -1;
+
+    double h[PFB_MAX_BRANCHES * PFB_MAX_TAPS];
+    pfb_design_prototype(h, m, taps);
+
+    memset(pfb, 0, sizeof(*pfb));
+    pfb->m    = (uint16_t)m;
+    pfb->taps = (uint16_t)taps;
+    for (uint32_t b = 0; b < m; b++) {
+        for (uint32_t p = 0; p < taps; p++) {
+            double c = h[p * m + b] * (double)m * PFB_Q15_GAIN * 32768.0;
+            pfb->coeffs[b][taps - 1 - p] = pfb_sat16((int32_t)lrint(c));
+        }
+    }
+    for (uint32_t k = 0; k < m / 2; k++) {
+        pfb->twiddle[k].re = pfb_sat16((int32_t)lrint(32767.0 * cos(2.0 * M_PI * k / m)));
+        pfb->twiddle[k].im = pfb_sat16((int32_t)lrint(32767.0 * sin(2.0 * M_PI * k / m)));
+    }
+    pfb_build_bitrev(pfb->bitrev, m);
+    return 0;
+}
+
+// Same butterfly as the float FFT, each stage scaled by 1/2
+static inline void pfb_q15_fft(pfb_cq15_t* x, const pfb_cq15_t* tw, uint32_t m){
+    for (uint32_t len = 2; len <= m; len <<= 1) {
+        uint32_t half = len >> 1;
+        uint32_t step = m / len;
+        for (uint32_t base = 0; base < m; base += len) {
+            for (uint32_t j = 0; j < half; j++) {
+                pfb_cq15_t w = tw[j * step];
+                pfb_cq15_t a = x[base + j];
+                pfb_cq15_t b = x[base + j + half];
+                int32_t tr = ((int32_t)b.re * w.re - (int32_t)b.im * w.im) >> 15;
+                int32_t ti = ((int32_t)b.re * w.im + (int32_t)b.im * w.re) >> 15;
+                x[base + j].re        = (int16_t)((a.re + tr) >> 1);
+                x[base + j].im        = (int16_t)((a.im + ti) >> 1);
+                x[base + j + half].re = (int16_t)((a.re - tr) >> 1);
+                x[base + j + half].im = (int16_t)((a.im - ti) >> 1);
+            }
+        }
+    }
+}
+
+static inline void pfb_q15_step(pfb_q15_t* pfb, const pfb_cq15_t* in, pfb_cq15_t* out){
+    const uint32_t m    = pfb->m;
+    const uint32_t taps = pfb->taps;
+    const uint32_t h    = pfb->head;
+
+    for (uint32_t b = 0; b < m; b++) {
+        pfb_cq15_t s = in[m - 1 - b];
+        pfb->delay[b][h]        = s;
+        pfb->delay[b][h + taps] = s;
+
+        const pfb_cq15_t* win = &pfb->delay[b][h + 1];
+        const int16_t*    c   = pfb->coeffs[b];
+        int32_t acc_re = 0;
+        int32_t acc_im = 0;
+        for (uint32_t p = 0; p < taps; p++) {
+            acc_re += (int32_t)c[p] * win[p].re;
+            acc_im += (int32_t)c[p] * win[p].im;
+        }
+        out[pfb->bitrev[b]] = (pfb_cq15_t){pfb_sat16(acc_re >> 15), pfb_sat16(acc_im >> 15)};
+    }
+    pfb->head = (uint16_t)((h + 1 == taps) ? 0 : h + 1);
+
+    pfb_q15_fft(out, pfb->twiddle, m);
+}
+
+static inline void pfb_q15_process(pfb_q15_t* pfb, const pfb_cq15_t* in, uint32_t n_in, pfb_cq15_t* out){
+    for (uint32_t n = 0; n + pfb->m <= n_in; n += pfb->m) {
+        pfb_q15_step(pfb, in + n, out + n);
+    }
+}
+
+#endif
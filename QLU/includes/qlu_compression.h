@@ -0,0 +1,99 @@
+#ifndef QLU_COMPRESSION_H
+
+#define QLU_COMPRESSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// ---------------------------------------------------------------------------
+// AM/AM + AM/PM compression detector (16QAM)
+// ---------------------------------------------------------------------------
+//
+//   BUC/LNB saturation pulls the outer 16QAM points inward and rotates them.
+//   Symbols are split by the amplitude ring of their slicer decision:
+//       ring 0: (±1, ±1)   |s|² =  2/10
+//       ring 1: (±1, ±3)   |s|² = 10/10
+//       ring 2: (±3, ±3)   |s|² = 18/10
+//   and a complex gain g_r = Σ rx·conj(ideal) / Σ|ideal|² is accumulated per
+//   ring. |g_r| is the AM/AM ratio and arg(g_r) the AM/PM rotation; both are
+//   reported relative to the inner ring so a plain gain/phase offset cancels.
+
+#define COMP_NUM_RINGS        3
+#define COMP_MIN_RING_SYMBOLS 16
+
+typedef struct {
+    double   sum_re[COMP_NUM_RINGS];
+    double   sum_im[COMP_NUM_RINGS];
+    double   sum_ideal_power[COMP_NUM_RINGS];
+    uint32_t count[COMP_NUM_RINGS];
+} compression_detector_t;
+
+typedef struct {
+    double gain_db[COMP_NUM_RINGS];
+    double phase_deg[COMP_NUM_RINGS];
+    // Inner ring gain minus outer ring gain (positive = outer points compressed)
+    double compression_db;
+    // Outer ring rotation minus inner ring rotation
+    double ampm_deg;
+    bool   valid;
+} compression_report_t;
+
+static inline void compression_reset(compression_detector_t* det){
+    for (int r = 0; r < COMP_NUM_RINGS; r++) {
+        det->sum_re[r]          = 0.0;
+        det->sum_im[r]          = 0.0;
+        det->sum_ideal_power[r] = 0.0;
+        det->count[r]           = 0;
+    }
+}
+
+// Ring index from the slicer decision: one step per axis sitting on the ±3 level
+static inline int compression_ring(double ideal_i, double ideal_q){
+    const double outer_level = 2.0 * QAM16_NORM;
+    return (fabs(ideal_i) > outer_level) + (fabs(ideal_q) > outer_level);
+}
+
+// Per-symbol update, reusing the decision already made for MER
+static inline void compression_accumulate(compression_detector_t* det,
+                                          double rx_i, double rx_q,
+                                          SlicerResult ideal){
+    int r = compression_ring(ideal.ideal_i, ideal.ideal_q);
+    // rx · conj(ideal)
+    det->sum_re[r]          += rx_i * ideal.ideal_i + rx_q * ideal.ideal_q;
+    det->sum_im[r]          += rx_q * ideal.ideal_i - rx_i * ideal.ideal_q;
+    det->sum_ideal_power[r] += ideal.ideal_i * ideal.ideal_i + ideal.ideal_q * ideal.ideal_q;
+    det->count[r]++;
+}
+
+static inline compression_report_t compression_finalize(const compression_detector_t* det){
+    compression_report_t rep = {0};
+
+    for (int r = 0; r < COMP_NUM_RINGS; r++) {
+        if (det->count[r] == 0 || det->sum_ideal_power[r] <= 0.0) continue;
+        double g_re = det->sum_re[r] / det->sum_ideal_power[r];
+        double g_im = det->sum_im[r] / det->sum_ideal_power[r];
+        rep.gain_db[r]   = 10.0 * log10(g_re * g_re + g_im * g_im + 1e-12);
+        rep.phase_deg[r] = atan2(g_im, g_re) * (180.0 / M_PI);
+    }
+
+    rep.valid = (det->count[0] >= COMP_MIN_RING_SYMBOLS) &&
+                (det->count[COMP_NUM_RINGS - 1] >= COMP_MIN_RING_SYMBOLS);
+    if (rep.valid) {
+        rep.compression_db = rep.gain_db[0] - rep.gain_db[COMP_NUM_RINGS - 1];
+        rep.ampm_deg       = rep.phase_deg[COMP_NUM_RINGS - 1] - rep.phase_deg[0];
+    }
+    return rep;
+}
+
+// Same decay policy as the skew accumulators: keep a fraction of history
+static inline void compression_decay(compression_detector_t* det, double keep){
+    for (int r = 0; r < COMP_NUM_RINGS; r++) {
+        det->sum_re[r]          *= keep;
+        det->sum_im[r]          *= keep;
+        det->sum_ideal_power[r] *= keep;
+        det->count[r]            = (uint32_t)(det->count[r] * keep);
+    }
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef QLU_CRC32_H
+
+#define QLU_CRC32_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ---------------------------------------------------------------------------
+// CRC-32 (IEEE 802.3 / zlib) — table driven, for host tools and the frame v2
+// trailer. On the RP2040 the same value comes from the DMA sniffer instead.
+// ---------------------------------------------------------------------------
+//
+//   Reflected polynomial 0xEDB88320, init 0xFFFFFFFF, final XOR 0xFFFFFFFF.
+//   qlu_crc32(buf, len) == zlib.crc32(buf) == esp_rom_crc32_le(0, buf, len).
+
+#define QLU_CRC32_POLY 0xEDB88320u
+
+static uint32_t qlu_crc32_table[256];
+static bool     qlu_crc32_ready = false;
+
+static inline void qlu_crc32_init(void){
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1u) ? (QLU_CRC32_POLY ^ (c >> 1)) : (c >> 1);
+        }
+        qlu_crc32_table[n] = c;
+    }
+    qlu_crc32_ready = true;
+}
+
+// Running form: start with crc = 0, feed chunks, the result is final
+static inline uint32_t qlu_crc32_update(uint32_t crc, const uint8_t* buf, size_t len){
+    if (!qlu_crc32_ready) qlu_crc32_init();
+    crc = ~crc;
+    for (size_t k = 0; k < len; k++) {
+        crc = qlu_crc32_table[(crc ^ buf[k]) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static inline uint32_t qlu_crc32(const uint8_t* buf, size_t len){
+    return qlu_crc32_update(0, buf, len);
+}
+
+// Over a power-of-two ring, starting at absolute position `pos`
+static inline uint32_t qlu_crc32_ring(const uint8_t* ring, uint32_t mask, uint32_t pos, uint32_t len){
+    uint32_t from  = pos & mask;
+    uint32_t first = (mask + 1u) - from;
+    if (first >= len) return qlu_crc32(ring + from, len);
+    return qlu_crc32_update(qlu_crc32(ring + from, first), ring, len - first);
+}
+
+#endif
@@ -2,8 +2,15 @@
 
 #define QLU_DEMOD_H
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 #include <math.h>
 
+// Shared by the firmware, libqlu_dsp (libs/qlu_dsp) and the c_sim tools, so
+// everything below is static / static inline: safe to include from several
+// translation units of one link. Needs PROCESS_BLOCK_SIZE first.
+
 // --- Estrutura de Troca de Mensagens (Core 0 -> Core 1) ---
 // Blocos de 256 amostras são enviados entre cores
 typedef struct {
@@ -26,6 +33,8 @@ typedef struct {
     double link_bw_hz;        
     // ADC sampling rate in Hz
     double sampling_rate_hz;  
+    // CIC decimation ahead of the symbol pipeline (0/1 = none, power of two)
+    uint16_t decimation;
     // Raised cosine roll-off factor (0.0 to 1.0)
     double roll_off;          
     
@@ -71,19 +80,19 @@ typedef struct {
 // Para sample: usa sample_count
 #define GET_AVG_POWER(demod,type,part) ((demod)->sum_ ## type ## _ ## part ## _power / (demod)->type ## _count)
 
-const int get_bits_per_symbol[] ={
+static const int get_bits_per_symbol[] ={
     [MOD_BPSK]  = 1,
     [MOD_QPSK]  = 2,
     [MOD_16QAM] = 4
 };
 
-const char* get_modulation_name[] = {
+static const char* get_modulation_name[] = {
     [MOD_BPSK]  = "BPSK",
     [MOD_QPSK]  = "QPSK",
     [MOD_16QAM] = "16QAM"
 };
 
-bool get_modulation_from_name(modulation_type_t* mod, char* name){
+static inline bool get_modulation_from_name(modulation_type_t* mod, const char* name){
     bool match = false;
     for(size_t i=0; i < MOD_NUM_MODULATIONS; i++){
         if(strcmp(get_modulation_name[i],name) == 0){
@@ -94,10 +103,15 @@ bool get_modulation_from_name(modulation_type_t* mod, char* name){
     return match;
 }
 
+// Rate seen by the symbol pipeline, after the CIC front-end
+static inline double config_output_rate_hz(const demod_config_t *cfg) {
+    return (cfg->decimation > 1) ? cfg->sampling_rate_hz / cfg->decimation : cfg->sampling_rate_hz;
+}
+
 static inline void config_calculate_derived(demod_config_t *cfg) {
     cfg->bits_per_symbol = get_bits_per_symbol[cfg->modulation];
     cfg->symbol_rate_hz = cfg->link_bw_hz / (1.0 + cfg->roll_off);
-    cfg->samples_per_symbol = ceil(cfg->sampling_rate_hz / cfg->symbol_rate_hz);
+    cfg->samples_per_symbol = ceil(config_output_rate_hz(cfg) / cfg->symbol_rate_hz);
 }
 
 static inline double config_get_scale_factor(const demod_config_t *cfg) {
@@ -108,13 +122,12 @@ static inline double config_get_scale_factor(const demod_config_t *cfg) {
        For normalized constellations (max amplitude ~1.0):
        scale ≈ half * 0.95
     */
-    const float scale_estimative = 1.3;
     uint32_t max_uint = ((1u << cfg->signal_resolution) - 1u);
     uint32_t half = max_uint / 2u;
     return (double)(half * 0.95) / 1.5f;
 }
 
-inline double slicer_calculate_power(double i, double q){
+static inline double slicer_calculate_power(double i, double q){
     return (i * i + q * q);
 }
 
@@ -127,26 +140,27 @@ typedef struct{
 
 typedef SlicerResult (*slicer_fn_t)(double,double);
 
-SlicerResult bpsk_slicer(double rx_i, double rx_q){
+static inline SlicerResult bpsk_slicer(double rx_i, double rx_q){
+    (void)rx_q;
     return (SlicerResult){
         .ideal_i = (rx_i >= 0.0) ? +1.0 : -1.0,
         .ideal_q = (0.0)
     };
-};
+}
 
 // Garante que Symbol Power = 1.0
-const float QPSK_NORM = 0.7071067812;
-SlicerResult qpsk_slicer(double rx_i, double rx_q){
+static const float QPSK_NORM = 0.7071067812;
+static inline SlicerResult qpsk_slicer(double rx_i, double rx_q){
     // QPSK is essentially two BPSK signals in quadrature.
     // We snap the incoming signal to the nearest +/- 1.0 level.
     return (SlicerResult){
         .ideal_i = (rx_i >= 0.0) ? QPSK_NORM : -QPSK_NORM,
         .ideal_q = (rx_q >= 0.0) ? QPSK_NORM : -QPSK_NORM
     };
-};
+}
 
 // 16-QAM: Levels +/- 1, +/- 3 must be scaled by 1/sqrt(10)
-const float QAM16_NORM = 0.3162277660; 
+static const float QAM16_NORM = 0.3162277660; 
 
 static inline double slice_pam4(double x) {
     double threshold = 2.0 * QAM16_NORM;
@@ -156,14 +170,14 @@ static inline double slice_pam4(double x) {
     return -3.0 * QAM16_NORM;
 }
 
-SlicerResult qam16_slicer(double rx_i, double rx_q){
+static inline SlicerResult qam16_slicer(double rx_i, double rx_q){
     return (SlicerResult){
         .ideal_i = slice_pam4(rx_i),
         .ideal_q = slice_pam4(rx_q)
     };
-};
+}
 
-slicer_fn_t get_slicer_by_mod[] = {
+static const slicer_fn_t get_slicer_by_mod[] = {
     [MOD_BPSK]  = bpsk_slicer,
     [MOD_QPSK]  = qpsk_slicer,
     [MOD_16QAM] = qam16_slicer
@@ -186,7 +200,7 @@ static inline int32_t uint16_to_signed(uint16_t raw, uint8_t resolution) {
 }
 
 
-void demod_init(demod_t *demod,demod_config_t cfg) {
+static inline void demod_init(demod_t *demod,demod_config_t cfg) {
     demod->config                  = cfg;
     demod->scale                   = config_get_scale_factor(&demod->config);
     demod->stream_idx              = 0;
@@ -199,11 +213,22 @@ void demod_init(demod_t *demod,demod_config_t cfg) {
     demod->sample_count            = 0;
 }
 
-void demod_cfg_update(demod_t *demod,demod_config_t cfg){
+static inline void demod_cfg_update(demod_t *demod,demod_config_t cfg){
     demod->config                  = cfg;
     demod->scale                   = config_get_scale_factor(&demod->config);
 }
 
+// Clears the MER/SNR accumulators and the running symbol (config keeps)
+static inline void demod_reset_accumulators(demod_t *demod){
+    demod->sym                     = (symbol_acc_t){0, 0, 0};
+    demod->sum_symbol_signal_power = 0.0;
+    demod->sum_symbol_error_power  = 0.0;
+    demod->symbol_count            = 0;
+    demod->sum_sample_signal_power = 0.0;
+    demod->sum_sample_error_power  = 0.0;
+    demod->sample_count            = 0;
+}
+
 // ---------------------------------------------------------------------------
 // SQI — Signal Quality Index (ported from modulations/metrics.py)
 // ---------------------------------------------------------------------------
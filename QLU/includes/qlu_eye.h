@@ -0,0 +1,121 @@
+#ifndef QLU_EYE_H
+
+#define QLU_EYE_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// EYE DIAGRAM — density accumulation of the I/Q rails over two symbols
+// ---------------------------------------------------------------------------
+//
+//   density[rail][time][amp] holds uint16 hit counters. The time axis spans
+//   2·sps samples starting at a symbol boundary; the amplitude axis is taken
+//   straight from the top bits of the raw ADC word, so every sample costs a
+//   single indexed increment per rail (column base comes from a LUT).
+//
+//   Counters are halved every EYE_HALVING_PERIOD samples, which bounds a hot
+//   bin at ~2·(period + block) and lets old traces fade out.
+
+#define EYE_AMP_BITS        5
+#define EYE_AMP_BINS        (1u << EYE_AMP_BITS)
+#define EYE_MAX_TIME_BINS   12
+#define EYE_MAX_SPS         16
+
+#define EYE_HALVING_PERIOD  16384u
+
+#define EYE_FRAME_VERSION   1
+#define EYE_FRAME_HDR_SIZE  8
+
+typedef enum {
+    EYE_RAIL_I,
+    EYE_RAIL_Q,
+
+    EYE_NUM_RAILS
+} eye_rail_t;
+
+typedef struct {
+    uint16_t density[EYE_NUM_RAILS][EYE_MAX_TIME_BINS * EYE_AMP_BINS];
+    // Sample phase inside the 2-symbol window -> base index of its column
+    uint16_t col_offset[2 * EYE_MAX_SPS];
+
+    uint8_t  phase;
+    uint8_t  span;        // 2·sps samples
+    uint8_t  time_bins;   // columns actually used (<= EYE_MAX_TIME_BINS)
+    uint8_t  amp_shift;   // resolution - EYE_AMP_BITS
+    uint32_t since_halving;
+} eye_diagram_t;
+
+#define EYE_FRAME_MAX_SIZE (EYE_FRAME_HDR_SIZE + sizeof(((eye_diagram_t*)0)->density))
+
+// Clears the density and rebuilds the column LUT. Must be called whenever
+// the symbol accumulator is reset so phase 0 stays on a symbol boundary.
+static inline void eye_configure(eye_diagram_t* eye, uint32_t sps, uint8_t resolution){
+    if (sps < 1)           sps = 1;
+    if (sps > EYE_MAX_SPS) sps = EYE_MAX_SPS;
+
+    memset(eye->density, 0, sizeof(eye->density));
+
+    eye->span      = (uint8_t)(2 * sps);
+    eye->time_bins = (eye->span < EYE_MAX_TIME_BINS) ? eye->span : EYE_MAX_TIME_BINS;
+    eye->amp_shift = (resolution > EYE_AMP_BITS) ? (uint8_t)(resolution - EYE_AMP_BITS) : 0;
+    eye->phase     = 0;
+    eye->since_halving = 0;
+
+    for (uint32_t t = 0; t < eye->span; t++) {
+        uint32_t col = (t * eye->time_bins) / eye->span;
+        eye->col_offset[t] = (uint16_t)(col * EYE_AMP_BINS);
+    }
+}
+
+static inline void eye_accumulate(eye_diagram_t* eye, uint16_t raw_i, uint16_t raw_q){
+    uint32_t col = eye->col_offset[eye->phase];
+    eye->density[EYE_RAIL_I][col + ((raw_i >> eye->amp_shift) & (EYE_AMP_BINS - 1))]++;
+    eye->density[EYE_RAIL_Q][col + ((raw_q >> eye->amp_shift) & (EYE_AMP_BINS - 1))]++;
+    if (++eye->phase == eye->span) eye->phase = 0;
+}
+
+// Called once per processed block; keeps the halving check out of the
+// per-sample path.
+static inline void eye_block_done(eye_diagram_t* eye, uint32_t n_samples){
+    eye->since_halving += n_samples;
+    if (eye->since_halving < EYE_HALVING_PERIOD) return;
+
+    uint32_t used = (uint32_t)eye->time_bins * EYE_AMP_BINS;
+    for (uint32_t r = 0; r < EYE_NUM_RAILS; r++) {
+        for (uint32_t k = 0; k < used; k++) {
+            eye->density[r][k] >>= 1;
+        }
+    }
+    eye->since_halving = 0;
+}
+
+// Binary frame layout (little endian counters, rail-major, then time, then amp):
+//   [0]'E' [1]'Y' [2]version [3]amp_bins [4]time_bins [5]span [6]rails [7]0
+//   uint16 density[rails][time_bins][amp_bins]
+static inline size_t eye_diagram_to_frame(const eye_diagram_t* eye, uint8_t* buf, size_t len){
+    size_t rail_bytes = (size_t)eye->time_bins * EYE_AMP_BINS * sizeof(uint16_t);
+    size_t total      = EYE_FRAME_HDR_SIZE + EYE_NUM_RAILS * rail_bytes;
+    if (len < total) return 0;
+
+    buf[0] = 'E';
+    buf[1] = 'Y';
+    buf[2] = EYE_FRAME_VERSION;
+    buf[3] = EYE_AMP_BINS;
+    buf[4] = eye->time_bins;
+    buf[5] = eye->span;
+    buf[6] = EYE_NUM_RAILS;
+    buf[7] = 0;
+
+    uint8_t* out = buf + EYE_FRAME_HDR_SIZE;
+    for (uint32_t r = 0; r < EYE_NUM_RAILS; r++) {
+        for (size_t k = 0; k < rail_bytes / sizeof(uint16_t); k++) {
+            uint16_t v = eye->density[r][k];
+            *out++ = (uint8_t)(v & 0xFF);
+            *out++ = (uint8_t)(v >> 8);
+        }
+    }
+    return total;
+}
+
+#endif
@@ -0,0 +1,397 @@
+#ifndef QLU_IMPAIR_H
+
+#define QLU_IMPAIR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "qlu_demod.h"
+#include "qlu_source.h"
+
+// ---------------------------------------------------------------------------
+// CHANNEL IMPAIRMENTS — AWGN, CFO, phase noise, clock drift, IQ skew, DC
+// ---------------------------------------------------------------------------
+//
+//   Applied in place to a block, in receiver order:
+//
+//       LO        x · e^{jθ[n]},  θ[n] = θ[n-1] + 2π·cfo/fs + N(0, 2π·Δν/fs)
+//                 (carrier offset plus Wiener phase noise of linewidth Δν)
+//       AWGN      + N(0, σ²) per component, σ² = P / SNR / 2, P the
+//                 reference signal power (1 for the unit-power
+//                 constellations the modems emit)
+//       IQ skew   I' = (1 + α)(I cos φ/2 + Q sin φ/2)
+//                 Q' =        -I sin φ/2 + Q cos φ/2      (skew.py)
+//       DC        + (dc_i, dc_q)
+//       clock     fractional delay τ walking by ppm·1e-6 per sample, linear
+//                 interpolation on a short delay line. A block keeps its
+//                 length, so τ wraps within [0, clock_slip): the stream
+//                 skips (fast ADC) or repeats (slow ADC) clock_slip samples
+//                 at once. With clock_slip = samples per symbol the slip is a
+//                 whole symbol, and between slips the symbol timing sweeps
+//                 every offset a real clock error would
+//
+//   Samples are floats in the demod's normalised domain; the u16 entry point
+//   converts offset binary at config_get_scale_factor() so the firmware test
+//   mode and the compiled-in streams use the same amplitude.
+//
+//   The carrier is a 32-bit NCO (exact over any run, fs/2^32 resolution) with
+//   the Wiener phase kept as a separate wrapped float.
+//
+//   Normals come from a Marsaglia-Tsang ziggurat (128 layers, xorshift32),
+//   tables built once per state. Work is split into QLU_IMPAIR_CHUNK
+//   passes over plain float arrays: the random draws and the phase
+//   recursion are scalar, the rotation (branch-free polynomial sincos),
+//   noise add, skew matrix, DC and conversions are straight loops the host
+//   compiler vectorises. Parameters can change between blocks through
+//   qlu_impair_set() without resetting phase, clock or RNG.
+
+#define QLU_IMPAIR_CHUNK    64
+#define QLU_IMPAIR_MAX_SLIP 32
+#define QLU_IMPAIR_HIST     64          // power of two > QLU_IMPAIR_MAX_SLIP + 1
+#define QLU_ZIG_LAYERS      128
+
+typedef struct {
+    float    sample_rate_hz;
+
+    bool     awgn;
+    float    snr_db;
+    float    signal_power;       // reference for snr_db, 0 = 1.0
+
+    float    cfo_hz;
+    float    phase_noise_hz;     // Wiener linewidth, 0 = off
+    float    clock_ppm;          // ADC clock offset, + = fast
+    uint16_t clock_slip;         // samples skipped / repeated per wrap, 0 = 1
+
+    float    iq_amp_db;
+    float    iq_phase_deg;
+
+    float    dc_i, dc_q;         // normalised units
+} qlu_impair_config_t;
+
+typedef struct {
+    uint32_t kn[QLU_ZIG_LAYERS];
+    float    wn[QLU_ZIG_LAYERS];
+    float    fn[QLU_ZIG_LAYERS];
+    uint32_t state;
+} qlu_ziggurat_t;
+
+typedef struct {
+    qlu_impair_config_t cfg;
+
+    // Derived from cfg by qlu_impair_set()
+    float    awgn_sigma;
+    uint32_t nco_step;           // carrier phase per sample, 2^32 = 2π
+    float    pn_sigma;           // rad / sqrt(sample)
+    float    clock_step;         // delay change per sample
+    float    clock_slip;
+    float    skew_ii, skew_iq, skew_qi, skew_qq;
+    bool     rotate, skew, dc, resample;
+
+    // Running state
+    uint32_t nco;
+    float    pn_phase;           // [-π, π)
+    float    delay;              // τ, [0, clock_slip)
+    uint32_t hist_pos;           // next write in the delay line
+    float    hist_i[QLU_IMPAIR_HIST];
+    float    hist_q[QLU_IMPAIR_HIST];
+    qlu_ziggurat_t zig;
+} qlu_impair_t;
+
+// ---- Ziggurat ---------------------------------------------------------------
+
+static inline uint32_t qlu_zig_next(qlu_ziggurat_t* z){
+    uint32_t x = z->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return z->state = x;
+}
+
+// Uniform in (0, 1)
+static inline float qlu_zig_uniform(qlu_ziggurat_t* z){
+    return ((float)(qlu_zig_next(z) >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+static inline void qlu_zig_init(qlu_ziggurat_t* z, uint32_t seed){
+    const double m1 = 2147483648.0;
+    const double vn = 9.91256303526217e-3;
+    double dn = 3.442619855899, tn = dn;
+    double q  = vn / exp(-0.5 * dn * dn);
+
+    z->state = seed ? seed : 0x2545F491u;
+    z->kn[0] = (uint32_t)((dn / q) * m1);
+    z->kn[1] = 0;
+    z->wn[0] = (float)(q / m1);
+    z->wn[QLU_ZIG_LAYERS - 1] = (float)(dn / m1);
+    z->fn[0] = 1.0f;
+    z->fn[QLU_ZIG_LAYERS - 1] = (float)exp(-0.5 * dn * dn);
+
+    for (int i = QLU_ZIG_LAYERS - 2; i >= 1; i--) {
+        dn = sqrt(-2.0 * log(vn / dn + exp(-0.5 * dn * dn)));
+        z->kn[i + 1] = (uint32_t)((dn / tn) * m1);
+        tn = dn;
+        z->fn[i] = (float)exp(-0.5 * dn * dn);
+        z->wn[i] = (float)(dn / m1);
+    }
+}
+
+static inline uint32_t qlu_zig_abs(int32_t hz){
+    return (hz < 0) ? 0u - (uint32_t)hz : (uint32_t)hz;
+}
+
+// Wedges and tail, ~1.2% of draws
+static float qlu_zig_normal_slow(qlu_ziggurat_t* z, int32_t hz, uint32_t iz){
+    const float r = 3.442620f;
+
+    for (;;) {
+        float x = (float)hz * z->wn[iz];
+        if (iz == 0) {
+            float y;
+            do {
+                x = -logf(qlu_zig_uniform(z)) * (1.0f / r);
+                y = -logf(qlu_zig_uniform(z));
+            } while (y + y < x * x);
+            return (hz > 0) ? r + x : -r - x;
+        }
+        if (z->fn[iz] + qlu_zig_uniform(z) * (z->fn[iz - 1] - z->fn[iz]) < expf(-0.5f * x * x)) return x;
+
+        hz = (int32_t)qlu_zig_next(z);
+        iz = (uint32_t)hz & (QLU_ZIG_LAYERS - 1);
+        if (qlu_zig_abs(hz) < z->kn[iz]) return (float)hz * z->wn[iz];
+    }
+}
+
+// Standard normal
+static inline float qlu_zig_normal(qlu_ziggurat_t* z){
+    int32_t  hz = (int32_t)qlu_zig_next(z);
+    uint32_t iz = (uint32_t)hz & (QLU_ZIG_LAYERS - 1);
+    if (qlu_zig_abs(hz) < z->kn[iz]) return (float)hz * z->wn[iz];
+    return qlu_zig_normal_slow(z, hz, iz);
+}
+
+// ---- Setup ------------------------------------------------------------------
+
+static inline void qlu_impair_set(qlu_impair_t* imp, const qlu_impair_config_t* cfg){
+    const float two_pi = 6.283185307f;
+    float fs = (cfg->sample_rate_hz > 0.0f) ? cfg->sample_rate_hz : 1.0f;
+    float p  = (cfg->signal_power > 0.0f) ? cfg->signal_power : 1.0f;
+
+    imp->cfg        = *cfg;
+    imp->awgn_sigma = cfg->awgn ? sqrtf(p / powf(10.0f, cfg->snr_db / 10.0f) / 2.0f) : 0.0f;
+    imp->nco_step   = (uint32_t)(int32_t)lrint((double)cfg->cfo_hz / fs * 4294967296.0);
+    imp->pn_sigma   = (cfg->phase_noise_hz > 0.0f) ? sqrtf(two_pi * cfg->phase_noise_hz / fs) : 0.0f;
+    imp->clock_step = cfg->clock_ppm * 1e-6f;
+    imp->clock_slip = (float)((cfg->clock_slip == 0) ? 1 :
+                              (cfg->clock_slip > QLU_IMPAIR_MAX_SLIP) ? QLU_IMPAIR_MAX_SLIP : cfg->clock_slip);
+    if (imp->delay >= imp->clock_slip) imp->delay = 0.0f;
+
+    float alpha = powf(10.0f, cfg->iq_amp_db / 20.0f) - 1.0f;
+    float half  = cfg->iq_phase_deg * (3.14159265f / 180.0f) / 2.0f;
+    imp->skew_ii =  (1.0f + alpha) * cosf(half);
+    imp->skew_iq =  (1.0f + alpha) * sinf(half);
+    imp->skew_qi = -sinf(half);
+    imp->skew_qq =  cosf(half);
+
+    // A phase or delay left by earlier settings keeps applying
+    imp->rotate   = imp->nco_step != 0 || imp->pn_sigma != 0.0f || imp->nco != 0 || imp->pn_phase != 0.0f;
+    imp->skew     = cfg->iq_amp_db != 0.0f || cfg->iq_phase_deg != 0.0f;
+    imp->dc       = cfg->dc_i != 0.0f || cfg->dc_q != 0.0f;
+    imp->resample = imp->clock_step != 0.0f || imp->delay != 0.0f;
+}
+
+static inline void qlu_impair_init(qlu_impair_t* imp, const qlu_impair_config_t* cfg, uint32_t seed){
+    *imp = (qlu_impair_t){0};
+    qlu_zig_init(&imp->zig, seed);
+    qlu_impair_set(imp, cfg);
+}
+
+// False when every impairment is off and the samples would pass unchanged
+static inline bool qlu_impair_active(const qlu_impair_t* imp){
+    return imp->awgn_sigma != 0.0f || imp->rotate || imp->skew || imp->dc || imp->resample;
+}
+
+// ---- Kernels ------------------------------------------------------------------
+
+// sin and cos of θ in [-π, π], no branches: fold into [-π/2, π/2] with
+// cos sign flip, then odd/even Taylor to x^11 / x^12 (|err| < 1e-7)
+static inline void qlu_impair_sincos(float theta, float* s, float* c){
+    const float half_pi = 1.57079632679f, pi = 3.14159265359f;
+    float fold = (theta >  half_pi) ?  pi - theta :
+                 (theta < -half_pi) ? -pi - theta : theta;
+    float sign = (theta > half_pi || theta < -half_pi) ? -1.0f : 1.0f;
+    float x2 = fold * fold;
+
+    *s = fold * (1.0f + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880 + x2 * (-1.0f / 39916800))))));
+    *c = sign * (1.0f + x2 * (-0.5f + x2 * (1.0f / 24 + x2 * (-1.0f / 720 + x2 * (1.0f / 40320 + x2 * (-1.0f / 3628800 + x2 * (1.0f / 479001600)))))));
+}
+
+static inline float qlu_impair_wrap(float theta){
+    const float pi = 3.14159265359f, two_pi = 6.28318530718f;
+    if (theta >=  pi) theta -= two_pi;
+    if (theta <  -pi) theta += two_pi;
+    return theta;
+}
+
+static void qlu_impair_chunk(qlu_impair_t* imp, float* restrict i, float* restrict q, uint32_t n){
+    float a[QLU_IMPAIR_CHUNK], b[QLU_IMPAIR_CHUNK];
+
+    if (imp->rotate) {
+        // Phase track: scalar recursion, then a vector sincos + rotate pass
+        const float nco_rad = 1.4629180792671596e-9f;      // 2π / 2^32
+        uint32_t nco = imp->nco;
+        float    pn  = imp->pn_phase;
+        for (uint32_t k = 0; k < n; k++) {
+            nco += imp->nco_step;
+            if (imp->pn_sigma != 0.0f) pn = qlu_impair_wrap(pn + imp->pn_sigma * qlu_zig_normal(&imp->zig));
+            a[k] = qlu_impair_wrap((float)(int32_t)nco * nco_rad + pn);
+        }
+        imp->nco      = nco;
+        imp->pn_phase = pn;
+
+        for (uint32_t k = 0; k < n; k++) {
+            float s, c;
+            qlu_impair_sincos(a[k], &s, &c);
+            float x = i[k], y = q[k];
+            i[k] = x * c - y * s;
+            q[k] = x * s + y * c;
+        }
+    }
+
+    if (imp->awgn_sigma != 0.0f) {
+        for (uint32_t k = 0; k < n; k++) {
+            a[k] = qlu_zig_normal(&imp->zig);
+            b[k] = qlu_zig_normal(&imp->zig);
+        }
+        const float sigma = imp->awgn_sigma;
+        for (uint32_t k = 0; k < n; k++) {
+            i[k] += sigma * a[k];
+            q[k] += sigma * b[k];
+        }
+    }
+
+    if (imp->skew) {
+        const float ii = imp->skew_ii, iq = imp->skew_iq, qi = imp->skew_qi, qq = imp->skew_qq;
+        for (uint32_t k = 0; k < n; k++) {
+            float x = i[k], y = q[k];
+            i[k] = ii * x + iq * y;
+            q[k] = qi * x + qq * y;
+        }
+    }
+
+    if (imp->dc) {
+        const float di = imp->cfg.dc_i, dq = imp->cfg.dc_q;
+        for (uint32_t k = 0; k < n; k++) {
+            i[k] += di;
+            q[k] += dq;
+        }
+    }
+
+    // Delay line: always fed, so the clock can be switched on mid-stream
+    const uint32_t mask = QLU_IMPAIR_HIST - 1;
+    if (imp->resample) {
+        // y[k] = x at input position k - τ: between x[k - d] and x[k - d - 1]
+        float delay = imp->delay;
+        const float step = imp->clock_step, slip = imp->clock_slip;
+        uint32_t w = imp->hist_pos;
+        for (uint32_t k = 0; k < n; k++, w++) {
+            imp->hist_i[w & mask] = i[k];
+            imp->hist_q[w & mask] = q[k];
+
+            delay += step;
+            if (delay >= slip) delay -= slip;       // fast clock: skip `slip` inputs
+            if (delay <  0.0f) delay += slip;       // slow clock: repeat them
+
+            uint32_t d    = (uint32_t)delay;
+            float    frac = delay - (float)d;
+            uint32_t at   = (w - d) & mask, before = (w - d - 1) & mask;
+            i[k] = imp->hist_i[at] + frac * (imp->hist_i[before] - imp->hist_i[at]);
+            q[k] = imp->hist_q[at] + frac * (imp->hist_q[before] - imp->hist_q[at]);
+        }
+        imp->hist_pos = w;
+        imp->delay    = delay;
+    } else {
+        for (uint32_t k = (n > QLU_IMPAIR_HIST) ? n - QLU_IMPAIR_HIST : 0; k < n; k++) {
+            imp->hist_i[(imp->hist_pos + k) & mask] = i[k];
+            imp->hist_q[(imp->hist_pos + k) & mask] = q[k];
+        }
+        imp->hist_pos += n;
+    }
+}
+
+// Normalised float samples, in place
+static inline void qlu_impair_apply_f32(qlu_impair_t* imp, float* i, float* q, uint32_t n){
+    for (uint32_t done = 0; done < n; done += QLU_IMPAIR_CHUNK) {
+        uint32_t m = (n - done < QLU_IMPAIR_CHUNK) ? n - done : QLU_IMPAIR_CHUNK;
+        qlu_impair_chunk(imp, i + done, q + done, m);
+    }
+}
+
+// Offset-binary words (IqBlock_t layout) at cfg's resolution, in place
+static inline void qlu_impair_apply_u16(qlu_impair_t* imp, const demod_config_t* cfg,
+                                        uint16_t* i_raw, uint16_t* q_raw, uint32_t n){
+    float fi[QLU_IMPAIR_CHUNK], fq[QLU_IMPAIR_CHUNK];
+    const uint32_t max_uint = (1u << cfg->signal_resolution) - 1u;
+    const float max   = (float)max_uint;
+    const float mid   = (float)(max_uint / 2u);      // as uint16_to_signed()
+    const float scale = (float)config_get_scale_factor(cfg), inv = 1.0f / scale;
+
+    for (uint32_t done = 0; done < n; done += QLU_IMPAIR_CHUNK) {
+        uint32_t m = (n - done < QLU_IMPAIR_CHUNK) ? n - done : QLU_IMPAIR_CHUNK;
+        uint16_t* ri = i_raw + done;
+        uint16_t* rq = q_raw + done;
+
+        for (uint32_t k = 0; k < m; k++) {
+            fi[k] = ((float)ri[k] - mid) * inv;
+            fq[k] = ((float)rq[k] - mid) * inv;
+        }
+        qlu_impair_chunk(imp, fi, fq, m);
+        for (uint32_t k = 0; k < m; k++) {
+            float ci = mid + fi[k] * scale + 0.5f;
+            float cq = mid + fq[k] * scale + 0.5f;
+            ci = (ci < 0.0f) ? 0.0f : (ci > max) ? max : ci;
+            cq = (cq < 0.0f) ? 0.0f : (cq > max) ? max : cq;
+            ri[k] = (uint16_t)ci;
+            rq[k] = (uint16_t)cq;
+        }
+    }
+}
+
+// ---- Source decorator -----------------------------------------------------------
+
+// Any qlu_source_t with the impairments applied to what it reads
+typedef struct {
+    qlu_source_t        base;
+    qlu_source_t*       inner;
+    qlu_impair_t        imp;
+    demod_config_t      demod;
+} qlu_impaired_source_t;
+
+static uint32_t qlu_impaired_source_read(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    qlu_impaired_source_t* s = (qlu_impaired_source_t*)src;
+    uint32_t got = qlu_source_read(s->inner, i_out, q_out, n);
+    if (qlu_impair_active(&s->imp)) qlu_impair_apply_u16(&s->imp, &s->demod, i_out, q_out, got);
+    return got;
+}
+
+static void qlu_impaired_source_close(qlu_source_t* src){
+    qlu_source_close(((qlu_impaired_source_t*)src)->inner);
+}
+
+static const qlu_source_ops_t qlu_impaired_source_ops = {
+    .name  = "impaired",
+    .read  = qlu_impaired_source_read,
+    .close = qlu_impaired_source_close
+};
+
+static inline qlu_source_t* qlu_impaired_source_init(qlu_impaired_source_t* s, qlu_source_t* inner,
+                                                     const demod_config_t* demod, const qlu_impair_config_t* cfg,
+                                                     uint32_t seed){
+    s->base  = (qlu_source_t){ .ops = &qlu_impaired_source_ops };
+    s->inner = inner;
+    s->demod = *demod;
+    qlu_impair_init(&s->imp, cfg, seed);
+    return &s->base;
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef QLU_IQPACK_H
+
+#define QLU_IQPACK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qlu_sync.h"
+
+// ---------------------------------------------------------------------------
+// IQ PACKING — 16, packed 12 and 8-bit sample transport
+// ---------------------------------------------------------------------------
+//
+//   Wire layout per I/Q pair (format nibble of the v2 fmt byte):
+//
+//       IQ16_BE   4 bytes   I[15:8] I[7:0] Q[15:8] Q[7:0]
+//       IQ12      3 bytes   I[11:4] | I[3:0] Q[11:8] | Q[7:0]
+//       IQ8       2 bytes   I[7:0] Q[7:0]
+//
+//   Samples are offset binary. Unpacking always yields 16-bit offset-binary
+//   words by bit replication (v12 << 4 | v12 >> 8, v8 · 257), so full scale
+//   maps to full scale and the DSP keeps running at signal_resolution 16
+//   whatever the link carries. Packing keeps the top bits, so a 12/8-bit
+//   code survives pack -> unpack -> pack exactly.
+//
+//   One kernel per format, no per-sample branches; the format is resolved
+//   once per frame through iq_unpack_kernels[].
+
+typedef void (*iq_unpack_fn)(const uint8_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n_pairs);
+typedef void (*iq_pack_fn)(const uint16_t* i_in, const uint16_t* q_in, uint8_t* dst, uint32_t n_pairs);
+
+static inline bool iq_format_supported(uint8_t fmt){
+    return SYNC_FMT_FORMAT(fmt) < SYNC_FMT_COUNT;
+}
+
+static inline uint32_t iq_pair_bytes(sync_sample_format_t format){
+    static const uint8_t pair_bytes[SYNC_FMT_COUNT] = {
+        [SYNC_FMT_IQ16_BE] = 4,
+        [SYNC_FMT_IQ12]    = 3,
+        [SYNC_FMT_IQ8]     = 2
+    };
+    return pair_bytes[format];
+}
+
+static inline uint32_t iq_payload_bytes(sync_sample_format_t format, uint32_t n_pairs){
+    return iq_pair_bytes(format) * n_pairs;
+}
+
+// Wire fmt byte for a format at its full container width
+static inline uint8_t iq_format_byte(sync_sample_format_t format){
+    static const uint8_t bits[SYNC_FMT_COUNT] = {
+        [SYNC_FMT_IQ16_BE] = 16,
+        [SYNC_FMT_IQ12]    = 12,
+        [SYNC_FMT_IQ8]     = 8
+    };
+    return SYNC_FMT_BYTE(format, bits[format]);
+}
+
+// ---- Unpack ---------------------------------------------------------------
+
+static inline void iq_unpack_16be(const uint8_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n_pairs){
+    for (uint32_t k = 0; k < n_pairs; k++, src += 4) {
+        i_out[k] = (uint16_t)((src[0] << 8) | src[1]);
+        q_out[k] = (uint16_t)((src[2] << 8) | src[3]);
+    }
+}
+
+static inline void iq_unpack_12(const uint8_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n_pairs){
+    for (uint32_t k = 0; k < n_pairs; k++, src += 3) {
+        uint32_t i12 = ((uint32_t)src[0] << 4) | (src[1] >> 4);
+        uint32_t q12 = ((uint32_t)(src[1] & 0x0F) << 8) | src[2];
+        i_out[k] = (uint16_t)((i12 << 4) | (i12 >> 8));
+        q_out[k] = (uint16_t)((q12 << 4) | (q12 >> 8));
+    }
+}
+
+static inline void iq_unpack_8(const uint8_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n_pairs){
+    for (uint32_t k = 0; k < n_pairs; k++, src += 2) {
+        i_out[k] = (uint16_t)(src[0] * 257u);
+        q_out[k] = (uint16_t)(src[1] * 257u);
+    }
+}
+
+static const iq_unpack_fn iq_unpack_kernels[SYNC_FMT_COUNT] = {
+    [SYNC_FMT_IQ16_BE] = iq_unpack_16be,
+    [SYNC_FMT_IQ12]    = iq_unpack_12,
+    [SYNC_FMT_IQ8]     = iq_unpack_8
+};
+
+// ---- Pack (host tools; sdr_simulator.ino carries the same code) ------------
+
+static inline void iq_pack_16be(const uint16_t* i_in, const uint16_t* q_in, uint8_t* dst, uint32_t n_pairs){
+    for (uint32_t k = 0; k < n_pairs; k++, dst += 4) {
+        dst[0] = (uint8_t)(i_in[k] >> 8);
+        dst[1] = (uint8_t)i_in[k];
+        dst[2] = (uint8_t)(q_in[k] >> 8);
+        dst[3] = (uint8_t)q_in[k];
+    }
+}
+
+static inline void iq_pack_12(const uint16_t* i_in, const uint16_t* q_in, uint8_t* dst, uint32_t n_pairs){
+    for (uint32_t k = 0; k < n_pairs; k++, dst += 3) {
+        uint32_t i12 = i_in[k] >> 4;
+        uint32_t q12 = q_in[k] >> 4;
+        dst[0] = (uint8_t)(i12 >> 4);
+        dst[1] = (uint8_t)(((i12 & 0x0F) << 4) | (q12 >> 8));
+        dst[2] = (uint8_t)q12;
+    }
+}
+
+static inline void iq_pack_8(const uint16_t* i_in, const uint16_t* q_in, uint8_t* dst, uint32_t n_pairs){
+    for (uint32_t k = 0; k < n_pairs; k++, dst += 2) {
+        dst[0] = (uint8_t)(i_in[k] >> 8);
+        dst[1] = (uint8_t)(q_in[k] >> 8);
+    }
+}
+
+static const iq_pack_fn iq_pack_kernels[SYNC_FMT_COUNT] = {
+    [SYNC_FMT_IQ16_BE] = iq_pack_16be,
+    [SYNC_FMT_IQ12]    = iq_pack_12,
+    [SYNC_FMT_IQ8]     = iq_pack_8
+};
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef QLU_LOCK_H
+
+#define QLU_LOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+// ---------------------------------------------------------------------------
+// LOCK DETECTOR — gates metric accumulation per block
+// ---------------------------------------------------------------------------
+//
+//   A strided probe of LOCK_PROBE_SAMPLES samples is checked for consistency
+//   with the configured modulation rather than against an MER floor, so a
+//   weak link of the right modulation still locks and reports its poor MER:
+//
+//     - signal present: per-axis kurtosis E[x⁴]/E[x²]² below
+//       LOCK_NOISE_KURTOSIS. Noise is 3, QPSK 1 and 16QAM 1.64 noise free;
+//       128 samples of pure noise stay above 2.23 (1 %), QPSK and 16QAM
+//       below it down to ~5 dB
+//     - one or two axes: Q/I energy below LOCK_BPSK_MAX_Q_TO_I for BPSK and
+//       above it for QPSK and 16QAM
+//     - constellation order: gain of the 16QAM slicer over the QPSK slicer.
+//       A denser grid always fits better, by 4..5.5 dB on noise or on QPSK
+//       at low SNR, and by less as QPSK gets cleaner; 16QAM gains 4.2 dB at
+//       1 dB SNR and more above. 16QAM needs >= LOCK_QAM16_MIN_GAIN_DB,
+//       QPSK <= LOCK_QPSK_MAX_GAIN_DB
+//
+//   QPSK is told from 16QAM above ~9 dB SNR and 16QAM from QPSK above
+//   ~13 dB; below that the order is ambiguous from one block either way.
+//   Hysteresis: LOCK_ACQUIRE_BLOCKS good blocks in a row to lock,
+//   LOCK_RELEASE_BLOCKS bad blocks in a row to drop it.
+
+#define LOCK_PROBE_SAMPLES      128
+#define LOCK_ACQUIRE_BLOCKS     3
+#define LOCK_RELEASE_BLOCKS     4
+
+#define LOCK_NOISE_KURTOSIS     2.3
+#define LOCK_BPSK_MAX_Q_TO_I    0.5
+#define LOCK_QAM16_MIN_GAIN_DB  4.0
+#define LOCK_QPSK_MAX_GAIN_DB   6.0
+
+typedef enum {
+    LOCK_EVT_NONE,
+    LOCK_EVT_ACQUIRED,
+    LOCK_EVT_LOST
+} lock_event_t;
+
+typedef struct {
+    bool     locked;
+    uint8_t  good_run;
+    uint8_t  bad_run;
+    modulation_type_t modulation;
+    // Last probe: MER with the configured slicer and the consistency stats
+    double   last_probe_mer_db;
+    double   last_kurtosis;
+    double   last_q_to_i;
+    double   last_qam16_gain_db;
+
+    uint32_t search_start_ms;
+    uint32_t time_to_lock_ms;
+    uint32_t locked_blocks;
+    uint32_t skipped_blocks;
+} lock_detector_t;
+
+// Drops lock and restarts the time-to-lock measurement
+static inline void lock_detector_reset(lock_detector_t* det, modulation_type_t mod, uint32_t now_ms){
+    det->locked             = false;
+    det->good_run           = 0;
+    det->bad_run            = 0;
+    det->modulation         = mod;
+    det->last_probe_mer_db  = 0.0;
+    det->last_kurtosis      = 0.0;
+    det->last_q_to_i        = 0.0;
+    det->last_qam16_gain_db = 0.0;
+    det->search_start_ms    = now_ms;
+    det->time_to_lock_ms    = 0;
+    det->locked_blocks      = 0;
+    det->skipped_blocks     = 0;
+}
+
+static inline double lock_ratio_db(double sig, double err){
+    return (err > 1e-12) ? 10.0 * log10(sig / err) : 60.0;
+}
+
+// Consistency probe over LOCK_PROBE_SAMPLES evenly spaced samples
+static inline bool lock_probe_block(lock_detector_t* det, const IqBlock_t* block, const demod_t* demod){
+    const uint32_t stride = PROCESS_BLOCK_SIZE / LOCK_PROBE_SAMPLES;
+    double i2 = 0.0, i4 = 0.0, q2 = 0.0, q4 = 0.0;
+    double sig_bpsk = 0.0, err_bpsk = 0.0;
+    double sig_qpsk = 0.0, err_qpsk = 0.0;
+    double sig_qam  = 0.0, err_qam  = 0.0;
+
+    for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k += stride) {
+        double fi = (double)uint16_to_signed(block->i_samples[k], demod->config.signal_resolution) / demod->scale;
+        double fq = (double)uint16_to_signed(block->q_samples[k], demod->config.signal_resolution) / demod->scale;
+        double pi = fi * fi, pq = fq * fq;
+        i2 += pi; i4 += pi * pi;
+        q2 += pq; q4 += pq * pq;
+
+        SlicerResult r = qpsk_slicer(fi, fq);
+        sig_qpsk += slicer_calculate_power(r.ideal_i, r.ideal_q);
+        err_qpsk += slicer_calculate_power(fi - r.ideal_i, fq - r.ideal_q);
+        r = qam16_slicer(fi, fq);
+        sig_qam  += slicer_calculate_power(r.ideal_i, r.ideal_q);
+        err_qam  += slicer_calculate_power(fi - r.ideal_i, fq - r.ideal_q);
+        if (det->modulation == MOD_BPSK) {
+            r = bpsk_slicer(fi, fq);
+            sig_bpsk += slicer_calculate_power(r.ideal_i, r.ideal_q);
+            err_bpsk += slicer_calculate_power(fi - r.ideal_i, fq - r.ideal_q);
+        }
+    }
+
+    double mer_qpsk = lock_ratio_db(sig_qpsk, err_qpsk);
+    double mer_qam  = lock_ratio_db(sig_qam, err_qam);
+    det->last_q_to_i        = (i2 > 1e-12) ? q2 / i2 : 0.0;
+    det->last_qam16_gain_db = mer_qam - mer_qpsk;
+
+    switch (det->modulation) {
+        case MOD_BPSK:
+            det->last_probe_mer_db = lock_ratio_db(sig_bpsk, err_bpsk);
+            det->last_kurtosis     = (i2 > 1e-12) ? i4 * LOCK_PROBE_SAMPLES / (i2 * i2) : 0.0;
+            if (i2 <= 1e-12 || det->last_kurtosis > LOCK_NOISE_KURTOSIS) return false;
+            return det->last_q_to_i < LOCK_BPSK_MAX_Q_TO_I;
+        case MOD_QPSK:
+        case MOD_16QAM: {
+            bool qam = (det->modulation == MOD_16QAM);
+            det->last_probe_mer_db = qam ? mer_qam : mer_qpsk;
+            det->last_kurtosis     = (i2 > 1e-12 && q2 > 1e-12)
+                                   ? 0.5 * LOCK_PROBE_SAMPLES * (i4 / (i2 * i2) + q4 / (q2 * q2)) : 0.0;
+            if (det->last_q_to_i < LOCK_BPSK_MAX_Q_TO_I || det->last_kurtosis > LOCK_NOISE_KURTOSIS) return false;
+            return qam ? det->last_qam16_gain_db >= LOCK_QAM16_MIN_GAIN_DB
+                       : det->last_qam16_gain_db <= LOCK_QPSK_MAX_GAIN_DB;
+        }
+        default:
+            return false;
+    }
+}
+
+static inline lock_event_t lock_detector_update(lock_detector_t* det, bool good, uint32_t now_ms){
+    lock_event_t evt = LOCK_EVT_NONE;
+
+    if (good) {
+        det->bad_run = 0;
+        if (det->good_run < LOCK_ACQUIRE_BLOCKS) det->good_run++;
+        if (!det->locked && det->good_run >= LOCK_ACQUIRE_BLOCKS) {
+            det->locked          = true;
+            det->time_to_lock_ms = now_ms - det->search_start_ms;
+            evt = LOCK_EVT_ACQUIRED;
+        }
+    } else {
+        det->good_run = 0;
+        if (det->bad_run < LOCK_RELEASE_BLOCKS) det->bad_run++;
+        if (det->locked && det->bad_run >= LOCK_RELEASE_BLOCKS) {
+            det->locked          = false;
+            det->search_start_ms = now_ms;
+            evt = LOCK_EVT_LOST;
+        }
+    }
+
+    if (det->locked) det->locked_blocks++;
+    else             det->skipped_blocks++;
+
+    return evt;
+}
+
+#endif
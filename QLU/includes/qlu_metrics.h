@@ -0,0 +1,307 @@
+#ifndef QLU_METRICS_H
+
+#define QLU_METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "qlu_base.h"
+#include "qlu_compression.h"
+
+// ---------------------------------------------------------------------------
+// METRICS ENGINE — per-block MER/SNR/EVM/C/N0, stability, skew and SQI
+// ---------------------------------------------------------------------------
+//
+//   The DSP task pipeline, split in stages so each can be timed on the host
+//   (c_sim `make bench`). Needs qlu_demod.h (and PROCESS_BLOCK_SIZE) first.
+//
+//   Per sample:
+//       1. convert   offset binary -> centred -> / scale
+//       2. slice     nearest constellation point, sample signal/error power
+//       3. skew      error vector I², Q², I·Q sums (isotropic under AWGN)
+//       4. symbol    integrate-and-dump over sps_ceil, symbol slicer
+//   Per block (finalize):
+//       instantaneous metrics + EMA every block (MER and C/N0 from the symbol
+//       decisions, SNR and EVM from the samples), stability CV and MER/EVM
+//       window every METRICS_RESET_EVERY_N_BLOCKS, skew and compression every
+//       METRICS_SKEW_EVERY_N_BLOCKS with decayed accumulators, then SQI.
+
+#define METRICS_EMA_ALPHA             0.1
+#define METRICS_RESET_EVERY_N_BLOCKS  5
+#define METRICS_SKEW_EVERY_N_BLOCKS   20     // skew needs more samples for stability
+#define METRICS_SKEW_DECAY            0.3    // keep 30% of the old skew accumulation
+#define METRICS_STABILITY_WINDOW_CNT  16
+#define METRICS_STABILITY_CV_CEILING  0.30
+
+typedef struct {
+    // Cached from the demod config (metrics_engine_configure)
+    slicer_fn_t slicer;
+    uint32_t    sps_ceil;
+    bool        track_compression;
+    double      cn0_offset_db;    // 10·log10(symbol rate the integrator runs at)
+
+    // IQ imbalance accumulators (for skew measurement)
+    double   sum_I_sq;
+    double   sum_Q_sq;
+    double   sum_IQ;
+    uint32_t iq_imb_count;
+
+    // Stability: ring buffer of block powers to compute CV
+    double   power_history[METRICS_STABILITY_WINDOW_CNT];
+    uint32_t power_hist_idx;
+    uint32_t power_hist_filled;
+    double   block_rx_power_sum;
+
+    // AM/AM, AM/PM per 16QAM ring (same window as skew)
+    compression_detector_t comp;
+
+    uint32_t blocks_since_reset;
+    uint32_t skew_blocks;
+    bool     first_run;
+
+    double smooth_snr;
+    double smooth_mer;
+    double smooth_evm;
+    double smooth_cn0;
+    double smooth_stability;
+    double smooth_skew;
+    double smooth_sqi;
+
+    // Latest outputs
+    QLUMetrics out;
+    double     compression_db;
+    double     ampm_deg;
+} metrics_engine_t;
+
+// Symbols per second out of the integrate-and-dump: sps is rounded up, so
+// this is below config.symbol_rate_hz whenever rate / symbol rate is not whole
+static inline double metrics_symbol_rate_hz(const demod_config_t* cfg){
+    return config_output_rate_hz(cfg) / ceil(cfg->samples_per_symbol);
+}
+
+// Picks up modulation and samples per symbol; call again on config change
+static inline void metrics_engine_configure(metrics_engine_t* m, const demod_t* d){
+    m->slicer            = get_slicer_by_mod[d->config.modulation];
+    m->sps_ceil          = (uint32_t)ceil(d->config.samples_per_symbol);
+    m->track_compression = (d->config.modulation == MOD_16QAM);
+    m->cn0_offset_db     = 10.0 * log10(metrics_symbol_rate_hz(&d->config));
+}
+
+// Full reset — purge all stale data (new modulation or lock reacquired).
+// The smoothed values are kept and re-seeded by the next finalize.
+static inline void metrics_engine_reset(metrics_engine_t* m){
+    m->sum_I_sq           = 0.0;
+    m->sum_Q_sq           = 0.0;
+    m->sum_IQ             = 0.0;
+    m->iq_imb_count       = 0;
+    m->block_rx_power_sum = 0.0;
+    m->power_hist_filled  = 0;
+    m->power_hist_idx     = 0;
+    m->blocks_since_reset = 0;
+    m->skew_blocks        = 0;
+    compression_reset(&m->comp);
+    m->compression_db     = 0.0;
+    m->ampm_deg           = 0.0;
+    m->smooth_skew        = 100.0;  // reset sentinel for EMA seed
+    m->first_run          = true;
+}
+
+static inline void metrics_engine_init(metrics_engine_t* m, const demod_t* d){
+    *m = (metrics_engine_t){0};
+    m->smooth_stability = 100.0;
+    metrics_engine_configure(m, d);
+    metrics_engine_reset(m);
+}
+
+// ---- Per-sample stages ------------------------------------------------------
+
+static inline void metrics_convert(const demod_t* d, uint16_t raw_i, uint16_t raw_q, double* fi, double* fq){
+    *fi = (double)uint16_to_signed(raw_i, d->config.signal_resolution) / d->scale;
+    *fq = (double)uint16_to_signed(raw_q, d->config.signal_resolution) / d->scale;
+}
+
+// Received power for stability (before slicer, cheap) and sample MER/SNR
+static inline SlicerResult metrics_slice_sample(metrics_engine_t* m, demod_t* d, double fi, double fq){
+    m->block_rx_power_sum += fi * fi + fq * fq;
+
+    SlicerResult r = m->slicer(fi, fq);
+    d->sum_sample_signal_power += slicer_calculate_power(r.ideal_i, r.ideal_q);
+    d->sum_sample_error_power  += slicer_calculate_power(fi - r.ideal_i, fq - r.ideal_q);
+    d->sample_count++;
+    return r;
+}
+
+// Error vectors instead of the raw signal: raw I² >> Q² for BPSK even without
+// skew, but error I² ≈ error Q² (AWGN is isotropic)
+static inline void metrics_skew_sample(metrics_engine_t* m, double fi, double fq, SlicerResult r){
+    double ei = fi - r.ideal_i;
+    double eq = fq - r.ideal_q;
+    m->sum_I_sq += ei * ei;
+    m->sum_Q_sq += eq * eq;
+    m->sum_IQ   += ei * eq;
+    m->iq_imb_count++;
+}
+
+static inline void metrics_symbol_sample(metrics_engine_t* m, demod_t* d, double fi, double fq){
+    d->sym.acc_i += fi;
+    d->sym.acc_q += fq;
+    d->sym.count++;
+
+    if (d->sym.count >= m->sps_ceil) {
+        double rx_i = d->sym.acc_i / (double)d->sym.count;
+        double rx_q = d->sym.acc_q / (double)d->sym.count;
+        SlicerResult r = m->slicer(rx_i, rx_q);
+
+        d->sum_symbol_signal_power += slicer_calculate_power(r.ideal_i, r.ideal_q);
+        d->sum_symbol_error_power  += slicer_calculate_power(rx_i - r.ideal_i, rx_q - r.ideal_q);
+        d->symbol_count++;
+
+        if (m->track_compression) {
+            compression_accumulate(&m->comp, rx_i, rx_q, r);
+        }
+
+        d->sym.acc_i = 0.0;
+        d->sym.acc_q = 0.0;
+        d->sym.count = 0;
+    }
+}
+
+// All per-sample stages over one block, fused in a single pass
+static inline void metrics_engine_process_block(metrics_engine_t* m, demod_t* d,
+                                                const uint16_t* i_samples, const uint16_t* q_samples, uint32_t n){
+    double fi, fq;
+    for (uint32_t k = 0; k < n; k++) {
+        metrics_convert(d, i_samples[k], q_samples[k], &fi, &fq);
+        SlicerResult r = metrics_slice_sample(m, d, fi, fq);
+        metrics_skew_sample(m, fi, fq, r);
+        metrics_symbol_sample(m, d, fi, fq);
+    }
+}
+
+// ---- Per-block finalize -----------------------------------------------------
+
+// Closes a block of `n` samples and refreshes m->out
+static inline void metrics_engine_finalize_block(metrics_engine_t* m, demod_t* d, uint32_t n){
+    double avg_sym_sig_power = (d->symbol_count > 0) ? (d->sum_symbol_signal_power / d->symbol_count) : 0.0;
+    double avg_sym_err_power = (d->symbol_count > 0) ? (d->sum_symbol_error_power / d->symbol_count) : 0.0;
+    double avg_smp_sig       = (d->sample_count > 0) ? (d->sum_sample_signal_power / d->sample_count) : 0.0;
+    double avg_smp_err       = (d->sample_count > 0) ? (d->sum_sample_error_power / d->sample_count) : 0.0;
+    double inst_mer, inst_evm, inst_snr, inst_cn0;
+
+    // 1. Instantaneous metrics
+    if (avg_sym_err_power > 0.000001 && avg_sym_sig_power > 0.000001) {
+        inst_mer = 10.0 * log10(avg_sym_sig_power / avg_sym_err_power);
+        inst_evm = sqrt(avg_smp_err / avg_smp_sig) * 100.0;
+    } else {
+        inst_mer = 0.0;
+        inst_evm = 0.0;
+    }
+
+    if (avg_smp_err > 0.000001) {
+        inst_snr = 10.0 * log10(avg_smp_sig / avg_smp_err);
+    } else {
+        inst_snr = 0.0;
+    }
+
+    // C/N0 = Es/N0 · Rs, as modulations/metrics.py:calculate_cn0
+    inst_cn0 = inst_mer + m->cn0_offset_db;
+
+    // 2. Stability: store block power (cheap — just an array write)
+    m->power_history[m->power_hist_idx] = m->block_rx_power_sum / n;
+    m->power_hist_idx = (m->power_hist_idx + 1) % METRICS_STABILITY_WINDOW_CNT;
+    if (m->power_hist_filled < METRICS_STABILITY_WINDOW_CNT) m->power_hist_filled++;
+    m->block_rx_power_sum = 0.0;
+
+    // 3. EMA for MER/EVM/SNR/CN0 every block
+    if (m->first_run) {
+        m->smooth_mer = inst_mer;
+        m->smooth_snr = inst_snr;
+        m->smooth_evm = inst_evm;
+        m->smooth_cn0 = inst_cn0;
+        m->first_run  = false;
+    } else {
+        m->smooth_mer = (METRICS_EMA_ALPHA * inst_mer) + ((1.0 - METRICS_EMA_ALPHA) * m->smooth_mer);
+        m->smooth_snr = (METRICS_EMA_ALPHA * inst_snr) + ((1.0 - METRICS_EMA_ALPHA) * m->smooth_snr);
+        m->smooth_evm = (METRICS_EMA_ALPHA * inst_evm) + ((1.0 - METRICS_EMA_ALPHA) * m->smooth_evm);
+        m->smooth_cn0 = (METRICS_EMA_ALPHA * inst_cn0) + ((1.0 - METRICS_EMA_ALPHA) * m->smooth_cn0);
+    }
+
+    // 4. Stability CV and the MER/EVM window, every N blocks
+    if (++m->blocks_since_reset >= METRICS_RESET_EVERY_N_BLOCKS) {
+        if (m->power_hist_filled >= 2) {
+            double sum_p = 0.0, sum_p2 = 0.0;
+            for (uint32_t w = 0; w < m->power_hist_filled; w++) {
+                sum_p  += m->power_history[w];
+                sum_p2 += m->power_history[w] * m->power_history[w];
+            }
+            double mean_p = sum_p / m->power_hist_filled;
+            double var_p  = (sum_p2 / m->power_hist_filled) - (mean_p * mean_p);
+            if (var_p < 0.0) var_p = 0.0;
+            double cv = sqrt(var_p) / (mean_p + 1e-12);
+            m->smooth_stability = (1.0 - cv / METRICS_STABILITY_CV_CEILING) * 100.0;
+            if (m->smooth_stability < 0.0)   m->smooth_stability = 0.0;
+            if (m->smooth_stability > 100.0) m->smooth_stability = 100.0;
+        }
+
+        // Reset MER/EVM accumulators (short window), the running symbol keeps
+        d->sum_symbol_signal_power = 0.0;
+        d->sum_symbol_error_power  = 0.0;
+        d->symbol_count            = 0;
+        d->sum_sample_signal_power = 0.0;
+        d->sum_sample_error_power  = 0.0;
+        d->sample_count            = 0;
+        m->blocks_since_reset      = 0;
+    }
+
+    // 5. Skew — longer accumulation window, decayed instead of cleared
+    if (++m->skew_blocks >= METRICS_SKEW_EVERY_N_BLOCKS && m->iq_imb_count > 0) {
+        double pwr_I = m->sum_I_sq / m->iq_imb_count;
+        double pwr_Q = m->sum_Q_sq / m->iq_imb_count;
+        double cross = m->sum_IQ   / m->iq_imb_count;
+
+        double amp_imb_db = 10.0 * log10((pwr_I + 1e-12) / (pwr_Q + 1e-12));
+        double arg = 2.0 * cross / (sqrt(pwr_I * pwr_Q) + 1e-12);
+        if (arg >  1.0) arg =  1.0;
+        if (arg < -1.0) arg = -1.0;
+        double phase_imb_deg = asin(arg) * (180.0 / M_PI);
+        double inst_skew = calculate_skew_score(amp_imb_db, phase_imb_deg);
+
+        if (m->smooth_skew >= 99.9) {
+            m->smooth_skew = inst_skew;  // first measurement
+        } else {
+            m->smooth_skew = (METRICS_EMA_ALPHA * inst_skew) + ((1.0 - METRICS_EMA_ALPHA) * m->smooth_skew);
+        }
+
+        m->sum_I_sq     *= METRICS_SKEW_DECAY;
+        m->sum_Q_sq     *= METRICS_SKEW_DECAY;
+        m->sum_IQ       *= METRICS_SKEW_DECAY;
+        m->iq_imb_count  = (uint32_t)(m->iq_imb_count * METRICS_SKEW_DECAY);
+        m->skew_blocks   = 0;
+
+        // Compression rides on the same long window
+        if (m->track_compression) {
+            compression_report_t comp = compression_finalize(&m->comp);
+            if (comp.valid) {
+                m->compression_db = comp.compression_db;
+                m->ampm_deg       = comp.ampm_deg;
+            }
+            compression_decay(&m->comp, METRICS_SKEW_DECAY);
+        }
+    }
+
+    // 6. SQI from the latest smoothed values
+    m->smooth_sqi = calculate_sqi(normalize_mer(m->smooth_mer, d->config.modulation),
+                                  normalize_cn0(m->smooth_cn0),
+                                  m->smooth_skew, m->smooth_stability);
+
+    m->out.snr        = m->smooth_snr;
+    m->out.mer        = m->smooth_mer;
+    m->out.evm        = m->smooth_evm;
+    m->out.cn0        = m->smooth_cn0;
+    m->out.stability  = m->smooth_stability;
+    m->out.skew_score = m->smooth_skew;
+    m->out.sqi        = m->smooth_sqi;
+}
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef QLU_MULTICHANNEL_H
+
+#define QLU_MULTICHANNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "qlu_channelizer.h"
+
+// ---------------------------------------------------------------------------
+// MULTI-CARRIER ENGINE — N demod_t channels fed from one IqBlock_t pass
+// ---------------------------------------------------------------------------
+//
+//   Each input sample is converted once and then, per channel:
+//       1. mixed down by an integer NCO (Q15 sine LUT, 32-bit phase)
+//       2. integrated-and-dumped by `decimation`
+//   Only the decimated sample reaches the symbol accumulator/slicer, so the
+//   per-input-sample cost of a channel is the mix + accumulate.
+//
+//   Alternatively the channels can be fed from a polyphase channelizer
+//   (qlu_channelizer.h): each channel is bound to the sub-band nearest to its
+//   offset and only runs the slicer at fs/M, the mix/filter work is shared.
+//
+//   Metrics (MER/SNR/EVM, same definitions as the main DSP task) are closed
+//   every MC_WINDOW_BLOCKS and smoothed with MC_EMA_ALPHA.
+
+#define MC_MAX_CHANNELS   4
+#define MC_NCO_LUT_BITS   8
+#define MC_NCO_LUT_SIZE   (1u << MC_NCO_LUT_BITS)
+#define MC_NCO_QUARTER    (MC_NCO_LUT_SIZE / 4)
+#define MC_WINDOW_BLOCKS  5
+#define MC_EMA_ALPHA      0.1
+
+typedef struct {
+    // Carrier centre relative to the capture centre (Hz)
+    double   offset_hz;
+    // Integrate-and-dump factor applied after the mix (>= 1)
+    uint16_t decimation;
+    double   link_bw_hz;
+    double   roll_off;
+    modulation_type_t modulation;
+    // Carrier amplitude relative to the ADC scale the slicer expects, for
+    // carriers sharing the range (0 = 1.0, the carrier alone at full scale)
+    double   level;
+} mc_channel_config_t;
+
+typedef struct {
+    double   mer;
+    double   snr;
+    double   evm;
+    uint64_t symbols;
+    bool     valid;
+} mc_channel_metrics_t;
+
+typedef struct {
+    mc_channel_config_t cfg;
+    demod_t  demod;            // runs at sampling_rate / decimation
+    uint32_t sps_ceil;
+    slicer_fn_t slicer;
+
+    uint32_t nco_phase;
+    uint32_t nco_step;
+
+    int32_t  dec_acc_i;
+    int32_t  dec_acc_q;
+    uint16_t dec_count;
+    double   dec_norm;         // 1 / (decimation · scale · level)
+    uint8_t  subband;          // channelizer output index (PFB mode)
+
+    mc_channel_metrics_t metrics;
+} mc_channel_t;
+
+typedef struct {
+    mc_channel_t ch[MC_MAX_CHANNELS];
+    uint8_t  n_channels;
+    uint8_t  resolution;
+    uint32_t blocks;
+} mc_engine_t;
+
+static int16_t mc_sin_lut[MC_NCO_LUT_SIZE];
+
+static inline void mc_build_lut(void){
+    for (uint32_t k = 0; k < MC_NCO_LUT_SIZE; k++) {
+        mc_sin_lut[k] = (int16_t)lrint(32767.0 * sin(2.0 * M_PI * (double)k / MC_NCO_LUT_SIZE));
+    }
+}
+
+// Channels share the ADC rate/resolution of `base`; each one gets its own
+// offset, decimation, bandwidth and modulation.
+static inline void mc_engine_init(mc_engine_t* mc, const demod_config_t* base,
+                                  const mc_channel_config_t* channels, uint8_t n_channels){
+    mc_build_lut();
+
+    if (n_channels > MC_MAX_CHANNELS) n_channels = MC_MAX_CHANNELS;
+    mc->n_channels = n_channels;
+    mc->resolution = base->signal_resolution;
+    mc->blocks     = 0;
+
+    for (uint8_t c = 0; c < n_channels; c++) {
+        mc_channel_t* ch = &mc->ch[c];
+        ch->cfg = channels[c];
+        if (ch->cfg.decimation < 1) ch->cfg.decimation = 1;
+        if (ch->cfg.level <= 0.0)   ch->cfg.level      = 1.0;
+
+        demod_config_t cfg = *base;
+        cfg.sampling_rate_hz = base->sampling_rate_hz / ch->cfg.decimation;
+        cfg.decimation       = 1;
+        cfg.link_bw_hz       = ch->cfg.link_bw_hz;
+        cfg.roll_off         = ch->cfg.roll_off;
+        cfg.modulation       = ch->cfg.modulation;
+        config_calculate_derived(&cfg);
+        demod_init(&ch->demod, cfg);
+
+        ch->sps_ceil  = (uint32_t)ceil(cfg.samples_per_symbol);
+        ch->slicer    = get_slicer_by_mod[cfg.modulation];
+        ch->nco_phase = 0;
+        // Mixing by e^{-jωn} shifts +offset down to DC
+        ch->nco_step  = (uint32_t)(int64_t)llrint(ch->cfg.offset_hz / base->sampling_rate_hz * 4294967296.0);
+        ch->dec_acc_i = 0;
+        ch->dec_acc_q = 0;
+        ch->dec_count = 0;
+        ch->dec_norm  = 1.0 / ((double)ch->cfg.decimation * ch->demod.scale * ch->cfg.level);
+        ch->subband   = 0;
+        ch->metrics   = (mc_channel_metrics_t){0};
+    }
+}
+
+// One decimated sample into the channel's sample/symbol accumulators
+static inline void mc_channel_push(mc_channel_t* ch, double fi, double fq){
+    demod_t* d = &ch->demod;
+    SlicerResult r = ch->slicer(fi, fq);
+    d->sum_sample_signal_power += slicer_calculate_power(r.ideal_i, r.ideal_q);
+    d->sum_sample_error_power  += slicer_calculate_power(fi - r.ideal_i, fq - r.ideal_q);
+    d->sample_count++;
+
+    d->sym.acc_i += fi;
+    d->sym.acc_q += fq;
+    if (++d->sym.count >= ch->sps_ceil) {
+        double rx_i = d->sym.acc_i / (double)d->sym.count;
+        double rx_q = d->sym.acc_q / (double)d->sym.count;
+        r = ch->slicer(rx_i, rx_q);
+        d->sum_symbol_signal_power += slicer_calculate_power(r.ideal_i, r.ideal_q);
+        d->sum_symbol_error_power  += slicer_calculate_power(rx_i - r.ideal_i, rx_q - r.ideal_q);
+        d->symbol_count++;
+        d->sym = (symbol_acc_t){0, 0, 0};
+    }
+}
+
+static inline void mc_engine_process_block(mc_engine_t* mc, const IqBlock_t* block){
+    const uint8_t n = mc->n_channels;
+
+    for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++) {
+        // Loaded and centred once, shared by every channel
+        int32_t xi = uint16_to_signed(block->i_samples[k], mc->resolution);
+        int32_t xq = uint16_to_signed(block->q_samples[k], mc->resolution);
+
+        for (uint8_t c = 0; c < n; c++) {
+            mc_channel_t* ch = &mc->ch[c];
+            uint32_t idx = ch->nco_phase >> (32 - MC_NCO_LUT_BITS);
+            int32_t  s   = mc_sin_lut[idx];
+            int32_t  co  = mc_sin_lut[(idx + MC_NCO_QUARTER) & (MC_NCO_LUT_SIZE - 1)];
+            ch->nco_phase += ch->nco_step;
+
+            // (xi + j·xq)(co - j·s), Q15
+            ch->dec_acc_i += (xi * co + xq * s) >> 15;
+            ch->dec_acc_q += (xq * co - xi * s) >> 15;
+
+            if (++ch->dec_count == ch->cfg.decimation) {
+                mc_channel_push(ch, ch->dec_acc_i * ch->dec_norm, ch->dec_acc_q * ch->dec_norm);
+                ch->dec_acc_i = 0;
+                ch->dec_acc_q = 0;
+                ch->dec_count = 0;
+            }
+        }
+    }
+}
+
+// PFB mode: channels must have been initialised with decimation == m so their
+// demod runs at the sub-band rate. Offsets snap to the nearest k·fs/m.
+static inline void mc_engine_bind_subbands(mc_engine_t* mc, double sampling_rate_hz, uint32_t m){
+    for (uint8_t c = 0; c < mc->n_channels; c++) {
+        mc_channel_t* ch = &mc->ch[c];
+        int32_t k = (int32_t)lrint(ch->cfg.offset_hz * (double)m / sampling_rate_hz);
+        ch->subband  = (uint8_t)(((k % (int32_t)m) + (int32_t)m) % (int32_t)m);
+        ch->dec_norm = 1.0 / (PFB_Q15_GAIN * ch->demod.scale * ch->cfg.level);
+    }
+}
+
+// n_frames channelizer outputs of m sub-bands each (pfb_q15_process layout)
+static inline void mc_engine_process_subbands(mc_engine_t* mc, const pfb_cq15_t* frames,
+                                              uint32_t n_frames, uint32_t m){
+    for (uint32_t f = 0; f < n_frames; f++) {
+        const pfb_cq15_t* frame = frames + f * m;
+        for (uint8_t c = 0; c < mc->n_channels; c++) {
+            mc_channel_t* ch = &mc->ch[c];
+            pfb_cq15_t y = frame[ch->subband];
+            mc_channel_push(ch, y.re * ch->dec_norm, y.im * ch->dec_norm);
+        }
+    }
+}
+
+// Closes the metric window every MC_WINDOW_BLOCKS; returns true when updated
+static inline bool mc_engine_block_done(mc_engine_t* mc){
+    if (++mc->blocks < MC_WINDOW_BLOCKS) return false;
+    mc->blocks = 0;
+
+    for (uint8_t c = 0; c < mc->n_channels; c++) {
+        mc_channel_t* ch = &mc->ch[c];
+        demod_t* d = &ch->demod;
+        if (d->symbol_count == 0 || d->sample_count == 0) continue;
+
+        double sym_sig = GET_AVG_POWER(d, symbol, signal);
+        double sym_err = GET_AVG_POWER(d, symbol, error);
+        double smp_sig = GET_AVG_POWER(d, sample, signal);
+        double smp_err = GET_AVG_POWER(d, sample, error);
+
+        double mer = (sym_err > 1e-6 && sym_sig > 1e-6) ? 10.0 * log10(sym_sig / sym_err) : 0.0;
+        double snr = (smp_err > 1e-6) ? 10.0 * log10(smp_sig / smp_err) : 0.0;
+        double evm = (smp_sig > 1e-6) ? sqrt(smp_err / smp_sig) * 100.0 : 0.0;
+
+        mc_channel_metrics_t* m = &ch->metrics;
+        if (!m->valid) {
+            m->mer = mer;
+            m->snr = snr;
+            m->evm = evm;
+            m->valid = true;
+        } else {
+            m->mer = (MC_EMA_ALPHA * mer) + ((1.0 - MC_EMA_ALPHA) * m->mer);
+            m->snr = (MC_EMA_ALPHA * snr) + ((1.0 - MC_EMA_ALPHA) * m->snr);
+            m->evm = (MC_EMA_ALPHA * evm) + ((1.0 - MC_EMA_ALPHA) * m->evm);
+        }
+        m->symbols += d->symbol_count;
+
+        symbol_acc_t sym = d->sym;   // keep the running symbol across windows
+        demod_reset_accumulators(d);
+        d->sym = sym;
+    }
+    return true;
+}
+
+#endif
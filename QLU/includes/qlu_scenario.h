@@ -0,0 +1,345 @@
+#ifndef QLU_SCENARIO_H
+
+#define QLU_SCENARIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "qlu_source.h"
+#include "qlu_impair.h"
+
+// ---------------------------------------------------------------------------
+// SCENARIOS — time-varying channel impairments from keyframe scripts
+// ---------------------------------------------------------------------------
+//
+//   A script is a timeline of keyframes, one statement per line (or per ';',
+//   so it fits a websocket message), '#' starts a comment:
+//
+//       name rain_fade
+//       0       snr=24 iq_phase=2
+//       20      snr=24
+//       26      snr=7           ease       # fade in 6 s
+//       40      snr=7
+//       52      snr=24          linear
+//       loop
+//
+//   TIME is in seconds (or with an "ms" suffix), followed by any of
+//       snr       dB, AWGN against the unit-power constellation
+//       cfo       Hz           pn        Hz (Wiener linewidth)
+//       ppm       ADC clock    iq_amp    dB       iq_phase  deg
+//       dc_i      dc_q         normalised units
+//   and optionally how the parameters get there from their previous keyframe:
+//       linear    (default)
+//       step      hold the previous value, jump at TIME
+//       ease      smoothstep, slow at both ends
+//
+//   Every parameter has its own track: a keyframe only moves the parameters
+//   it names, the others keep interpolating between their own keyframes.
+//   Before its first keyframe a parameter has that keyframe's value, after its
+//   last one it holds. Parameters without keyframes are not driven (AWGN
+//   stays off without any snr=). "loop" restarts the timeline after the last
+//   keyframe.
+//
+//   qlu_scenario_source_t drives a qlu_impaired_source_t from a script. Time
+//   is the pair count over pair_rate_hz, so a host run goes as fast as the
+//   DSP can take it, or an external clock (seconds) for real-time pacing.
+//   Parameters are re-evaluated QLU_SCENARIO_UPDATE_HZ times per scenario
+//   second, and qlu_impair_set() keeps phase, clock and RNG across updates.
+
+#define QLU_SCENARIO_MAX_KEYS   16      // per parameter
+#define QLU_SCENARIO_NAME_MAX   24
+#define QLU_SCENARIO_TOKEN_MAX  32
+#define QLU_SCENARIO_UPDATE_HZ  1000
+
+typedef enum {
+    QLU_SCN_SNR,
+    QLU_SCN_CFO,
+    QLU_SCN_PN,
+    QLU_SCN_PPM,
+    QLU_SCN_IQ_AMP,
+    QLU_SCN_IQ_PHASE,
+    QLU_SCN_DC_I,
+    QLU_SCN_DC_Q,
+
+    QLU_SCN_PARAM_COUNT
+} qlu_scenario_param_t;
+
+static const char* const qlu_scenario_param_name[QLU_SCN_PARAM_COUNT] = {
+    [QLU_SCN_SNR]      = "snr",
+    [QLU_SCN_CFO]      = "cfo",
+    [QLU_SCN_PN]       = "pn",
+    [QLU_SCN_PPM]      = "ppm",
+    [QLU_SCN_IQ_AMP]   = "iq_amp",
+    [QLU_SCN_IQ_PHASE] = "iq_phase",
+    [QLU_SCN_DC_I]     = "dc_i",
+    [QLU_SCN_DC_Q]     = "dc_q"
+};
+
+typedef enum {
+    QLU_SCN_LINEAR,
+    QLU_SCN_STEP,
+    QLU_SCN_EASE,
+
+    QLU_SCN_INTERP_COUNT
+} qlu_scenario_interp_t;
+
+static const char* const qlu_scenario_interp_name[QLU_SCN_INTERP_COUNT] = {
+    [QLU_SCN_LINEAR] = "linear",
+    [QLU_SCN_STEP]   = "step",
+    [QLU_SCN_EASE]   = "ease"
+};
+
+typedef struct {
+    float   t;
+    float   v;
+    uint8_t interp;             // how the segment ending here is travelled
+} qlu_scenario_key_t;
+
+typedef struct {
+    qlu_scenario_key_t key[QLU_SCENARIO_MAX_KEYS];
+    uint8_t            n;
+} qlu_scenario_track_t;
+
+typedef struct {
+    char                 name[QLU_SCENARIO_NAME_MAX];
+    bool                 loop;
+    float                duration;      // time of the last keyframe
+    qlu_scenario_track_t track[QLU_SCN_PARAM_COUNT];
+} qlu_scenario_t;
+
+// ---- Parser -----------------------------------------------------------------
+
+// Next whitespace-separated token of [*p, end) into out; false when none is left
+static inline bool qlu_scenario_token(const char** p, const char* end, char* out){
+    const char* s = *p;
+    while (s < end && (*s == ' ' || *s == '\t' || *s == '\r')) s++;
+    const char* e = s;
+    while (e < end && *e != ' ' && *e != '\t' && *e != '\r') e++;
+    *p = e;
+    if (e == s) return false;
+
+    size_t len = (size_t)(e - s);
+    if (len >= QLU_SCENARIO_TOKEN_MAX) len = QLU_SCENARIO_TOKEN_MAX - 1;
+    memcpy(out, s, len);
+    out[len] = '\0';
+    return true;
+}
+
+static inline bool qlu_scenario_number(const char* s, float* out){
+    char* e;
+    *out = strtof(s, &e);
+    return e != s && *e == '\0' && isfinite(*out);
+}
+
+static inline bool qlu_scenario_time(const char* s, float* out){
+    char* e;
+    *out = strtof(s, &e);
+    if (e == s || !isfinite(*out) || *out < 0.0f) return false;
+    if (strcmp(e, "ms") == 0) { *out *= 1e-3f; return true; }
+    return *e == '\0' || strcmp(e, "s") == 0;
+}
+
+static inline bool qlu_scenario_statement(qlu_scenario_t* sc, const char* p, const char* end, const char** err){
+    char tok[QLU_SCENARIO_TOKEN_MAX];
+    float t;
+
+    if (!qlu_scenario_token(&p, end, tok)) return true;      // blank or comment only
+
+    if (strcmp(tok, "loop") == 0) {
+        sc->loop = true;
+        return true;
+    }
+    if (strcmp(tok, "name") == 0) {
+        if (!qlu_scenario_token(&p, end, tok)) { *err = "name needs a value"; return false; }
+        strncpy(sc->name, tok, QLU_SCENARIO_NAME_MAX - 1);
+        sc->name[QLU_SCENARIO_NAME_MAX - 1] = '\0';
+        return true;
+    }
+    if (!qlu_scenario_time(tok, &t)) { *err = "expected a time, 'name' or 'loop'"; return false; }
+
+    // Values first, the interpolation word may come anywhere in the statement
+    float   value[QLU_SCN_PARAM_COUNT] = {0};
+    bool    set[QLU_SCN_PARAM_COUNT] = {0};
+    uint8_t interp = QLU_SCN_LINEAR;
+
+    while (qlu_scenario_token(&p, end, tok)) {
+        char* eq = strchr(tok, '=');
+        if (!eq) {
+            uint32_t m = 0;
+            while (m < QLU_SCN_INTERP_COUNT && strcmp(tok, qlu_scenario_interp_name[m]) != 0) m++;
+            if (m == QLU_SCN_INTERP_COUNT) { *err = "unknown interpolation"; return false; }
+            interp = (uint8_t)m;
+            continue;
+        }
+        *eq = '\0';
+        uint32_t k = 0;
+        while (k < QLU_SCN_PARAM_COUNT && strcmp(tok, qlu_scenario_param_name[k]) != 0) k++;
+        if (k == QLU_SCN_PARAM_COUNT)                { *err = "unknown parameter"; return false; }
+        if (!qlu_scenario_number(eq + 1, &value[k])) { *err = "bad value"; return false; }
+        set[k] = true;
+    }
+
+    for (uint32_t k = 0; k < QLU_SCN_PARAM_COUNT; k++) {
+        if (!set[k]) continue;
+        qlu_scenario_track_t* tr = &sc->track[k];
+        if (tr->n == QLU_SCENARIO_MAX_KEYS)          { *err = "too many keyframes for a parameter"; return false; }
+        if (tr->n > 0 && t < tr->key[tr->n - 1].t)   { *err = "keyframes out of order"; return false; }
+        tr->key[tr->n++] = (qlu_scenario_key_t){ .t = t, .v = value[k], .interp = interp };
+        if (t > sc->duration) sc->duration = t;
+    }
+    return true;
+}
+
+// Parses a whole script; 0 on success, else the line of the first error
+// with *err saying why
+static inline uint32_t qlu_scenario_parse(qlu_scenario_t* sc, const char* text, const char** err){
+    uint32_t line = 1;
+    bool any = false;
+
+    *sc  = (qlu_scenario_t){0};
+    *err = NULL;
+    while (*text) {
+        const char* end = text;
+        while (*end && *end != '\n' && *end != ';' && *end != '#') end++;
+        const char* stop = end;
+        if (*end == '#') while (*end && *end != '\n') end++;      // comments run to the line end
+
+        if (!qlu_scenario_statement(sc, text, stop, err)) return line;
+        if (*end == '\n') line++;
+        text = *end ? end + 1 : end;
+    }
+    for (uint32_t k = 0; k < QLU_SCN_PARAM_COUNT; k++) any |= sc->track[k].n > 0;
+    if (!any) {
+        *err = "no keyframes";
+        return line;
+    }
+    return 0;
+}
+
+// ---- Evaluation ---------------------------------------------------------------
+
+static inline float qlu_scenario_track_at(const qlu_scenario_track_t* tr, float t){
+    const qlu_scenario_key_t* k = tr->key;
+    if (t <= k[0].t) return k[0].v;
+
+    for (uint32_t j = 1; j < tr->n; j++) {
+        if (t < k[j].t) {
+            float u = (t - k[j - 1].t) / (k[j].t - k[j - 1].t);
+            if (k[j].interp == QLU_SCN_STEP) u = 0.0f;
+            if (k[j].interp == QLU_SCN_EASE) u = u * u * (3.0f - 2.0f * u);
+            return k[j - 1].v + u * (k[j].v - k[j - 1].v);
+        }
+    }
+    return k[tr->n - 1].v;
+}
+
+// Timeline position of t: wraps for looping scripts
+static inline float qlu_scenario_wrap(const qlu_scenario_t* sc, float t){
+    return (sc->loop && sc->duration > 0.0f) ? fmodf(t, sc->duration) : t;
+}
+
+// Value of one parameter at t; false when the script does not drive it
+static inline bool qlu_scenario_value(const qlu_scenario_t* sc, qlu_scenario_param_t p, float t, float* out){
+    if (sc->track[p].n == 0) return false;
+    *out = qlu_scenario_track_at(&sc->track[p], qlu_scenario_wrap(sc, t));
+    return true;
+}
+
+// Writes the driven parameters at t into cfg, the rest is left as it is
+static inline void qlu_scenario_eval(const qlu_scenario_t* sc, float t, qlu_impair_config_t* cfg){
+    if (qlu_scenario_value(sc, QLU_SCN_SNR, t, &cfg->snr_db)) cfg->awgn = true;
+    qlu_scenario_value(sc, QLU_SCN_CFO,      t, &cfg->cfo_hz);
+    qlu_scenario_value(sc, QLU_SCN_PN,       t, &cfg->phase_noise_hz);
+    qlu_scenario_value(sc, QLU_SCN_PPM,      t, &cfg->clock_ppm);
+    qlu_scenario_value(sc, QLU_SCN_IQ_AMP,   t, &cfg->iq_amp_db);
+    qlu_scenario_value(sc, QLU_SCN_IQ_PHASE, t, &cfg->iq_phase_deg);
+    qlu_scenario_value(sc, QLU_SCN_DC_I,     t, &cfg->dc_i);
+    qlu_scenario_value(sc, QLU_SCN_DC_Q,     t, &cfg->dc_q);
+}
+
+// ---- Source -------------------------------------------------------------------
+
+typedef struct {
+    qlu_source_t           base;
+    qlu_impaired_source_t* impaired;        // the impairments the script drives
+    const qlu_scenario_t*  sc;
+    qlu_impair_config_t    fixed;           // what the script leaves alone
+    qlu_impair_config_t    now;             // last applied
+    double                 pair_rate_hz;    // pairs per scenario second
+    double               (*clock)(void);    // seconds; NULL = pair count
+    double                 t_start;
+    float                  t;               // scenario time of the last update
+    uint32_t               update_pairs;
+    uint64_t               next_update;     // pair count of the next update
+    double                 next_update_s;   // same, on the clock
+} qlu_scenario_source_t;
+
+static inline void qlu_scenario_source_update(qlu_scenario_source_t* s, double t){
+    s->t   = (float)t;
+    s->now = s->fixed;
+    qlu_scenario_eval(s->sc, s->t, &s->now);
+    qlu_impair_set(&s->impaired->imp, &s->now);
+}
+
+// On pair time, reads stop at update boundaries so a parameter change never
+// lands later than 1 / QLU_SCENARIO_UPDATE_HZ; on a clock, the update is
+// checked once per read
+static uint32_t qlu_scenario_source_read(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    qlu_scenario_source_t* s = (qlu_scenario_source_t*)src;
+    uint64_t pos = s->base.pairs;
+
+    if (s->clock) {
+        double t = s->clock() - s->t_start;
+        if (t >= s->next_update_s) {
+            qlu_scenario_source_update(s, t);
+            s->next_update_s = t + 1.0 / QLU_SCENARIO_UPDATE_HZ;
+        }
+        return qlu_source_read(&s->impaired->base, i_out, q_out, n);
+    }
+    if (pos >= s->next_update) {
+        qlu_scenario_source_update(s, (double)pos / s->pair_rate_hz);
+        s->next_update = pos + s->update_pairs;
+    }
+    if (n > s->next_update - pos) n = (uint32_t)(s->next_update - pos);
+    return qlu_source_read(&s->impaired->base, i_out, q_out, n);
+}
+
+static void qlu_scenario_source_close(qlu_source_t* src){
+    qlu_source_close(&((qlu_scenario_source_t*)src)->impaired->base);
+}
+
+static const qlu_source_ops_t qlu_scenario_source_ops = {
+    .name  = "scenario",
+    .read  = qlu_scenario_source_read,
+    .close = qlu_scenario_source_close
+};
+
+// Starts sc at t = 0 on top of impaired, whose current config becomes the
+// fixed part; pair_rate_hz 0 = the impairment sample rate
+static inline qlu_source_t* qlu_scenario_source_init(qlu_scenario_source_t* s, qlu_impaired_source_t* impaired,
+                                                     const qlu_scenario_t* sc, double pair_rate_hz){
+    *s = (qlu_scenario_source_t){
+        .base         = { .ops = &qlu_scenario_source_ops },
+        .impaired     = impaired,
+        .sc           = sc,
+        .fixed        = impaired->imp.cfg,
+        .pair_rate_hz = (pair_rate_hz > 0.0) ? pair_rate_hz : (double)impaired->imp.cfg.sample_rate_hz,
+    };
+    if (s->pair_rate_hz <= 0.0) s->pair_rate_hz = 1.0;
+    s->update_pairs = (uint32_t)(s->pair_rate_hz / QLU_SCENARIO_UPDATE_HZ);
+    if (s->update_pairs == 0) s->update_pairs = 1;
+    return &s->base;
+}
+
+// Real time: scenario seconds from clock() (restarts the timeline)
+static inline void qlu_scenario_source_set_clock(qlu_scenario_source_t* s, double (*clock)(void)){
+    s->clock         = clock;
+    s->t_start       = clock ? clock() : 0.0;
+    s->next_update   = s->base.pairs;
+    s->next_update_s = 0.0;
+}
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef QLU_SOURCE_H
+
+#define QLU_SOURCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "qlu_demod.h"
+
+// ---------------------------------------------------------------------------
+// SAMPLE SOURCES — pluggable producers of I/Q blocks
+// ---------------------------------------------------------------------------
+//
+//   A source writes up to n pairs into the caller's planar buffers, in the
+//   format the DSP block (IqBlock_t) carries: offset-binary words at the
+//   configured signal_resolution, as the ADC / compiled-in headers deliver.
+//
+//       qlu_source_t* src = qlu_array_source_init(&arr, complex_qam16_13,
+//                                                 complex_qam16_13_meta.n_samples);
+//       qlu_source_fill(src, blk.i_samples, blk.q_samples, PROCESS_BLOCK_SIZE);
+//
+//   Each implementation embeds qlu_source_t as its first member and its
+//   init returns a pointer to it, so callers only see the vtable and
+//   nothing is allocated. Here, portable to the firmware:
+//       array     compiled-in interleaved u16 array, wraps around
+//       synth     random symbols of a modulation, rectangular pulses
+//   Host-only sources (files, stdin, TCP) live in c_sim/includes/iq_source.h.
+
+typedef struct qlu_source qlu_source_t;
+
+typedef struct {
+    const char* name;
+    // Up to n pairs; returns the pairs written, 0 once the source is done
+    uint32_t (*read)(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n);
+    void     (*close)(qlu_source_t* src);
+} qlu_source_ops_t;
+
+struct qlu_source {
+    const qlu_source_ops_t* ops;
+    uint64_t                pairs;      // handed out so far
+};
+
+static inline uint32_t qlu_source_read(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    uint32_t got = src->ops->read(src, i_out, q_out, n);
+    src->pairs += got;
+    return got;
+}
+
+// Whole n pairs unless the source ends first (streams may return short)
+static inline uint32_t qlu_source_fill(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    uint32_t done = 0;
+    while (done < n) {
+        uint32_t got = qlu_source_read(src, i_out + done, q_out + done, n - done);
+        if (got == 0) break;
+        done += got;
+    }
+    return done;
+}
+
+static inline void qlu_source_close(qlu_source_t* src){
+    if (src->ops->close) src->ops->close(src);
+}
+
+static inline const char* qlu_source_name(const qlu_source_t* src){
+    return src->ops->name;
+}
+
+// ---- Array ----------------------------------------------------------------
+
+// Interleaved I, Q values; the index wraps per value, so arrays with an odd
+// count keep the layout the test tasks always had
+typedef struct {
+    qlu_source_t    base;
+    const uint16_t* values;
+    uint32_t        n_values;
+    uint32_t        pos;
+} qlu_array_source_t;
+
+static uint32_t qlu_array_source_read(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    qlu_array_source_t* a = (qlu_array_source_t*)src;
+    const uint16_t* v = a->values;
+    uint32_t pos = a->pos, len = a->n_values;
+
+    if (len < 2) return 0;
+    for (uint32_t k = 0; k < n; k++) {
+        i_out[k] = v[pos];
+        if (++pos == len) pos = 0;
+        q_out[k] = v[pos];
+        if (++pos == len) pos = 0;
+    }
+    a->pos = pos;
+    return n;
+}
+
+static const qlu_source_ops_t qlu_array_source_ops = {
+    .name  = "array",
+    .read  = qlu_array_source_read,
+    .close = NULL
+};
+
+static inline qlu_source_t* qlu_array_source_init(qlu_array_source_t* a, const uint16_t* values, uint32_t n_values){
+    *a = (qlu_array_source_t){
+        .base     = { .ops = &qlu_array_source_ops },
+        .values   = values,
+        .n_values = n_values,
+    };
+    return &a->base;
+}
+
+// ---- Synthetic ------------------------------------------------------------
+
+// Uniform random symbols held for samples_per_symbol samples, at the
+// amplitude the demod expects (config_get_scale_factor), no impairments.
+// Level codes are precomputed, the per-sample path is integer only.
+#define QLU_SYNTH_MAX_LEVELS 4
+
+typedef struct {
+    qlu_source_t base;
+    uint16_t     codes[QLU_SYNTH_MAX_LEVELS];    // offset-binary per level
+    uint8_t      n_levels;
+    bool         q_active;      // false for BPSK: Q sits at mid-scale
+    uint16_t     mid;
+    uint32_t     sps;
+    uint32_t     phase;         // samples left in the current symbol
+    uint16_t     cur_i, cur_q;
+    uint32_t     rng;
+} qlu_synth_source_t;
+
+static inline uint32_t qlu_synth_next(uint32_t* s){
+    uint32_t x = *s;                // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+static uint32_t qlu_synth_source_read(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    qlu_synth_source_t* s = (qlu_synth_source_t*)src;
+
+    for (uint32_t k = 0; k < n; k++) {
+        if (s->phase == 0) {
+            uint32_t r = qlu_synth_next(&s->rng);
+            s->cur_i = s->codes[(r & 0xFFFFu) % s->n_levels];
+            s->cur_q = s->q_active ? s->codes[(r >> 16) % s->n_levels] : s->mid;
+            s->phase = s->sps;
+        }
+        s->phase--;
+        i_out[k] = s->cur_i;
+        q_out[k] = s->cur_q;
+    }
+    return n;
+}
+
+static const qlu_source_ops_t qlu_synth_source_ops = {
+    .name  = "synth",
+    .read  = qlu_synth_source_read,
+    .close = NULL
+};
+
+// cfg needs config_calculate_derived() first; seed 0 picks a fixed one
+static inline qlu_source_t* qlu_synth_source_init(qlu_synth_source_t* s, const demod_config_t* cfg, uint32_t seed){
+    static const float levels[MOD_NUM_MODULATIONS][QLU_SYNTH_MAX_LEVELS] = {
+        [MOD_BPSK]  = { -1.0f, +1.0f },
+        [MOD_QPSK]  = { -0.7071067812f, +0.7071067812f },
+        [MOD_16QAM] = { -0.9486832981f, -0.3162277660f, +0.3162277660f, +0.9486832981f },
+    };
+    static const uint8_t n_levels[MOD_NUM_MODULATIONS] = {
+        [MOD_BPSK] = 2, [MOD_QPSK] = 2, [MOD_16QAM] = 4
+    };
+
+    uint32_t max_uint = (1u << cfg->signal_resolution) - 1u;
+    double   scale    = config_get_scale_factor(cfg);
+
+    *s = (qlu_synth_source_t){
+        .base     = { .ops = &qlu_synth_source_ops },
+        .n_levels = n_levels[cfg->modulation],
+        .q_active = cfg->modulation != MOD_BPSK,
+        .mid      = (uint16_t)(max_uint / 2u),
+        .sps      = (cfg->samples_per_symbol >= 1.0) ? (uint32_t)cfg->samples_per_symbol : 1u,
+        .rng      = seed ? seed : 0x514C5531u,
+    };
+    for (uint8_t l = 0; l < s->n_levels; l++) {
+        double code = (double)s->mid + levels[cfg->modulation][l] * scale;
+        if (code < 0.0)             code = 0.0;
+        if (code > (double)max_uint) code = (double)max_uint;
+        s->codes[l] = (uint16_t)(code + 0.5);
+    }
+    return &s->base;
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef QLU_SPSC_H
+
+#define QLU_SPSC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ---------------------------------------------------------------------------
+// SPSC INDEX RING — lock-free slot handoff between two cores
+// ---------------------------------------------------------------------------
+//
+//   The ring only moves indices into a caller-owned pool of `depth` buffers
+//   (power of two); the buffers themselves are never copied. head and tail
+//   are free-running uint32 counters, slot = counter & mask:
+//
+//       producer owns  [head, tail + depth)    claim -> fill -> publish
+//       consumer owns  [tail, head)            peek  -> use  -> release
+//
+//   Only the producer writes head and only the consumer writes tail, so no
+//   lock or compare-and-swap is needed: a store-release of its own counter
+//   makes the slot contents visible to the other side, which reads the
+//   counter with load-acquire before touching the slot.
+//
+//   RP2040: both cores share the bus and the M0+ has no atomics beyond
+//   aligned word access, so the counters are volatile words fenced with
+//   __dmb(). Host builds use C11 atomics with the same ordering.
+
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+
+#include "hardware/sync.h"
+
+typedef volatile uint32_t spsc_counter_t;
+
+static inline uint32_t spsc_load_acquire(const spsc_counter_t* c){
+    uint32_t v = *c;
+    __dmb();
+    return v;
+}
+
+static inline void spsc_store_release(spsc_counter_t* c, uint32_t v){
+    __dmb();
+    *c = v;
+}
+
+static inline uint32_t spsc_load_own(const spsc_counter_t* c){
+    return *c;
+}
+
+#else
+
+#include <stdatomic.h>
+
+typedef _Atomic uint32_t spsc_counter_t;
+
+static inline uint32_t spsc_load_acquire(const spsc_counter_t* c){
+    return atomic_load_explicit((spsc_counter_t*)c, memory_order_acquire);
+}
+
+static inline void spsc_store_release(spsc_counter_t* c, uint32_t v){
+    atomic_store_explicit(c, v, memory_order_release);
+}
+
+static inline uint32_t spsc_load_own(const spsc_counter_t* c){
+    return atomic_load_explicit((spsc_counter_t*)c, memory_order_relaxed);
+}
+
+#endif
+
+typedef struct {
+    spsc_counter_t head;      // next slot the producer fills
+    spsc_counter_t tail;      // next slot the consumer takes
+    uint32_t depth;
+    uint32_t mask;
+} spsc_ring_t;
+
+// depth: power of two, the number of pool buffers
+static inline int spsc_init(spsc_ring_t* r, uint32_t depth){
+    if (depth == 0 || (depth & (depth - 1)) != 0) return -1;
+    spsc_store_release(&r->head, 0);
+    spsc_store_release(&r->tail, 0);
+    r->depth = depth;
+    r->mask  = depth - 1u;
+    return 0;
+}
+
+// Producer: slot to fill next, or -1 when every buffer is in flight.
+// Claiming twice without publishing returns the same slot.
+static inline int32_t spsc_producer_claim(const spsc_ring_t* r){
+    uint32_t head = spsc_load_own(&r->head);
+    if (head - spsc_load_acquire(&r->tail) >= r->depth) return -1;
+    return (int32_t)(head & r->mask);
+}
+
+// Producer: hands the claimed slot to the consumer
+static inline void spsc_producer_publish(spsc_ring_t* r){
+    spsc_store_release(&r->head, spsc_load_own(&r->head) + 1u);
+}
+
+// Consumer: oldest published slot, or -1 when empty. The slot stays owned
+// by the consumer until spsc_consumer_release().
+static inline int32_t spsc_consumer_peek(const spsc_ring_t* r){
+    uint32_t tail = spsc_load_own(&r->tail);
+    if (spsc_load_acquire(&r->head) == tail) return -1;
+    return (int32_t)(tail & r->mask);
+}
+
+// Consumer: returns the peeked slot to the producer
+static inline void spsc_consumer_release(spsc_ring_t* r){
+    spsc_store_release(&r->tail, spsc_load_own(&r->tail) + 1u);
+}
+
+// Published, not yet released (either side; a snapshot)
+static inline uint32_t spsc_pending(const spsc_ring_t* r){
+    return spsc_load_acquire(&r->head) - spsc_load_acquire(&r->tail);
+}
+
+#endif
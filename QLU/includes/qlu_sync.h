@@ -0,0 +1,392 @@
+#ifndef QLU_SYNC_H
+
+#define QLU_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// FRAME SYNC — word-wise marker search over the DMA ring
+// ---------------------------------------------------------------------------
+//
+//   v1: FE CA FE CA | payload (payload_size bytes)
+//   v2: FE CA FE CA | ver | fmt | len (BE16) | seq (BE32) | payload | crc (BE32)
+//       crc = CRC-32 (IEEE 802.3, zlib) over ver..payload, so a corrupted
+//       length or sequence is caught as well as a corrupted payload.
+//
+//   The marker search loads one aligned 32-bit word at a time and tests all
+//   four bytes for 0xFE at once (SWAR zero-byte test on w ^ 0xFEFEFEFE); only
+//   words that contain a 0xFE are checked byte by byte. Once the marker is
+//   found the payload is not scanned at all: the parser waits until the whole
+//   payload is in the ring and either hands out a descriptor or copies it with
+//   at most two memcpy calls (one per side of the wrap). A v2 header with a
+//   bad version or length is a false marker: the search resumes one byte on.
+//
+//   Positions are absolute stream byte counts (mod 2^32), ring index = pos &
+//   mask. The caller supplies how many bytes the DMA has written so far, which
+//   makes a full ring distinguishable from an empty one and lets a lapped
+//   reader be detected. Pure C, no SDK calls, so the same code runs on the
+//   host benchmarks.
+//
+//   Tracking: once a frame has been taken, the next marker is expected right
+//   behind it (back-to-back frames). The parser then checks the predicted
+//   offset with a single 32-bit compare and goes straight to the header;
+//   only a mismatch drops it back to the marker search (counted as a resync).
+//
+//   Zero-copy handoff: sync_parser_poll_desc() returns a frame_desc_t that
+//   points at the payload inside the ring. The consumer reads the samples in
+//   place and, once done, checks sync_frame_intact() to know whether the DMA
+//   overwrote the region meanwhile. The CRC is checked by the caller (DMA
+//   sniffer on the RP2040, table CRC on the host) and reported back with
+//   sync_parser_commit(), which also does the sequence-gap accounting.
+//
+//   Byte-stream front-end: sources that are not a DMA ring (host replay of
+//   captures, files, sockets) push bytes with sync_stream_feed(); the stream
+//   copies them into its own ring, runs the same parser and calls back once
+//   per frame with a contiguous payload.
+
+#define SYNC_MARKER_SIZE   4
+#define SYNC_MARKER_BYTE0  0xFE
+#define SYNC_MARKER_BYTE1  0xCA
+
+#define SYNC_V2_VERSION      2
+#define SYNC_V2_HEADER_SIZE  12
+#define SYNC_V2_CRC_SIZE     4
+
+typedef enum {
+    SYNC_FRAME_V1,
+    SYNC_FRAME_V2
+} sync_frame_version_t;
+
+// fmt byte: high nibble = sample format, low nibble = significant bits - 1
+// (packing and unpacking in qlu_iqpack.h)
+typedef enum {
+    SYNC_FMT_IQ16_BE = 0,     // I, Q as big-endian 16-bit words
+    SYNC_FMT_IQ12    = 1,     // I, Q packed 12-bit, 3 bytes per pair
+    SYNC_FMT_IQ8     = 2,     // I, Q as 8-bit, 2 bytes per pair
+    SYNC_FMT_COUNT
+} sync_sample_format_t;
+
+#define SYNC_FMT_BYTE(format, bits)  ((uint8_t)(((format) << 4) | (((bits) - 1) & 0x0F)))
+#define SYNC_FMT_FORMAT(fmt)         ((sync_sample_format_t)((fmt) >> 4))
+#define SYNC_FMT_BITS(fmt)           (((fmt) & 0x0F) + 1)
+
+// Payload still sitting in the DMA ring
+typedef struct {
+    uint32_t pos;             // absolute stream position of the first payload byte
+    uint32_t seq;             // sender sequence (v2) or frames extracted so far (v1)
+    uint16_t length;
+    uint8_t  fmt;
+
+    // v2 integrity: CRC over crc_len bytes from crc_pos, expected value crc
+    uint32_t crc_pos;
+    uint16_t crc_len;
+    uint32_t crc;
+} frame_desc_t;
+
+typedef struct {
+    const uint8_t* ring;      // must be 4-byte aligned
+    uint32_t size;            // power of two, comfortably larger than one frame
+    uint32_t mask;
+    uint32_t payload_size;    // v1: fixed payload, v2: largest accepted payload
+    sync_frame_version_t version;
+
+    uint32_t tail;            // next unread absolute position
+    bool     in_payload;      // header consumed, waiting for the payload
+    bool     tracking;        // next marker predicted at tail
+    frame_desc_t cur;
+
+    uint32_t frames;
+    uint32_t skipped_bytes;   // bytes discarded while searching for a marker
+    uint32_t overruns;        // times the DMA lapped the parser
+    uint32_t bad_headers;     // marker matched but version/length invalid
+    uint32_t crc_errors;
+    uint32_t lost_frames;     // sequence gaps between CRC-valid frames
+    uint32_t track_hits;      // headers taken at the predicted offset
+    uint32_t resyncs;         // prediction missed, back to the search
+
+    uint32_t next_seq;
+    bool     seq_valid;
+} sync_parser_t;
+
+// `start` is the DMA byte count at the moment the parser takes over
+static inline void sync_parser_init(sync_parser_t* p, const uint8_t* ring, uint32_t size,
+                                    uint32_t payload_size, sync_frame_version_t version,
+                                    uint32_t start){
+    memset(p, 0, sizeof(*p));
+    p->ring         = ring;
+    p->size         = size;
+    p->mask         = size - 1u;
+    p->payload_size = payload_size;
+    p->version      = version;
+    p->tail         = start;
+}
+
+// The DMA writes position `written` next, which overwrites written - size
+static inline bool sync_frame_intact(const frame_desc_t* d, uint32_t written, uint32_t ring_size){
+    return (written - d->pos) <= ring_size;
+}
+
+static inline uint8_t sync_ring_byte(const sync_parser_t* p, uint32_t pos){
+    return p->ring[pos & p->mask];
+}
+
+static inline uint32_t sync_ring_be32(const sync_parser_t* p, uint32_t pos){
+    return ((uint32_t)sync_ring_byte(p, pos + 0) << 24) | ((uint32_t)sync_ring_byte(p, pos + 1) << 16) |
+           ((uint32_t)sync_ring_byte(p, pos + 2) <<  8) |  (uint32_t)sync_ring_byte(p, pos + 3);
+}
+
+static inline bool sync_match_at(const sync_parser_t* p, uint32_t pos){
+    return p->ring[(pos + 0) & p->mask] == SYNC_MARKER_BYTE0 &&
+           p->ring[(pos + 1) & p->mask] == SYNC_MARKER_BYTE1 &&
+           p->ring[(pos + 2) & p->mask] == SYNC_MARKER_BYTE0 &&
+           p->ring[(pos + 3) & p->mask] == SYNC_MARKER_BYTE1;
+}
+
+// Predicted-offset check: one 32-bit compare against the marker word,
+// bytewise only when the 4 bytes straddle the wrap
+static inline bool sync_marker_word_at(const sync_parser_t* p, uint32_t pos){
+    static const uint8_t marker[SYNC_MARKER_SIZE] = {
+        SYNC_MARKER_BYTE0, SYNC_MARKER_BYTE1, SYNC_MARKER_BYTE0, SYNC_MARKER_BYTE1
+    };
+    uint32_t idx = pos & p->mask;
+    if (idx > p->size - SYNC_MARKER_SIZE) return sync_match_at(p, pos);
+
+    uint32_t w, m;
+    memcpy(&w, p->ring + idx, sizeof(w));
+    memcpy(&m, marker, sizeof(m));
+    return w == m;
+}
+
+// True when any byte of w is 0xFE
+static inline bool sync_word_has_fe(uint32_t w){
+    uint32_t v = w ^ 0xFEFEFEFEu;
+    return ((v - 0x01010101u) & ~v & 0x80808080u) != 0;
+}
+
+// Offset (from `start`) of the first marker among n candidate positions,
+// or n when there is none
+static inline uint32_t sync_find_marker(const sync_parser_t* p, uint32_t start, uint32_t n){
+    uint32_t off = 0;
+
+    // Byte steps up to the next word boundary
+    while (off < n && ((start + off) & 3u)) {
+        if (sync_match_at(p, start + off)) return off;
+        off++;
+    }
+
+    // Aligned words never straddle the wrap (size is a multiple of 4)
+    while (off + 4 <= n) {
+        const uint8_t* wp = __builtin_assume_aligned(p->ring + ((start + off) & p->mask), 4);
+        uint32_t w;
+        memcpy(&w, wp, sizeof(w));
+        if (sync_word_has_fe(w)) {
+            for (uint32_t j = 0; j < 4; j++) {
+                if (sync_match_at(p, start + off + j)) return off + j;
+            }
+        }
+        off += 4;
+    }
+
+    while (off < n) {
+        if (sync_match_at(p, start + off)) return off;
+        off++;
+    }
+    return n;
+}
+
+// Copies len bytes starting at stream position `from`, split at the wrap
+static inline void sync_ring_copy(const sync_parser_t* p, uint32_t from, uint8_t* dst, uint32_t len){
+    from &= p->mask;
+    uint32_t first = p->size - from;
+    if (first >= len) {
+        memcpy(dst, p->ring + from, len);
+    } else {
+        memcpy(dst, p->ring + from, first);
+        memcpy(dst + first, p->ring, len - first);
+    }
+}
+
+// Parses the v2 header at p->tail (marker already matched, header bytes in
+// the ring). Returns false for a false marker.
+static inline bool sync_parse_v2_header(sync_parser_t* p){
+    uint32_t h = p->tail + SYNC_MARKER_SIZE;
+    uint8_t  ver = sync_ring_byte(p, h + 0);
+    uint16_t len = (uint16_t)((sync_ring_byte(p, h + 2) << 8) | sync_ring_byte(p, h + 3));
+
+    if (ver != SYNC_V2_VERSION || len == 0 || len > p->payload_size) return false;
+
+    p->cur.fmt     = sync_ring_byte(p, h + 1);
+    p->cur.length  = len;
+    p->cur.seq     = sync_ring_be32(p, h + 4);
+    p->cur.crc_pos = h;
+    p->cur.crc_len = (uint16_t)(SYNC_V2_HEADER_SIZE - SYNC_MARKER_SIZE + len);
+    p->cur.pos     = p->tail + SYNC_V2_HEADER_SIZE;
+    return true;
+}
+
+// Marker at p->tail: reads the header and arms the payload wait. Returns
+// false for a false marker (bad v2 header).
+static inline bool sync_accept_header(sync_parser_t* p){
+    if (p->version == SYNC_FRAME_V2) {
+        if (!sync_parse_v2_header(p)) return false;
+    } else {
+        p->cur         = (frame_desc_t){0};
+        p->cur.pos     = p->tail + SYNC_MARKER_SIZE;
+        p->cur.seq     = p->frames;
+        p->cur.length  = (uint16_t)p->payload_size;
+        p->cur.fmt     = SYNC_FMT_BYTE(SYNC_FMT_IQ16_BE, 16);
+    }
+    p->in_payload = true;
+    return true;
+}
+
+// Consumes ring bytes up to `written` (total bytes written by the DMA).
+// Returns true and fills `d` when one complete frame is in the ring; call
+// again until it returns false.
+static inline bool sync_parser_poll_desc(sync_parser_t* p, uint32_t written, frame_desc_t* d){
+    const uint32_t header_size = (p->version == SYNC_FRAME_V2) ? SYNC_V2_HEADER_SIZE : SYNC_MARKER_SIZE;
+    const uint32_t trailer     = (p->version == SYNC_FRAME_V2) ? SYNC_V2_CRC_SIZE : 0;
+
+    for (;;) {
+        uint32_t avail = written - p->tail;
+
+        // Lapped: everything up to `written` minus one ring is gone, resync
+        if (avail > p->size) {
+            p->overruns++;
+            p->skipped_bytes += avail;
+            p->tail       = written;
+            p->in_payload = false;
+            p->tracking   = false;
+            return false;
+        }
+
+        if (p->in_payload) {
+            uint32_t need = (p->cur.pos - p->tail) + p->cur.length + trailer;
+            if (avail < need) return false;
+            *d = p->cur;
+            if (trailer) d->crc = sync_ring_be32(p, p->cur.pos + p->cur.length);
+            p->tail      += need;
+            p->in_payload = false;
+            p->tracking   = true;
+            p->frames++;
+            return true;
+        }
+
+        if (avail < header_size) return false;
+
+        if (p->tracking) {
+            if (sync_marker_word_at(p, p->tail) && sync_accept_header(p)) {
+                p->track_hits++;
+                continue;
+            }
+            p->tracking = false;
+            p->resyncs++;
+        }
+
+        // A frame may start at any byte that still has a full header behind it
+        uint32_t n   = avail - (header_size - 1);
+        uint32_t off = sync_find_marker(p, p->tail, n);
+        p->skipped_bytes += off;
+        p->tail += off;
+        if (off == n) return false;
+
+        if (!sync_accept_header(p)) {
+            p->bad_headers++;
+            p->skipped_bytes++;
+            p->tail++;
+        }
+    }
+}
+
+// Caller verdict on a polled frame: counts CRC errors and sequence gaps.
+// Returns crc_ok. A sequence that jumps backwards (sender restart) resyncs
+// the counter without being counted as loss.
+static inline bool sync_parser_commit(sync_parser_t* p, const frame_desc_t* d, bool crc_ok){
+    if (!crc_ok) {
+        p->crc_errors++;
+        return false;
+    }
+    if (p->seq_valid && d->seq != p->next_seq) {
+        uint32_t gap = d->seq - p->next_seq;
+        if (gap < 0x80000000u) p->lost_frames += gap;
+    }
+    p->next_seq  = d->seq + 1;
+    p->seq_valid = true;
+    return true;
+}
+
+// Copying variant: extracts one frame payload into `payload` (no CRC check)
+static inline bool sync_parser_poll(sync_parser_t* p, uint32_t written, uint8_t* payload){
+    frame_desc_t d;
+    if (!sync_parser_poll_desc(p, written, &d)) return false;
+    sync_ring_copy(p, d.pos, payload, d.length);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Byte-stream front-end
+// ---------------------------------------------------------------------------
+
+// Frame integrity check over the stream ring (NULL: frames are not checked)
+typedef bool (*sync_crc_fn)(const uint8_t* ring, uint32_t mask, const frame_desc_t* d);
+typedef void (*sync_frame_fn)(void* user, const frame_desc_t* d, const uint8_t* payload, bool crc_ok);
+
+typedef struct {
+    sync_parser_t parser;
+    uint8_t*      ring;       // power of two, at least twice the largest frame
+    uint8_t*      scratch;    // payload_size bytes, for payloads split by the wrap
+    uint32_t      written;
+    sync_crc_fn   crc;
+} sync_stream_t;
+
+static inline void sync_stream_init(sync_stream_t* s, uint8_t* ring, uint32_t size, uint8_t* scratch,
+                                    uint32_t payload_size, sync_frame_version_t version, sync_crc_fn crc){
+    sync_parser_init(&s->parser, ring, size, payload_size, version, 0);
+    s->ring    = ring;
+    s->scratch = scratch;
+    s->written = 0;
+    s->crc     = crc;
+}
+
+// Pushes n bytes; on_frame runs for every frame completed by them (CRC
+// failures included, flagged by crc_ok). Returns the number of frames.
+static inline uint32_t sync_stream_feed(sync_stream_t* s, const uint8_t* bytes, uint32_t n,
+                                        sync_frame_fn on_frame, void* user){
+    sync_parser_t* p = &s->parser;
+    frame_desc_t d;
+    uint32_t frames = 0;
+
+    while (n > 0) {
+        // Never overwrite bytes the parser has not consumed yet
+        uint32_t room  = p->size - (s->written - p->tail);
+        uint32_t chunk = (n < room) ? n : room;
+        uint32_t at    = s->written & p->mask;
+        uint32_t first = p->size - at;
+
+        if (first >= chunk) {
+            memcpy(s->ring + at, bytes, chunk);
+        } else {
+            memcpy(s->ring + at, bytes, first);
+            memcpy(s->ring, bytes + first, chunk - first);
+        }
+        s->written += chunk;
+        bytes      += chunk;
+        n          -= chunk;
+
+        while (sync_parser_poll_desc(p, s->written, &d)) {
+            bool ok = sync_parser_commit(p, &d, s->crc ? s->crc(s->ring, p->mask, &d) : true);
+            const uint8_t* payload = s->ring + (d.pos & p->mask);
+            if ((d.pos & p->mask) + d.length > p->size) {
+                sync_ring_copy(p, d.pos, s->scratch, d.length);
+                payload = s->scratch;
+            }
+            if (on_frame) on_frame(user, &d, payload, ok);
+            frames++;
+        }
+    }
+    return frames;
+}
+
+#endif
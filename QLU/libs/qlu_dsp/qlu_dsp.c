@@ -0,0 +1,132 @@
+/* qlu_dsp.c
+   libqlu_dsp: the firmware metrics engine (includes/qlu_metrics.h) behind
+   the plain C API in qlu_dsp.h
+   - one handle per stream: demod state, metrics engine and a partial block
+   - blocks make the calls StreamProcessToMetricsTask makes on a locked
+     block: metrics_engine_process_block, then metrics_engine_finalize_block
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef PROCESS_BLOCK_SIZE
+#define PROCESS_BLOCK_SIZE 256
+#endif
+#include "qlu_base.h"
+#include "qlu_demod.h"
+#include "qlu_metrics.h"
+
+#include "qlu_dsp.h"
+
+struct qlu_dsp {
+    demod_t          demod;
+    metrics_engine_t metrics;
+    uint16_t         i_samples[PROCESS_BLOCK_SIZE];
+    uint16_t         q_samples[PROCESS_BLOCK_SIZE];
+    uint32_t         fill;
+    uint64_t         samples;
+    uint64_t         blocks;
+};
+
+static bool config_from_api(demod_config_t* out, const qlu_dsp_config_t* cfg){
+    if (!cfg || cfg->modulation < 0 || cfg->modulation >= MOD_NUM_MODULATIONS ||
+        !(cfg->sampling_rate_hz > 0.0) || !(cfg->link_bw_hz > 0.0) ||
+        cfg->resolution < 2 || cfg->resolution > 16) {
+        return false;
+    }
+
+    *out = (demod_config_t){
+        .link_bw_hz        = cfg->link_bw_hz,
+        .sampling_rate_hz  = cfg->sampling_rate_hz,
+        .roll_off          = cfg->roll_off,
+        .signal_resolution = (uint8_t)cfg->resolution,
+        .modulation        = (modulation_type_t)cfg->modulation,
+    };
+    config_calculate_derived(out);
+    return true;
+}
+
+static void run_block(qlu_dsp_t* h, const uint16_t* i_samples, const uint16_t* q_samples, uint32_t n){
+    metrics_engine_process_block(&h->metrics, &h->demod, i_samples, q_samples, n);
+    metrics_engine_finalize_block(&h->metrics, &h->demod, n);
+    h->blocks++;
+}
+
+QLU_DSP_API uint32_t qlu_dsp_block_size(void){
+    return PROCESS_BLOCK_SIZE;
+}
+
+QLU_DSP_API qlu_dsp_t* qlu_dsp_open(const qlu_dsp_config_t* cfg){
+    demod_config_t dcfg;
+    if (!config_from_api(&dcfg, cfg)) return NULL;
+
+    qlu_dsp_t* h = calloc(1, sizeof(*h));
+    if (!h) return NULL;
+
+    demod_init(&h->demod, dcfg);
+    metrics_engine_init(&h->metrics, &h->demod);
+    return h;
+}
+
+QLU_DSP_API void qlu_dsp_close(qlu_dsp_t* h){
+    free(h);
+}
+
+QLU_DSP_API int qlu_dsp_configure(qlu_dsp_t* h, const qlu_dsp_config_t* cfg){
+    demod_config_t dcfg;
+    if (!config_from_api(&dcfg, cfg)) return -1;
+
+    demod_cfg_update(&h->demod, dcfg);
+    metrics_engine_configure(&h->metrics, &h->demod);
+    h->demod.sym = (symbol_acc_t){0, 0, 0};
+    h->fill = 0;
+    return 0;
+}
+
+QLU_DSP_API void qlu_dsp_reset(qlu_dsp_t* h){
+    demod_reset_accumulators(&h->demod);
+    metrics_engine_reset(&h->metrics);
+    h->fill = 0;
+}
+
+QLU_DSP_API void qlu_dsp_process_block(qlu_dsp_t* h, const uint16_t* i_samples, const uint16_t* q_samples, uint32_t n){
+    if (n == 0) return;
+    if (n > PROCESS_BLOCK_SIZE) n = PROCESS_BLOCK_SIZE;
+    run_block(h, i_samples, q_samples, n);
+    h->samples += n;
+}
+
+QLU_DSP_API void qlu_dsp_feed_u16(qlu_dsp_t* h, const uint16_t* iq, uint64_t n_pairs){
+    for (uint64_t k = 0; k < n_pairs; k++) {
+        h->i_samples[h->fill] = iq[2 * k];
+        h->q_samples[h->fill] = iq[2 * k + 1];
+        if (++h->fill == PROCESS_BLOCK_SIZE) {
+            run_block(h, h->i_samples, h->q_samples, PROCESS_BLOCK_SIZE);
+            h->fill = 0;
+        }
+    }
+    h->samples += n_pairs;
+}
+
+QLU_DSP_API void qlu_dsp_read(const qlu_dsp_t* h, qlu_dsp_report_t* out){
+    *out = (qlu_dsp_report_t){
+        .snr                = h->metrics.out.snr,
+        .mer                = h->metrics.out.mer,
+        .evm                = h->metrics.out.evm,
+        .cn0                = h->metrics.out.cn0,
+        .stability          = h->metrics.out.stability,
+        .skew_score         = h->metrics.out.skew_score,
+        .sqi                = h->metrics.out.sqi,
+        .compression_db     = h->metrics.compression_db,
+        .ampm_deg           = h->metrics.ampm_deg,
+        .scale              = h->demod.scale,
+        .samples_per_symbol = h->demod.config.samples_per_symbol,
+        .symbol_rate_hz     = metrics_symbol_rate_hz(&h->demod.config),
+        .samples            = h->samples,
+        .blocks             = h->blocks,
+    };
+}
@@ -0,0 +1,97 @@
+#ifndef QLU_DSP_H
+
+#define QLU_DSP_H
+
+#include <stdint.h>
+
+// ---------------------------------------------------------------------------
+// libqlu_dsp — the QLU metrics pipeline behind a plain C API
+// ---------------------------------------------------------------------------
+//
+//   One translation unit (qlu_dsp.c) over the firmware DSP headers
+//   (includes/qlu_demod.h, qlu_metrics.h, qlu_compression.h), built as a
+//   native static/shared library on the host (CMakeLists.txt next to this
+//   file) and compile-checked with the pico toolchain. The firmware does not
+//   call it: the DSP task includes those headers itself, so both run the
+//   same source, not the same object code. No firmware types leak through
+//   this header, so ctypes, C++ or another C project can link it as is.
+//
+//   Samples are raw ADC codes (offset binary, `resolution` bits) and run in
+//   blocks of qlu_dsp_block_size() pairs, exactly as the DSP task runs them:
+//   per-sample stages, then the per-block finalize that refreshes the report.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define QLU_DSP_API __attribute__((visibility("default")))
+#else
+#define QLU_DSP_API
+#endif
+
+// Same values as modulation_type_t
+typedef enum {
+    QLU_DSP_BPSK  = 0,
+    QLU_DSP_QPSK  = 1,
+    QLU_DSP_16QAM = 2
+} qlu_dsp_modulation_t;
+
+typedef struct {
+    int32_t  modulation;           // qlu_dsp_modulation_t
+    double   sampling_rate_hz;     // rate of the samples handed in
+    double   link_bw_hz;
+    double   roll_off;
+    uint32_t resolution;           // ADC bits, 2..16
+} qlu_dsp_config_t;
+
+typedef struct {
+    double   snr;                  // dB, per sample
+    double   mer;                  // dB, at the symbol decisions
+    double   evm;                  // %
+    double   cn0;                  // dB-Hz
+    double   stability;            // 0..100
+    double   skew_score;           // 0..100
+    double   sqi;                  // 0..100
+    double   compression_db;       // 16QAM only, 0 otherwise
+    double   ampm_deg;             // 16QAM only, 0 otherwise
+    double   scale;                // ADC code -> constellation units divisor
+    double   samples_per_symbol;
+    double   symbol_rate_hz;       // integrate-and-dump rate
+    uint64_t samples;              // pairs fed since open
+    uint64_t blocks;               // blocks finalized since open
+} qlu_dsp_report_t;
+
+typedef struct qlu_dsp qlu_dsp_t;
+
+QLU_DSP_API uint32_t   qlu_dsp_block_size(void);
+
+// NULL on an invalid config or out of memory
+QLU_DSP_API qlu_dsp_t* qlu_dsp_open(const qlu_dsp_config_t* cfg);
+QLU_DSP_API void       qlu_dsp_close(qlu_dsp_t* h);
+
+// Config change in place (as a web config update): 0 on success, -1 if the
+// config is invalid and the old one was kept. A pending partial block was
+// taken under the old config and is dropped. Call qlu_dsp_reset() after a
+// modulation change, as the DSP task does.
+QLU_DSP_API int        qlu_dsp_configure(qlu_dsp_t* h, const qlu_dsp_config_t* cfg);
+
+// Same state as after a lock loss: accumulators and windows cleared, config
+// kept, pending partial block dropped
+QLU_DSP_API void       qlu_dsp_reset(qlu_dsp_t* h);
+
+// One block in the firmware layout (separate I and Q arrays), n <= block size
+QLU_DSP_API void       qlu_dsp_process_block(qlu_dsp_t* h, const uint16_t* i_samples, const uint16_t* q_samples,
+                                             uint32_t n);
+
+// Interleaved I,Q pairs of any length; a trailing partial block waits for
+// the next call
+QLU_DSP_API void       qlu_dsp_feed_u16(qlu_dsp_t* h, const uint16_t* iq, uint64_t n_pairs);
+
+QLU_DSP_API void       qlu_dsp_read(const qlu_dsp_t* h, qlu_dsp_report_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
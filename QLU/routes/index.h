@@ -43,6 +43,7 @@
   "<div class=\"ctl\"><h4>Config</h4>" \
   "<div class=\"cg\"><label>Modulation</label><select id=\"ms\"><option value=\"0\">Loading...</option></select></div>" \
   "<div class=\"cg\"><label>Roll-off</label><input type=\"number\" id=\"ro\" min=\"0\" max=\"1\" step=\"0.01\" value=\"0.25\"></div>" \
+  "<div class=\"cg\"><label>Decimation</label><select id=\"dc\"><option>1</option><option>2</option><option>4</option><option>8</option><option>16</option><option>32</option></select></div>" \
   "<div class=\"sb\" id=\"st\"><span class=\"cd cf\" id=\"cd\"></span>Connecting...</div>" \
   "</div>" \
   "<div class=\"fh\" id=\"fh\">" \
@@ -106,7 +107,7 @@
   "if(d.points)dI(d.points)" \
   "}catch(x){}}}" \
   "cS();" \
-  "const mS=$('ms'),rI=$('ro');" \
+  "const mS=$('ms'),rI=$('ro'),dS=$('dc');" \
   "let wC;" \
   "function cC(){" \
   "wC=new WebSocket('ws://'+ip+'/ws/config');" \
@@ -115,11 +116,12 @@
   "wC.onmessage=e=>{try{const d=JSON.parse(e.data);" \
   "if(d.options){mS.innerHTML='';d.options.forEach(o=>{const e=document.createElement('option');e.value=o.val;e.textContent=o.name;mS.appendChild(e)})}" \
   "if(d.modulation!=null)mS.value=d.modulation;" \
-  "if(d.roll_off!=null)rI.value=d.roll_off" \
+  "if(d.roll_off!=null)rI.value=d.roll_off;" \
+  "if(d.decimation!=null)dS.value=d.decimation" \
   "}catch(x){}}}" \
   "cC();" \
-  "function sU(){if(wC&&wC.readyState==1)wC.send(JSON.stringify({type:'UPDATE_YOURS',modulation:+mS.value,roll_off:+rI.value}))}" \
-  "mS.onchange=sU;rI.onchange=sU;" \
+  "function sU(){if(wC&&wC.readyState==1)wC.send(JSON.stringify({type:'UPDATE_YOURS',modulation:+mS.value,roll_off:+rI.value,decimation:+dS.value}))}" \
+  "mS.onchange=sU;rI.onchange=sU;dS.onchange=sU;" \
   "setInterval(()=>{if(wC&&wC.readyState==1)wC.send('CURRENT')},5e3)" \
   "</script></body></html>"
 
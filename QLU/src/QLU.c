@@ -26,6 +26,18 @@
     
     #define PROCESS_BLOCK_SIZE 256
     #include "qlu_demod.h"
+    #include "qlu_eye.h"
+    #include "qlu_compression.h"
+    #include "qlu_metrics.h"
+    #include "qlu_lock.h"
+    #include "qlu_multichannel.h"
+    #include "qlu_cic.h"
+    #include "qlu_sync.h"
+    #include "qlu_spsc.h"
+    #include "qlu_iqpack.h"
+    #include "qlu_source.h"
+    #include "qlu_impair.h"
+    #include "qlu_scenario.h"
     
     // #define SCREEN_IS_ST7735
     #define SCREEN_IS_SSD1306
@@ -50,9 +62,87 @@
     uint8_t __attribute__((aligned(DMA_BUFFER_SIZE))) rx_ring_buffer[DMA_BUFFER_SIZE];
     int dma_chan;
 
-    #define DSP_QUEUE_LENGHT 1
-    
-    QueueHandle_t xDspQueue;
+    // The data channel runs in chunks of DMA_CHUNK_SIZE bytes; at the end of
+    // each one a control channel re-arms it and DMA_IRQ_0 wakes acquisition.
+    // 64 bytes is 512 us at 1 MHz: the wait from a frame's last byte to the
+    // wake stays under half a millisecond
+    #define DMA_CHUNK_SIZE 64
+    int dma_ctrl_chan;
+    static uint32_t   dma_chunk_reload = DMA_CHUNK_SIZE;
+    volatile uint32_t dma_chunks_done  = 0;
+    volatile uint32_t dma_chunk_irq_us = 0;
+    TaskHandle_t      xAcquisitionTask = NULL;
+
+    // Frame v2 CRC: memory-to-memory channel fed through the DMA sniffer,
+    // reading the frame out of the ring into a dummy sink
+    int dma_crc_chan;
+    static uint32_t dma_crc_sink;
+
+    // Link counters, written by the acquisition task, read by the DSP task
+    typedef struct {
+        uint32_t frames;        // CRC-valid frames
+        uint32_t lost;          // sequence gaps
+        uint32_t crc_errors;
+        uint32_t bad_headers;   // marker followed by an invalid v2 header
+        uint32_t overruns;      // DMA lapped the parser or the DSP task
+        uint32_t track_hits;    // headers found at the predicted offset
+        uint32_t resyncs;       // prediction missed, full marker search
+    } link_stats_t;
+
+    volatile link_stats_t link_stats = {0};
+
+    // Acquisition -> DSP: fixed pool of blocks in static RAM; ownership of a
+    // slot is passed by index through a lock-free SPSC ring, so the DSP task
+    // works on the block in place. Power of two; bursts up to the depth are
+    // absorbed, beyond that the newest frame is dropped.
+    #define DSP_POOL_DEPTH 8
+
+    typedef struct {
+        IqBlock_t block;
+        uint32_t  t_us;       // time of the frame's last byte, for latency
+    } dsp_slot_t;
+
+    static dsp_slot_t dsp_pool[DSP_POOL_DEPTH];
+    spsc_ring_t       dsp_ring;
+    TaskHandle_t      xDspTask = NULL;
+
+    // Producer side accounting; the DSP task counts what it processed
+    // received = processed + dropped + still in the pool
+    volatile uint32_t dsp_frames_received = 0;   // offered to the pool
+    volatile uint32_t dsp_frames_dropped  = 0;   // pool full or overwritten during the copy
+
+    // A frame that will not reach the DSP task
+    static inline void dsp_drop_frame(void){
+        dsp_frames_received++;
+        dsp_frames_dropped++;
+    }
+
+    static inline int32_t dsp_claim_slot(void){
+        int32_t slot = spsc_producer_claim(&dsp_ring);
+        if (slot < 0) dsp_drop_frame();
+        return slot;
+    }
+
+    // Hands the claimed slot over and wakes the DSP task
+    static inline void dsp_publish_slot(void){
+        dsp_frames_received++;
+        spsc_producer_publish(&dsp_ring);
+        if (xDspTask != NULL) xTaskNotifyGive(xDspTask);
+    }
+
+    // DSP load over the last DSP_STATS_PERIOD_MS. margin = how many times
+    // the current input rate the DSP could sustain (capacity / input)
+    #define DSP_STATS_PERIOD_MS 1000
+
+    typedef struct {
+        uint32_t received;
+        uint32_t processed;
+        uint32_t dropped;
+        float    load_pct;          // busy time / wall time
+        float    capacity_ksps;     // input samples per busy second
+        float    margin;            // 0 when there is no input
+    } dsp_stats_t;
+
     QueueHandle_t xToScreenMetrics;
     QueueHandle_t xToWebMetrics;
     QueueHandle_t xDemodConfig;
@@ -63,6 +153,20 @@
         QLUMetrics m;
         double f_I[WEB_REF_SAMPLES_CNT];
         double f_Q[WEB_REF_SAMPLES_CNT];
+        // 16QAM amplifier compression (outer vs inner ring)
+        double compression_db;
+        double ampm_deg;
+        // Lock gate state (m holds the probe MER and SQI 0 while unlocked)
+        bool     locked;
+        uint32_t time_to_lock_ms;
+        // Last byte of the frame -> DSP start, per frame (EMA and peak since config change)
+        uint32_t acq_latency_us;
+        uint32_t acq_latency_max_us;
+        link_stats_t link;
+        dsp_stats_t  rt;
+        // Multi-carrier channels (0 when MULTI_CARRIER_MODE is off)
+        uint8_t  n_channels;
+        mc_channel_metrics_t channels[MC_MAX_CHANNELS];
     } WebMetrics;
 
     typedef enum {
@@ -77,11 +181,18 @@
         modulation_type_t mod;
         ws_client_tpcb ws_client;
         double roll_off;
+        uint16_t decimation;   // 0 = keep the current rate
     } ConfigRequest;
     
 
     QueueHandle_t xConfigRequest;
 
+    // Eye diagram: accumulated by the DSP task, snapshotted by the web task
+    #define EYE_PUBLISH_PERIOD_MS 500
+
+    eye_diagram_t     eye_diagram;
+    SemaphoreHandle_t eye_mutex = NULL;
+
 // END
 
 // QLU TEST DEFINITIONS
@@ -93,31 +204,146 @@
     #include "complex_bpsk_13.h"
     #include "complex_qam16_13.h"
     #include "complex_qpsk_13.h"
-    #define COMPLEX_IQ  complex_qam16_13
-    #define _CONCAT(a, b) a ## b
-    #define CONCAT(a, b) _CONCAT(a, b)
-    #define COMPLEX_IQ_META CONCAT(COMPLEX_IQ, _meta)
+
+    // Inputs of SPITestStreamTask, switched at runtime from /ws/config with
+    // {"SOURCE": n}; the first one is active at boot
+    typedef enum {
+        TEST_SOURCE_QAM16_13,
+        TEST_SOURCE_QPSK_13,
+        TEST_SOURCE_BPSK_13,
+        TEST_SOURCE_SYNTH,
+
+        TEST_SOURCE_COUNT
+    } test_source_id_t;
+
+    static const char* test_source_name[] = {
+        [TEST_SOURCE_QAM16_13] = "complex_qam16_13",
+        [TEST_SOURCE_QPSK_13]  = "complex_qpsk_13",
+        [TEST_SOURCE_BPSK_13]  = "complex_bpsk_13",
+        [TEST_SOURCE_SYNTH]    = "synth"
+    };
+
+    QueueHandle_t xTestSource;
+
+    // Channel impairments on the test input, replaced as a whole by
+    // {"IMPAIR": {"snr_db": 15, "cfo_hz": 2000, "phase_noise_hz": 50, "ppm": 20,
+    //             "iq_amp_db": 0.5, "iq_phase_deg": 3, "dc_i": 0.02, "dc_q": -0.01}};
+    // missing keys are off, only keys inside the IMPAIR object count
+    QueueHandle_t xTestImpair;
+
+    // Scenario script on top of those, one statement per ';' since the text
+    // travels in a JSON string: {"SCENARIO": "0 snr=24; 10 snr=8 ease; 20 snr=24; loop"}.
+    // Runs on the wall clock from the moment it arrives, "" stops it
+    #define TEST_SCENARIO_TEXT_MAX 384
+    QueueHandle_t xTestScenario;
 
 #endif
 
 // END
 
+// QLU DECIMATION DEFINITIONS
+
+// CIC rate ahead of the symbol pipeline at boot: 1 (off) or a power of two
+// up to CIC_MAX_RATE, for narrow carriers inside a wider ADC capture. The
+// /ws/config UPDATE_YOURS request changes it at runtime ("decimation").
+#define QLU_ADC_DECIMATION 1
+
+// END
+
+
+// QLU MULTI-CARRIER DEFINITIONS
+
+#define MULTI_CARRIER_MODE
+#undef MULTI_CARRIER_MODE
+
+#ifdef MULTI_CARRIER_MODE
+    // Carriers measured next to the main demod, offsets relative to the capture centre
+    const mc_channel_config_t MC_CHANNELS[] = {
+        { .offset_hz = -5e6, .decimation = 4, .link_bw_hz = 2e6, .roll_off = 0.25, .modulation = MOD_QPSK  },
+        { .offset_hz =  0.0, .decimation = 2, .link_bw_hz = 4e6, .roll_off = 0.25, .modulation = MOD_16QAM },
+        { .offset_hz = +5e6, .decimation = 4, .link_bw_hz = 2e6, .roll_off = 0.25, .modulation = MOD_QPSK  },
+    };
+    #define MC_CHANNEL_COUNT ((uint8_t)count_of(MC_CHANNELS))
+#endif
+
+// END
+
 
 // SPI STREAM HANDLING DEFINITIONS
 
-    #define SYNC_BYTE_0 0xFE
-    #define SYNC_BYTE_1 0xCA
-    #define SYNC_BYTE_2 0xFE
-    #define SYNC_BYTE_3 0xCA
+    // Frame layout and marker: qlu_sync.h
     #define PAYLOAD_SIZE (256 * 4)
 
-    typedef enum {
-        STATE_SYNC_0, // Procurando 0xFE
-        STATE_SYNC_1, // Procurando 0xCA
-        STATE_SYNC_2, // Procurando 0xFE
-        STATE_SYNC_3, // Procurando 0xCA
-        STATE_PAYLOAD // Lendo dados
-    } SyncState;
+    // Total bytes the DMA has put in rx_ring_buffer (mod 2^32): completed
+    // chunks (counted by the ISR) plus progress inside the current one. A
+    // pending IRQ with a reloaded counter is a chunk the ISR has not counted yet.
+    //
+    // The IRQ flag is read before the counter, so a chunk ending between the
+    // two reads can only be missed, never counted ahead of its bytes:
+    //   - flag set:   the uncounted chunk is complete. The counter read
+    //                 after it is 0 (not re-armed yet, no correction needed)
+    //                 or the reload counting down in the next chunk (chunks++)
+    //   - flag clear: a chunk that ends after the flag read shows a counter
+    //                 of 0 or a fresh reload. Both read as the start of the
+    //                 chunk that just ended, one chunk short
+    static inline uint32_t ring_bytes_written(void){
+        uint32_t chunks, remaining, pending;
+        do {
+            chunks    = dma_chunks_done;
+            pending   = dma_channel_get_irq0_status(dma_chan);
+            remaining = dma_hw->ch[dma_chan].transfer_count;
+        } while (chunks != dma_chunks_done);
+
+        if (pending && remaining != 0) chunks++;
+        // Counted by the ISR but not re-armed yet, or a chunk that ended
+        // after the flag was read
+        if (!pending && remaining == 0) remaining = DMA_CHUNK_SIZE;
+
+        return chunks * DMA_CHUNK_SIZE + (DMA_CHUNK_SIZE - remaining);
+    }
+
+    // Time the DMA wrote stream position `pos`: the last chunk IRQ marks a
+    // known position, the bytes between the two are timed at the SPI rate.
+    // Also right for a frame that ended after that IRQ (idle timeout path).
+    static inline uint32_t ring_pos_time_us(uint32_t pos){
+        uint32_t chunks, irq_us;
+        do {
+            chunks = dma_chunks_done;
+            irq_us = dma_chunk_irq_us;
+        } while (chunks != dma_chunks_done);
+
+        int32_t bytes_after = (int32_t)(chunks * DMA_CHUNK_SIZE - pos);
+        int32_t us_after    = (int32_t)(((int64_t)bytes_after * 8 * 1000000) / SPI_PORT_FREQUENCY);
+        return irq_us - (uint32_t)us_after;
+    }
+
+    // Frame v2 formats accepted downstream: any packing, one full block
+    static inline bool frame_fmt_accepted(const frame_desc_t* d){
+        return iq_format_supported(d->fmt) &&
+               d->length == iq_payload_bytes(SYNC_FMT_FORMAT(d->fmt), PROCESS_BLOCK_SIZE);
+    }
+
+    // Unpacks block_size pairs in the wire format `fmt` into 16-bit samples;
+    // the kernel is picked once per block
+    void Iq_from_payload_block(const uint8_t* payload_buf, IqBlock_t* iq_buf, size_t block_size, uint8_t fmt){
+        iq_unpack_kernels[SYNC_FMT_FORMAT(fmt)](payload_buf, iq_buf->i_samples, iq_buf->q_samples, block_size);
+    }
+
+    // Unpacks a payload straight from the DMA ring; only a payload split by
+    // the wrap is first stitched together in a scratch buffer
+    static inline void Iq_from_ring_frame(const frame_desc_t* d, IqBlock_t* iq_buf){
+        static uint8_t wrap_scratch[PAYLOAD_SIZE];
+        const uint32_t from = d->pos & (DMA_BUFFER_SIZE - 1u);
+        const uint32_t first = DMA_BUFFER_SIZE - from;
+        const uint8_t* src = rx_ring_buffer + from;
+
+        if (first < d->length) {
+            memcpy(wrap_scratch, rx_ring_buffer + from, first);
+            memcpy(wrap_scratch + first, rx_ring_buffer, d->length - first);
+            src = wrap_scratch;
+        }
+        Iq_from_payload_block(src, iq_buf, PROCESS_BLOCK_SIZE, d->fmt);
+    }
 
 // END
 
@@ -248,17 +474,73 @@ void setup_spi_dma() {
     // 12 bits -> 4096 bytes (2^12)
     channel_config_set_ring(&c, true, 12); 
 
+    // Canal de controle: ao fim de cada chunk reescreve o contador do canal
+    // de dados (al1_transfer_count_trig), que reinicia sem intervenção da CPU
+    dma_ctrl_chan = dma_claim_unused_channel(true);
+    dma_channel_config cc = dma_channel_get_default_config(dma_ctrl_chan);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, false);
+    channel_config_set_write_increment(&cc, false);
+
+    dma_channel_configure(
+        dma_ctrl_chan,
+        &cc,
+        &dma_hw->ch[dma_chan].al1_transfer_count_trig,
+        &dma_chunk_reload,
+        1,
+        false
+    );
+
+    channel_config_set_chain_to(&c, dma_ctrl_chan);
+
     dma_channel_configure(
         dma_chan,
         &c,
         rx_ring_buffer,        
         &spi_get_hw(SPI_PORT)->dr, 
-        0xFFFFFFFF,            // Número de transferências (infinito/max)
-        true                   // Iniciar imediatamente
+        DMA_CHUNK_SIZE,        // Um chunk; o canal de controle rearma
+        false                  // Iniciado pela task de aquisição
     );
 
-    printf("[INFO] DMA canal %d configurado e iniciado\n", dma_chan);
-    printf("[INFO] Ring buffer: 4096 bytes em 0x%08X\n", (uint32_t)rx_ring_buffer);
+    // IRQ por chunk; o NVIC é habilitado no core da task de aquisição
+    dma_channel_set_irq0_enabled(dma_chan, true);
+
+    printf("[INFO] DMA canal %d (controle %d) configurado, chunk %d bytes\n", dma_chan, dma_ctrl_chan, DMA_CHUNK_SIZE);
+    printf("[INFO] Ring buffer: 4096 bytes em %p\n", (void*)rx_ring_buffer);
+}
+
+// CRC-32 (zlib) do frame v2 calculado pelo sniffer do DMA: o canal lê o
+// ring (wrap de 12 bits, como o canal do SPI) e escreve num registrador
+// descartável, a CPU não toca nos bytes
+void setup_crc_dma() {
+    dma_crc_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(dma_crc_chan);
+
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_FORCE);
+    channel_config_set_ring(&c, false, 12);
+    channel_config_set_sniff_enable(&c, true);
+
+    dma_channel_configure(dma_crc_chan, &c, &dma_crc_sink, rx_ring_buffer, 0, false);
+
+    // CRC32R = entrada refletida; saída invertida e refletida = zlib
+    dma_sniffer_enable(dma_crc_chan, DMA_SNIFF_CTRL_CALC_VALUE_CRC32R, true);
+    dma_sniffer_set_output_reverse_enabled(true);
+    dma_sniffer_set_output_invert_enabled(true);
+
+    printf("[INFO] DMA canal %d configurado para CRC-32 dos frames\n", dma_crc_chan);
+}
+
+// Sniffer over crc_len ring bytes; ~1 byte per system clock, no CPU loads
+static bool frame_crc_ok(const frame_desc_t* d){
+    dma_sniffer_set_data_accumulator(0xFFFFFFFFu);
+    dma_channel_transfer_from_buffer_now(dma_crc_chan,
+                                         rx_ring_buffer + (d->crc_pos & (DMA_BUFFER_SIZE - 1u)),
+                                         d->crc_len);
+    dma_channel_wait_for_finish_blocking(dma_crc_chan);
+    return dma_sniffer_get_data_accumulator() == d->crc;
 }
 
 void peripherals_setup(void){
@@ -275,6 +557,8 @@ void peripherals_setup(void){
     
     setup_spi_dma();
 
+    setup_crc_dma();
+
     setup_cyw43_network();
 
     printf("[INFO] Device IP: %s\n", ip4addr_ntoa(&cyw43_ip));
@@ -287,16 +571,37 @@ void peripherals_setup(void){
 // 0.20 = Resposta rápida, menos estável
 #define EMA_ALPHA 0.1
 
+// Longest sleep without a new block (config changes are picked up meanwhile)
+#define DSP_IDLE_TIMEOUT_MS 20
+
 void StreamProcessToMetricsTask(void* params){
-    static IqBlock_t  rxBlock;
+    static IqBlock_t  cicBlock;
+    IqBlock_t*        rxBlock  = NULL;
+    IqBlock_t*        dspBlock = NULL;
+    int32_t           rxSlot   = -1;
+    double            acq_latency_ema = 0.0;
+    uint32_t          rxStart_us = 0;
+    uint32_t          drain_budget = DSP_POOL_DEPTH;
+
+    // Realtime accounting: totals plus the values at the window start
+    uint32_t processed       = 0;
+    uint32_t busy_us         = 0;
+    uint32_t stats_start_us  = time_us_32();
+    uint32_t stats_received  = 0;
+    uint32_t stats_processed = 0;
+    uint32_t stats_busy_us   = 0;
+
     static QLUMetrics local_qlu_metrics = {0};
     static WebMetrics local_web_metrics = {0};
     
     demod_t demod;
 
+    xDspTask = xTaskGetCurrentTaskHandle();
+
     demod_config_t cfg = {
         .link_bw_hz = 10e6,
         .sampling_rate_hz = 20e6,
+        .decimation = QLU_ADC_DECIMATION,
         .roll_off = 0.25,
         .signal_resolution = 16,
         .modulation = MOD_16QAM
@@ -308,302 +613,218 @@ void StreamProcessToMetricsTask(void* params){
     
     demod_init(&demod,cfg);
 
-    double smooth_snr = 0.0;
-    double smooth_mer = 0.0;
-    double smooth_evm = 0.0;
-    double smooth_cn0 = 0.0;
-    double smooth_stability = 100.0;
-    double smooth_skew = 100.0;
-    double smooth_sqi  = 0.0;
-
-    bool first_run = true;
-    uint32_t blocks_since_reset = 0;
-    const uint32_t RESET_EVERY_N_BLOCKS = 5;
-    const uint32_t SKEW_EVERY_N_BLOCKS  = 20;  // skew needs more samples for stability
-    uint32_t skew_blocks = 0;
-
-    double inst_mer = 0.0;
-    double inst_snr = 0.0;
-    double inst_evm = 0.0;
-    double inst_cn0 = 0.0;
-
-    float        signal_power      = 0.0f;
-    uint16_t     raw_i             = 0u;
-    uint16_t     raw_q             = 0u;
-    int32_t      halfed_i          = 0;
-    int32_t      halfed_q          = 0;
-    double       fi                = 0.0;
-    double       fq                = 0.0;
-    SlicerResult result            = {0};
-    double       rx_i              = 0.0;
-    double       rx_q              = 0.0;
-    double       error_i           = 0.0;
-    double       error_q           = 0.0;
-    double       ideal_power       = 0.0;
-    double       error_power       = 0.0;
-
-    double avg_sym_sig_power = 0.0;
-    double avg_sym_err_power = 0.0;
-    double avg_smp_sig       = 0.0;
-    double avg_smp_err       = 0.0;
-
-    // IQ imbalance accumulators (for skew measurement)
-    double sum_I_sq = 0.0;
-    double sum_Q_sq = 0.0;
-    double sum_IQ   = 0.0;
-    uint32_t iq_imb_count = 0;
-
-    // Stability: ring buffer of block powers to compute CV
-    #define STABILITY_WINDOW_CNT 16
-    double power_history[STABILITY_WINDOW_CNT];
-    uint32_t power_hist_idx = 0;
-    uint32_t power_hist_filled = 0;
-    double block_rx_power_sum = 0.0;
+    // Decimated samples are re-packed into cicBlock; the whole pipeline below
+    // then runs once per `decimation` input blocks
+    cic_decimator_t cic;
+    cic_init_from_config(&cic, &demod.config);
+
+    #ifdef MULTI_CARRIER_MODE
+        static mc_engine_t mc;
+        mc_engine_init(&mc, &cfg, MC_CHANNELS, MC_CHANNEL_COUNT);
+        local_web_metrics.n_channels = mc.n_channels;
+    #endif
+
+    // Per-sample stages and per-block finalize live in qlu_metrics.h
+    static metrics_engine_t metrics;
+    metrics_engine_init(&metrics, &demod);
+
+    // Lock gate: unlocked blocks skip metrics, reacquisition resets the EMA
+    lock_detector_t lock_det;
+    lock_detector_reset(&lock_det, demod.config.modulation, xTaskGetTickCount() * portTICK_PERIOD_MS);
+    lock_event_t lock_evt   = LOCK_EVT_NONE;
+    bool block_ready        = false;   // dspBlock holds a new block
+    bool block_locked       = false;
+    bool reset_metrics      = false;
     
     uint32_t sps_ceil = (uint32_t)ceil(demod.config.samples_per_symbol);
+
+    if (xSemaphoreTake(eye_mutex, portMAX_DELAY)){
+        eye_configure(&eye_diagram, sps_ceil, demod.config.signal_resolution);
+        xSemaphoreGive(eye_mutex);
+    }
     
     while (true)
     {
         if (xQueueReceive(xDemodConfig,&cfg,0) == pdPASS){
+            if (cic_init_from_config(&cic, &cfg) != 0) {
+                cfg.decimation = 1;   // unsupported rate, run at the ADC rate
+                cic_init_from_config(&cic, &cfg);
+            }
             config_calculate_derived(&cfg);
             demod_cfg_update(&demod, cfg);
+            metrics_engine_configure(&metrics, &demod);
 
             sps_ceil = (uint32_t)ceil(demod.config.samples_per_symbol);
 
-            // Full reset — purge all stale data from previous modulation
-            demod.sym.acc_i = 0;
-            demod.sym.acc_q = 0;
-            demod.sym.count = 0;
-            demod.sum_symbol_signal_power = 0.0;
-            demod.sum_symbol_error_power  = 0.0;
-            demod.symbol_count            = 0;
-            demod.sum_sample_signal_power = 0.0;
-            demod.sum_sample_error_power  = 0.0;
-            demod.sample_count            = 0;
-            sum_I_sq       = 0.0;
-            sum_Q_sq       = 0.0;
-            sum_IQ         = 0.0;
-            iq_imb_count   = 0;
-            block_rx_power_sum = 0.0;
-            power_hist_filled  = 0;
-            power_hist_idx     = 0;
-            blocks_since_reset = 0;
-            skew_blocks        = 0;
-            smooth_skew        = 100.0;  // reset sentinel for EMA seed
-            first_run = true;
-        }
-        
-        // FIXED: Single while with data processing AND queue sending
-        if (xQueueReceive(xDspQueue, &rxBlock, 0) == pdPASS) {
-            
-            // 1. Process the block
-            for(int k=0; k<PROCESS_BLOCK_SIZE; k++) {    
-                raw_i = rxBlock.i_samples[k];
-                raw_q = rxBlock.q_samples[k];
-                halfed_i = uint16_to_signed(raw_i,demod.config.signal_resolution);
-                halfed_q = uint16_to_signed(raw_q,demod.config.signal_resolution);
-                fi = (double)halfed_i / demod.scale;
-                fq = (double)halfed_q / demod.scale;                
-                
-                if( k % WEB_REF_SAMPLES_CNT == 0 ){
-                    local_web_metrics.f_I[(k / WEB_REF_SAMPLES_CNT) % WEB_REF_SAMPLES_CNT] = fi;
-                    local_web_metrics.f_Q[(k / WEB_REF_SAMPLES_CNT) % WEB_REF_SAMPLES_CNT] = fq;
-                }
+            // Symbol phase restarts together with the eye window
+            demod.sym = (symbol_acc_t){0, 0, 0};
+            lock_detector_reset(&lock_det, demod.config.modulation, xTaskGetTickCount() * portTICK_PERIOD_MS);
+            reset_metrics = true;
+            local_web_metrics.acq_latency_max_us = 0;
 
-                // Stability: accumulate received power (before slicer, cheap)
-                block_rx_power_sum += fi * fi + fq * fq;
+            if (xSemaphoreTake(eye_mutex, portMAX_DELAY)){
+                eye_configure(&eye_diagram, sps_ceil, demod.config.signal_resolution);
+                xSemaphoreGive(eye_mutex);
+            }
+        }
 
-                result = get_slicer_by_mod[demod.config.modulation](fi,fq);
-                demod.sum_sample_signal_power += slicer_calculate_power(result.ideal_i,result.ideal_q);
-                demod.sum_sample_error_power  += slicer_calculate_power(fi - result.ideal_i, fq - result.ideal_q);
-                demod.sample_count++;
+        // 0. Lock gate — probe the block before spending any per-sample work on it
+        // The slot stays ours until the end of the iteration, no copy is made
+        rxSlot = spsc_consumer_peek(&dsp_ring);
+        if (rxSlot >= 0) {
+            rxStart_us = time_us_32();
+            rxBlock = &dsp_pool[rxSlot].block;
+            {
+                uint32_t lat_us = time_us_32() - dsp_pool[rxSlot].t_us;
+                acq_latency_ema = (EMA_ALPHA * lat_us) + ((1.0 - EMA_ALPHA) * acq_latency_ema);
+                local_web_metrics.acq_latency_us = (uint32_t)acq_latency_ema;
+                if (lat_us > local_web_metrics.acq_latency_max_us) local_web_metrics.acq_latency_max_us = lat_us;
+            }
+            local_web_metrics.link = link_stats;
+
+            #ifdef MULTI_CARRIER_MODE
+                // Carriers are independent of the main channel lock
+                mc_engine_process_block(&mc, rxBlock);
+                if (mc_engine_block_done(&mc)) {
+                    for (uint8_t c = 0; c < mc.n_channels; c++) {
+                        local_web_metrics.channels[c] = mc.ch[c].metrics;
+                    }
+                }
+            #endif
 
-                // Skew: accumulate ERROR vector I²/Q²/IQ (after slicer)
-                // Using error vectors instead of raw signal fixes BPSK:
-                // raw I²>>Q² for BPSK even with no skew, but error_I²≈error_Q² (AWGN is isotropic)
-                {
-                    double ei = fi - result.ideal_i;
-                    double eq = fq - result.ideal_q;
-                    sum_I_sq += ei * ei;
-                    sum_Q_sq += eq * eq;
-                    sum_IQ   += ei * eq;
-                    iq_imb_count++;
+            // CIC front-end: nothing below runs until a decimated block is full
+            if (demod.config.decimation > 1 && !cic_push_block(&cic, rxBlock, &cicBlock)) {
+                block_ready  = false;
+                block_locked = false;
+            } else {
+                dspBlock = (demod.config.decimation > 1) ? &cicBlock : rxBlock;
+                block_ready = true;
+
+                lock_evt = lock_detector_update(&lock_det,
+                                                lock_probe_block(&lock_det, dspBlock, &demod),
+                                                xTaskGetTickCount() * portTICK_PERIOD_MS);
+                if (lock_evt == LOCK_EVT_ACQUIRED) reset_metrics = true;
+
+                block_locked = lock_det.locked;
+                local_web_metrics.locked          = lock_det.locked;
+                local_web_metrics.time_to_lock_ms = lock_det.time_to_lock_ms;
+
+                // Constellation reference points for the web view, locked or not
+                for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k += WEB_REF_SAMPLES_CNT) {
+                    uint32_t ref = (k / WEB_REF_SAMPLES_CNT) % WEB_REF_SAMPLES_CNT;
+                    metrics_convert(&demod, dspBlock->i_samples[k], dspBlock->q_samples[k],
+                                    &local_web_metrics.f_I[ref], &local_web_metrics.f_Q[ref]);
                 }
 
-                demod.sym.acc_i += fi;
-                demod.sym.acc_q += fq;
-                demod.sym.count++;
-                
-                if (demod.sym.count >= sps_ceil){
-                    rx_i = demod.sym.acc_i / (double)demod.sym.count;
-                    rx_q = demod.sym.acc_q / (double)demod.sym.count;
-                    result = get_slicer_by_mod[demod.config.modulation](rx_i,rx_q);
-                    
-                    demod.sum_symbol_signal_power += slicer_calculate_power(result.ideal_i,result.ideal_q);
-                    demod.sum_symbol_error_power += slicer_calculate_power(rx_i - result.ideal_i, rx_q - result.ideal_q);
-                    demod.symbol_count++;
-
-                    demod.sym.acc_i = 0.0;
-                    demod.sym.acc_q = 0.0;
-                    demod.sym.count = 0;            
-                }   
+                if (!block_locked) {
+                    // Degraded state instead of the last locked values: the
+                    // probe MER with the configured slicer and SQI 0
+                    double mer_db = lock_det.last_probe_mer_db;
+                    local_qlu_metrics = (QLUMetrics){
+                        .snr = mer_db,
+                        .mer = mer_db,
+                        .evm = pow(10.0, -mer_db / 20.0),
+                    };
+                    local_web_metrics.m              = local_qlu_metrics;
+                    local_web_metrics.compression_db = 0.0;
+                    local_web_metrics.ampm_deg       = 0.0;
+                    xQueueOverwrite(xToScreenMetrics, &local_qlu_metrics);
+                    xQueueOverwrite(xToWebMetrics, &local_web_metrics);
+                }
             }
+        } else {
+            block_ready  = false;
+            block_locked = false;
+        }
 
-            // 2. Calculate instantaneous metrics
-            avg_sym_sig_power = (demod.symbol_count > 0) ? (demod.sum_symbol_signal_power / demod.symbol_count) : 0.0;
-            avg_sym_err_power = (demod.symbol_count > 0) ? (demod.sum_symbol_error_power / demod.symbol_count) : 0.0;
-            
-            avg_smp_sig = (demod.sample_count > 0) ? (demod.sum_sample_signal_power / demod.sample_count) : 0.0;
-            avg_smp_err = (demod.sample_count > 0) ? (demod.sum_sample_error_power / demod.sample_count) : 0.0;
-
-            if (avg_sym_err_power > 0.000001 && avg_sym_sig_power > 0.000001) {
-                inst_mer = 10.0 * log10(avg_sym_sig_power / avg_sym_err_power);
-                // inst_evm = sqrt(avg_sym_err_power / avg_sym_sig_power) * 100.0;
-                inst_evm = sqrt(avg_smp_err / avg_smp_sig) * 100.0;
-            } else {
-                inst_mer = 0.0;
-                inst_evm = 0.0;
+        if (block_locked && reset_metrics) {
+            // Full reset — purge all stale data (new modulation or lock reacquired)
+            demod_reset_accumulators(&demod);
+            metrics_engine_reset(&metrics);
+            // Symbol accumulator restarted, keep the eye aligned
+            if (xSemaphoreTake(eye_mutex, portMAX_DELAY)){
+                eye_diagram.phase = 0;
+                xSemaphoreGive(eye_mutex);
             }
-            
-            if (avg_smp_err > 0.000001) {
-                inst_snr = 10.0 * log10(avg_smp_sig / avg_smp_err);
-            } else {
-                inst_snr = 0.0;
+            reset_metrics = false;
+        }
+        
+        // 1. Eye density on the raw samples, locked or not: it is the view
+        //    left while the link is down. The only part under the mutex
+        if (block_ready) {
+            xSemaphoreTake(eye_mutex, portMAX_DELAY);
+            for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++) {
+                eye_accumulate(&eye_diagram, dspBlock->i_samples[k], dspBlock->q_samples[k]);
             }
+            eye_block_done(&eye_diagram, PROCESS_BLOCK_SIZE);
+            xSemaphoreGive(eye_mutex);
+        }
 
-            // inst_cn0 = inst_mer + 10.0 * log10(demod.config.symbol_rate_hz);
-            inst_cn0 = inst_snr + 10.0 * log10(demod.config.symbol_rate_hz);
+        if (block_locked) {
 
-            // 2b. Stability: store block power (cheap — just an array write)
-            {
-                double block_avg_power = block_rx_power_sum / PROCESS_BLOCK_SIZE;
-                power_history[power_hist_idx] = block_avg_power;
-                power_hist_idx = (power_hist_idx + 1) % STABILITY_WINDOW_CNT;
-                if (power_hist_filled < STABILITY_WINDOW_CNT) power_hist_filled++;
-                block_rx_power_sum = 0.0;
-            }
+            // 2. Convert, slice, skew sums and symbol accumulation in one pass
+            metrics_engine_process_block(&metrics, &demod, dspBlock->i_samples, dspBlock->q_samples, PROCESS_BLOCK_SIZE);
 
-            // EMA for MER/EVM/SNR/CN0 every block (cheap, no transcendentals beyond the existing log10/sqrt above)
-            if (first_run) {
-                smooth_mer = inst_mer;
-                smooth_snr = inst_snr;
-                smooth_evm = inst_evm;
-                smooth_cn0 = inst_cn0;
-                first_run = false;
-            } else {
-                smooth_mer = (EMA_ALPHA * inst_mer) + ((1.0 - EMA_ALPHA) * smooth_mer);
-                smooth_snr = (EMA_ALPHA * inst_snr) + ((1.0 - EMA_ALPHA) * smooth_snr);
-                smooth_evm = (EMA_ALPHA * inst_evm) + ((1.0 - EMA_ALPHA) * smooth_evm);
-                smooth_cn0 = (EMA_ALPHA * inst_cn0) + ((1.0 - EMA_ALPHA) * smooth_cn0);
-            }
+            // 3. Instantaneous metrics, EMA, stability, skew, compression, SQI
+            metrics_engine_finalize_block(&metrics, &demod, PROCESS_BLOCK_SIZE);
 
-            // 2c. MER/EVM accumulators reset every N blocks
-            blocks_since_reset++;
-            if (blocks_since_reset >= RESET_EVERY_N_BLOCKS) {
-                // Stability from power history CV (sqrt)
-                if (power_hist_filled >= 2) {
-                    double sum_p = 0.0, sum_p2 = 0.0;
-                    for (uint32_t w = 0; w < power_hist_filled; w++) {
-                        sum_p  += power_history[w];
-                        sum_p2 += power_history[w] * power_history[w];
-                    }
-                    double mean_p = sum_p / power_hist_filled;
-                    double var_p  = (sum_p2 / power_hist_filled) - (mean_p * mean_p);
-                    if (var_p < 0.0) var_p = 0.0;
-                    double cv = sqrt(var_p) / (mean_p + 1e-12);
-                    const double CV_CEILING = 0.30;
-                    smooth_stability = (1.0 - cv / CV_CEILING) * 100.0;
-                    if (smooth_stability < 0.0)   smooth_stability = 0.0;
-                    if (smooth_stability > 100.0)  smooth_stability = 100.0;
-                }
+            // 4. Update metrics structure
+            local_qlu_metrics = metrics.out;
+            local_web_metrics.m = metrics.out;
+            local_web_metrics.compression_db = metrics.compression_db;
+            local_web_metrics.ampm_deg       = metrics.ampm_deg;
 
-                // Reset MER/EVM accumulators (short window)
-                demod.sum_symbol_signal_power = 0.0;
-                demod.sum_symbol_error_power  = 0.0;
-                demod.symbol_count            = 0;
-                demod.sum_sample_signal_power = 0.0;
-                demod.sum_sample_error_power  = 0.0;
-                demod.sample_count            = 0;
-                blocks_since_reset            = 0;
-            }
-
-            // 2d. Skew — longer accumulation window (20 blocks = ~5120 samples)
-            //     More samples → stable pwr_I/pwr_Q ratio, especially at high SNR
-            skew_blocks++;
-            if (skew_blocks >= SKEW_EVERY_N_BLOCKS && iq_imb_count > 0) {
-                double pwr_I = sum_I_sq / iq_imb_count;
-                double pwr_Q = sum_Q_sq / iq_imb_count;
-                double cross = sum_IQ   / iq_imb_count;
-
-                double amp_imb_db = 10.0 * log10((pwr_I + 1e-12) / (pwr_Q + 1e-12));
-                double denom_skew = sqrt(pwr_I * pwr_Q) + 1e-12;
-                double arg   = 2.0 * cross / denom_skew;
-                if (arg >  1.0) arg =  1.0;
-                if (arg < -1.0) arg = -1.0;
-                double phase_imb_deg = asin(arg) * (180.0 / M_PI);
-                double inst_skew = calculate_skew_score(amp_imb_db, phase_imb_deg);
-
-                // EMA smooth skew like other metrics
-                if (smooth_skew >= 99.9) {
-                    smooth_skew = inst_skew;  // first measurement
-                } else {
-                    smooth_skew = (EMA_ALPHA * inst_skew) + ((1.0 - EMA_ALPHA) * smooth_skew);
-                }
+            xQueueOverwrite(xToScreenMetrics, &local_qlu_metrics);
+            xQueueOverwrite(xToWebMetrics, &local_web_metrics);
+        }
 
-                // Decay accumulators instead of hard reset (keeps history, reduces variance)
-                const double DECAY = 0.3;  // keep 30% of old accumulation
-                sum_I_sq     *= DECAY;
-                sum_Q_sq     *= DECAY;
-                sum_IQ       *= DECAY;
-                iq_imb_count  = (uint32_t)(iq_imb_count * DECAY);
-                skew_blocks   = 0;
-            }
+        if (rxSlot >= 0) {
+            spsc_consumer_release(&dsp_ring);
+            rxSlot = -1;
+            busy_us += time_us_32() - rxStart_us;
+            processed++;
+            drain_budget--;
+        }
 
-            // 2e. SQI from latest smoothed values (cheap — just multiplies and adds)
-            {
-                double mer_n = normalize_mer(smooth_mer, demod.config.modulation);
-                double cn0_n = normalize_cn0(smooth_cn0);
-                smooth_sqi = calculate_sqi(mer_n, cn0_n, smooth_skew, smooth_stability);
+        {
+            uint32_t now_us = time_us_32();
+            uint32_t window_us = now_us - stats_start_us;
+            if (window_us >= DSP_STATS_PERIOD_MS * 1000u) {
+                uint32_t received = dsp_frames_received;
+                uint32_t rx_win   = received - stats_received;
+                uint32_t proc_win = processed - stats_processed;
+                uint32_t busy_win = busy_us - stats_busy_us;
+
+                dsp_stats_t* rt = &local_web_metrics.rt;
+                rt->received      = received;
+                rt->processed     = processed;
+                rt->dropped       = dsp_frames_dropped;
+                rt->load_pct      = 100.0f * (float)busy_win / (float)window_us;
+                rt->capacity_ksps = (busy_win > 0) ? (float)proc_win * PROCESS_BLOCK_SIZE * 1e3f / (float)busy_win : 0.0f;
+                rt->margin        = (rx_win > 0 && busy_win > 0) ? ((float)proc_win / (float)busy_win) / ((float)rx_win / (float)window_us) : 0.0f;
+
+                stats_start_us  = now_us;
+                stats_received  = received;
+                stats_processed = processed;
+                stats_busy_us   = busy_us;
             }
+        }
 
-            // 3. Update metrics structure
-            local_qlu_metrics.snr = smooth_snr;
-            local_qlu_metrics.mer = smooth_snr;
-            local_qlu_metrics.evm = smooth_evm;
-            local_qlu_metrics.cn0 = smooth_cn0;
-            local_qlu_metrics.stability  = smooth_stability;
-            local_qlu_metrics.skew_score = smooth_skew;
-            local_qlu_metrics.sqi        = smooth_sqi;
-
-            local_web_metrics.m.snr = smooth_snr;
-            local_web_metrics.m.mer = smooth_snr;
-            local_web_metrics.m.evm = smooth_evm;
-            local_web_metrics.m.cn0 = smooth_cn0;
-            local_web_metrics.m.stability  = smooth_stability;
-            local_web_metrics.m.skew_score = smooth_skew;
-            local_web_metrics.m.sqi        = smooth_sqi;
-
-            // 4. SEND TO QUEUES (NOW INSIDE THE LOOP!)
-            
-            xQueueOverwrite(xToScreenMetrics, &local_qlu_metrics);
-            xQueueOverwrite(xToWebMetrics, &local_web_metrics);
-            
-            // #if (DSP_QUEUE_LENGHT == 1)
-            //     xQueueOverwrite(xToScreenMetrics, &local_qlu_metrics);
-            //     xQueueOverwrite(xToWebMetrics, &local_qlu_metrics);
-            // #else
-            //     xQueueSend(xToScreenMetrics, &local_qlu_metrics, 0);
-            //     xQueueSend(xToWebMetrics, &local_qlu_metrics, 0);
-            // #endif
+        // Drain every pending block; sleep only when the pool is empty. A
+        // full pool's worth in a row yields one tick so the lower priority
+        // web and screen tasks still run when the DSP cannot keep up.
+        if (spsc_pending(&dsp_ring) == 0) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(DSP_IDLE_TIMEOUT_MS));
+            drain_budget = DSP_POOL_DEPTH;
+        } else if (drain_budget == 0) {
+            vTaskDelay(1);
+            drain_budget = DSP_POOL_DEPTH;
         }
-        
-        // Small delay to prevent starving other tasks
-        vTaskDelay(pdMS_TO_TICKS(1));
     }
 }
 
 
-#define WS_JSON_BUF_SIZE 768
+#define WS_JSON_BUF_SIZE 1536  // below WS_BUFFER_SIZE (2048)
 
 void WebMetricsTojson(char* json_buffer, WebMetrics* metrics, size_t* json_lenght) {
     const char* grade = sqi_to_grade(metrics->m.sqi);
@@ -611,9 +832,22 @@ void WebMetricsTojson(char* json_buffer, WebMetrics* metrics, size_t* json_lengh
     int offset = snprintf(json_buffer, WS_JSON_BUF_SIZE,
         "{\"snr\":%.2f,\"mer\":%.2f,\"evm\":%.2f,\"cn0\":%.2f,"
         "\"stability\":%.1f,\"skew\":%.1f,\"sqi\":%.1f,\"grade\":\"%s\","
+        "\"comp_db\":%.2f,\"ampm\":%.2f,"
+        "\"locked\":%s,\"ttl_ms\":%u,"
+        "\"lat_us\":%u,\"lat_max_us\":%u,"
+        "\"link\":{\"frames\":%u,\"lost\":%u,\"crc_err\":%u,\"bad_hdr\":%u,\"overruns\":%u,\"fast\":%u,\"resync\":%u},"
+        "\"rt\":{\"rx\":%u,\"proc\":%u,\"drop\":%u,\"load\":%.1f,\"cap_ksps\":%.1f,\"margin\":%.2f},"
         "\"points\":[",
         metrics->m.snr, metrics->m.mer, metrics->m.evm, metrics->m.cn0,
-        metrics->m.stability, metrics->m.skew_score, metrics->m.sqi, grade);
+        metrics->m.stability, metrics->m.skew_score, metrics->m.sqi, grade,
+        metrics->compression_db, metrics->ampm_deg,
+        metrics->locked ? "true" : "false", metrics->time_to_lock_ms,
+        metrics->acq_latency_us, metrics->acq_latency_max_us,
+        metrics->link.frames, metrics->link.lost, metrics->link.crc_errors,
+        metrics->link.bad_headers, metrics->link.overruns,
+        metrics->link.track_hits, metrics->link.resyncs,
+        metrics->rt.received, metrics->rt.processed, metrics->rt.dropped,
+        metrics->rt.load_pct, metrics->rt.capacity_ksps, metrics->rt.margin);
 
     for (uint32_t i = 0; i < WEB_REF_SAMPLES_CNT; i++) {
         int written = snprintf(json_buffer + offset, WS_JSON_BUF_SIZE - offset,
@@ -627,6 +861,21 @@ void WebMetricsTojson(char* json_buffer, WebMetrics* metrics, size_t* json_lengh
         if (offset >= (WS_JSON_BUF_SIZE - 2)) break;
     }
 
+    offset += snprintf(json_buffer + offset, WS_JSON_BUF_SIZE - offset, "],\"channels\":[");
+
+    #ifdef MULTI_CARRIER_MODE
+        for (uint8_t c = 0; c < metrics->n_channels && offset < (WS_JSON_BUF_SIZE - 2); c++) {
+            offset += snprintf(json_buffer + offset, WS_JSON_BUF_SIZE - offset,
+                "{\"f_khz\":%.1f,\"mod\":\"%s\",\"mer\":%.2f,\"snr\":%.2f,\"evm\":%.2f}%s",
+                MC_CHANNELS[c].offset_hz / 1e3,
+                get_modulation_name[MC_CHANNELS[c].modulation],
+                metrics->channels[c].mer,
+                metrics->channels[c].snr,
+                metrics->channels[c].evm,
+                (c < metrics->n_channels - 1) ? "," : "");
+        }
+    #endif
+
     int final_bits = snprintf(json_buffer + offset, WS_JSON_BUF_SIZE - offset, "]}");
     offset += final_bits;
 
@@ -651,6 +900,37 @@ void WebStreamMetricsTask(void* parameters){
     }   
 };
 
+void WebStreamEyeTask(void* parameters){
+    static uint8_t eye_frame[EYE_FRAME_MAX_SIZE];
+    size_t eye_frame_lenght = 0;
+
+    for(;;){
+        // Snapshot under the eye mutex so the DSP task is only blocked for the copy
+        if (xSemaphoreTake(eye_mutex, portMAX_DELAY)){
+            eye_frame_lenght = eye_diagram_to_frame(&eye_diagram, eye_frame, sizeof(eye_frame));
+            xSemaphoreGive(eye_mutex);
+        }
+
+        if (eye_frame_lenght > 0 && xSemaphoreTake(lwip_mutex, portMAX_DELAY)){
+            ws_send_to_all_clients("/ws/eye", WS_OP_BIN, eye_frame, eye_frame_lenght);
+            xSemaphoreGive(lwip_mutex);
+        }
+        vTaskDelay(pdMS_TO_TICKS(EYE_PUBLISH_PERIOD_MS));
+    }
+};
+
+#ifdef DEMOD_TEST
+// Number after `key` when the key lies inside [obj, end)
+static bool json_number_in(const char* obj, const char* end, const char* key, float* out){
+    const char* k = strstr(obj, key);
+    if (!k || k >= end) return false;
+    const char* colon = strchr(k, ':');
+    if (!colon || colon >= end) return false;
+    *out = (float)atof(colon + 1);
+    return true;
+}
+#endif
+
 static char handle_msg_buffer[512];
 void handle_text_requests(ws_client_tpcb wc, uint8_t* ws_msg, size_t ws_msg_len){
     const char* route = ws_get_client_route(wc);
@@ -705,7 +985,55 @@ void handle_text_requests(ws_client_tpcb wc, uint8_t* ws_msg, size_t ws_msg_len)
                 }
             }
 
+            req.decimation = 0;
+            char* dec_key = strstr(msg_buffer, "\"decimation\"");
+            if (dec_key) {
+                char* val_start = strchr(dec_key, ':');
+                if (val_start) {
+                    int dec = atoi(val_start + 1);
+                    if (dec > 0 && dec <= CIC_MAX_RATE) req.decimation = (uint16_t)dec;
+                }
+            }
+
+        }
+        #ifdef DEMOD_TEST
+        // Test input selection goes straight to SPITestStreamTask
+        char* src_key = strstr(msg_buffer, "\"SOURCE\"");
+        if (src_key && strchr(src_key, ':')) {
+            test_source_id_t id = (test_source_id_t)atoi(strchr(src_key, ':') + 1);
+            xQueueOverwrite(xTestSource, &id);
+        }
+
+        // Keys are looked up between the object's braces only (no nesting)
+        char* imp_key = strstr(msg_buffer, "\"IMPAIR\"");
+        char* imp_obj = imp_key ? strchr(imp_key, '{') : NULL;
+        char* imp_end = imp_obj ? strchr(imp_obj, '}') : NULL;
+        if (imp_end) {
+            qlu_impair_config_t imp = {0};
+            imp.awgn = json_number_in(imp_obj, imp_end, "\"snr_db\"", &imp.snr_db);
+            json_number_in(imp_obj, imp_end, "\"cfo_hz\"",         &imp.cfo_hz);
+            json_number_in(imp_obj, imp_end, "\"phase_noise_hz\"", &imp.phase_noise_hz);
+            json_number_in(imp_obj, imp_end, "\"ppm\"",            &imp.clock_ppm);
+            json_number_in(imp_obj, imp_end, "\"iq_amp_db\"",      &imp.iq_amp_db);
+            json_number_in(imp_obj, imp_end, "\"iq_phase_deg\"",   &imp.iq_phase_deg);
+            json_number_in(imp_obj, imp_end, "\"dc_i\"",           &imp.dc_i);
+            json_number_in(imp_obj, imp_end, "\"dc_q\"",           &imp.dc_q);
+            xQueueOverwrite(xTestImpair, &imp);
+        }
+
+        char* scn_key = strstr(msg_buffer, "\"SCENARIO\"");
+        char* scn_val = scn_key ? strchr(scn_key + 10, '"') : NULL;
+        if (scn_val) {
+            static char script[TEST_SCENARIO_TEXT_MAX];
+            char* scn_end = strchr(scn_val + 1, '"');
+            size_t len = scn_end ? (size_t)(scn_end - scn_val - 1) : 0;
+            if (len >= TEST_SCENARIO_TEXT_MAX) len = TEST_SCENARIO_TEXT_MAX - 1;
+            memcpy(script, scn_val + 1, len);
+            script[len] = '\0';
+            xQueueOverwrite(xTestScenario, script);
         }
+        #endif
+
         if (valid_request) {
             xQueueSend(xConfigRequest, &req, pdMS_TO_TICKS(10));
         }
@@ -735,6 +1063,7 @@ void WebConfigProcessTask(void* parameters){
     demod_config_t local_cfg = {
         .link_bw_hz = 10e6,
         .sampling_rate_hz = 20e6,
+        .decimation = QLU_ADC_DECIMATION,
         .roll_off = 0.25,
         .signal_resolution = 16,
         .modulation = MOD_16QAM
@@ -765,8 +1094,8 @@ void WebConfigProcessTask(void* parameters){
                     case REQUEST_CURRENT:
                         // CORREÇÃO 2: Envia 'modulation' como inteiro (%d) para casar com o value do <select>
                         ws_config_lenght = snprintf(ws_config_json, 512, 
-                                           "{\"modulation\": %d, \"roll_off\": %.2f}",
-                                           local_cfg.modulation, local_cfg.roll_off);
+                                           "{\"modulation\": %d, \"roll_off\": %.2f, \"decimation\": %u}",
+                                           local_cfg.modulation, local_cfg.roll_off, (unsigned)local_cfg.decimation);
                         
                         ws_send_message(local_cfg_request.ws_client, WS_OP_TEXT, (uint8_t*)ws_config_json, ws_config_lenght);
                         break;
@@ -775,6 +1104,11 @@ void WebConfigProcessTask(void* parameters){
                         // Atualiza estado local
                         local_cfg.modulation = local_cfg_request.mod;
                         local_cfg.roll_off   = local_cfg_request.roll_off;
+                        // CIC rates are powers of two; anything else keeps the current one
+                        if (local_cfg_request.decimation != 0 &&
+                            (local_cfg_request.decimation & (local_cfg_request.decimation - 1)) == 0) {
+                            local_cfg.decimation = local_cfg_request.decimation;
+                        }
                         
                         config_calculate_derived(&local_cfg);
                         
@@ -813,371 +1147,170 @@ void UpdateScreenTask(void* params){
     
 }
 
-void Iq_from_payload_block(uint8_t* payload_buf, IqBlock_t* iq_buf, size_t block_size){
-    for (size_t i = 0; i < block_size; i++) {
-        // ATENÇÃO: Endianness corrigido aqui (Little Endian)
-        // Buffer bruto: [LSB_I, MSB_I, LSB_Q, MSB_Q]
-        uint8_t b0 = payload_buf[i*4 + 0];
-        uint8_t b1 = payload_buf[i*4 + 1];
-        uint8_t b2 = payload_buf[i*4 + 2];
-        uint8_t b3 = payload_buf[i*4 + 3];
-
-        // Reconstrói int16
-        iq_buf->i_samples[i] = (uint16_t)((b0 << 8) | b1);
-        iq_buf->q_samples[i] = (uint16_t)((b2 << 8) | b3);
+// Chunk completed: count it, stamp it and wake the acquisition task
+static void __isr dma_chunk_isr(void){
+    dma_channel_acknowledge_irq0(dma_chan);
+    dma_chunks_done++;
+    dma_chunk_irq_us = time_us_32();
+
+    BaseType_t woken = pdFALSE;
+    if (xAcquisitionTask != NULL) {
+        vTaskNotifyGiveFromISR(xAcquisitionTask, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+#define ACQ_IDLE_TIMEOUT_MS 20
+
+// Unpacks a CRC-valid frame into the next free pool slot and publishes it.
+// The ring region is only trusted if the DMA has not lapped it by the time
+// the samples were read.
+static void acq_publish_frame(const frame_desc_t* desc, uint32_t* overruns){
+    int32_t slot = dsp_claim_slot();
+    if (slot < 0) return;   // pool full: the DSP is behind, drop the newest
+
+    dsp_slot_t* s = &dsp_pool[slot];
+    Iq_from_ring_frame(desc, &s->block);
+    if (!sync_frame_intact(desc, ring_bytes_written(), DMA_BUFFER_SIZE)) {
+        (*overruns)++;
+        dsp_drop_frame();
+        return;
     }
+    s->block.timestamp = desc->seq;
+    s->t_us            = ring_pos_time_us(desc->pos + desc->length);
+    dsp_publish_slot();
 }
 
 void SPISyncedStreamTask(void* params){
-    static uint32_t tail_index     = 0;
-    static SyncState current_state = STATE_SYNC_0;
-    static uint16_t payload_idx    = 0;
-    static uint8_t temp_payload_buffer[PAYLOAD_SIZE];
-    
-    IqBlock_t txBlock;
+    static sync_parser_t parser;
+    frame_desc_t desc;
+    uint32_t ring_overruns = 0;
+
+    // IRQ served on this core; the DMA only starts once the ISR is in place
+    // so the chunk count starts from zero with the stream
+    xAcquisitionTask = xTaskGetCurrentTaskHandle();
+    irq_set_exclusive_handler(DMA_IRQ_0, dma_chunk_isr);
+    irq_set_enabled(DMA_IRQ_0, true);
+    dma_channel_start(dma_chan);
+
+    // Frame v2: PAYLOAD_SIZE is the largest payload accepted
+    sync_parser_init(&parser, rx_ring_buffer, DMA_BUFFER_SIZE, PAYLOAD_SIZE, SYNC_FRAME_V2, ring_bytes_written());
 
     printf("[Core 1] Iniciando Sincronizacao de Frame...\n");
 
     while (true)
     {
-        uint32_t current_write_addr = (uint32_t)dma_hw->ch[dma_chan].write_addr;
-        uint32_t head_index = current_write_addr - (uint32_t)rx_ring_buffer;
-        
-        if (head_index == tail_index) {
-            vTaskDelay(1); 
-            continue;
-        }
-
-        while(tail_index != head_index) {
-            uint8_t byte = rx_ring_buffer[tail_index];
-            tail_index = (tail_index + 1) % DMA_BUFFER_SIZE;
-
-            // PROPER STATE MACHINE (like DEBUG version)
-            switch (current_state) {
-                case STATE_SYNC_0:
-                    if (byte == SYNC_BYTE_0) current_state = STATE_SYNC_1;
-                    break;
-                    
-                case STATE_SYNC_1:
-                    if (byte == SYNC_BYTE_1) current_state = STATE_SYNC_2;
-                    else current_state = STATE_SYNC_0;
-                    break;
-                    
-                case STATE_SYNC_2:
-                    if (byte == SYNC_BYTE_2) current_state = STATE_SYNC_3;
-                    else current_state = STATE_SYNC_0;
-                    break;
-                    
-                case STATE_SYNC_3:
-                    if (byte == SYNC_BYTE_3) {
-                        current_state = STATE_PAYLOAD;
-                        payload_idx = 0; // CRITICAL: Reset here!
-                    } else {
-                        current_state = STATE_SYNC_0;
-                    }
-                    break;
+        // Sleeps until a chunk lands; the timeout flushes a frame that ended
+        // inside a chunk when the stream stops
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ACQ_IDLE_TIMEOUT_MS));
 
-                case STATE_PAYLOAD:
-                    temp_payload_buffer[payload_idx++] = byte;
+        // Tracking fast path at the predicted offset, word-wise marker search
+        // after a miss; once the sniffer CRC matches the payload
+        // is unpacked from the ring straight into a pool slot
+        while (sync_parser_poll_desc(&parser, ring_bytes_written(), &desc)) {
+            if (!sync_parser_commit(&parser, &desc, frame_crc_ok(&desc))) continue;
 
-                    if (payload_idx >= PAYLOAD_SIZE) {
-                        Iq_from_payload_block(temp_payload_buffer, &txBlock, PROCESS_BLOCK_SIZE);
+            // 16, 12 or 8-bit I/Q frames of one full block are handled downstream
+            if (!frame_fmt_accepted(&desc)) continue;
 
-                        #if (DSP_QUEUE_LENGHT == 1)
-                            xQueueOverwrite(xDspQueue, &txBlock);
-                        #else
-                            xQueueSend(xDspQueue, &txBlock, 0);
-                        #endif
-
-                        current_state = STATE_SYNC_0;
-                    }
-                    break;
-            }
+            acq_publish_frame(&desc, &ring_overruns);
         }
+
+        link_stats = (link_stats_t){
+            .frames      = parser.frames - parser.crc_errors,
+            .lost        = parser.lost_frames,
+            .crc_errors  = parser.crc_errors,
+            .bad_headers = parser.bad_headers,
+            .overruns    = parser.overruns + ring_overruns,
+            .track_hits  = parser.track_hits,
+            .resyncs     = parser.resyncs,
+        };
     }
 }
 
-void SPISyncedStreamTaskOld(void* params){
-    static uint32_t tail_index = 0;
-    static SyncState current_state = STATE_SYNC_0;
-    static uint16_t payload_idx = 0;
-    static uint8_t temp_payload_buffer[PAYLOAD_SIZE]; // Buffer temporário para montar o pacote
-    
-    IqBlock_t txBlock;
-
-    printf("[Core 1] Iniciando Sincronizacao de Frame...\n");
-
-    while(true) {
-        uint32_t current_write_addr = (uint32_t)dma_hw->ch[dma_chan].write_addr;
-        uint32_t head_index = current_write_addr - (uint32_t)rx_ring_buffer;
-        
-        if (head_index == tail_index) {
-            vTaskDelay(1); 
-            continue;
-        }
-
-        // Processa byte a byte do Ring Buffer
-        while(tail_index != head_index) {
-            uint8_t byte = rx_ring_buffer[tail_index];
-            tail_index = (tail_index + 1) % DMA_BUFFER_SIZE;
-
-            switch (current_state) {
-                // --- MÁQUINA DE ESTADOS DE SINCRONIA ---
-                case STATE_SYNC_0:
-                    if (byte == SYNC_BYTE_0) current_state = STATE_SYNC_1;
-                    break;
-                case STATE_SYNC_1:
-                    if (byte == SYNC_BYTE_1) current_state = STATE_SYNC_2;
-                    else current_state = STATE_SYNC_0; // Reset se falhar
-                    break;
-                case STATE_SYNC_2:
-                    if (byte == SYNC_BYTE_2) current_state = STATE_SYNC_3;
-                    else current_state = STATE_SYNC_0;
-                    break;
-                case STATE_SYNC_3:
-                    if (byte == SYNC_BYTE_3) {
-                        current_state = STATE_PAYLOAD;
-                        payload_idx = 0; // Preparar para ler payload
-                    } else {
-                        current_state = STATE_SYNC_0;
-                    }
-                    break;
-
-                // --- ESTADO DE LEITURA DE DADOS ---
-                case STATE_PAYLOAD:
-                    temp_payload_buffer[payload_idx++] = byte;
-
-                    if (payload_idx >= PAYLOAD_SIZE) {
-                        // Pacote completo recebido! Agora processamos.
-                        
-                        for (int i = 0; i < 256; i++) {
-                            // ATENÇÃO: Endianness corrigido aqui (Little Endian)
-                            // Buffer bruto: [LSB_I, MSB_I, LSB_Q, MSB_Q]
-                            uint8_t b0 = temp_payload_buffer[i*4 + 0];
-                            uint8_t b1 = temp_payload_buffer[i*4 + 1];
-                            uint8_t b2 = temp_payload_buffer[i*4 + 2];
-                            uint8_t b3 = temp_payload_buffer[i*4 + 3];
-
-                            // Reconstrói int16
-                            txBlock.i_samples[i] = (uint16_t)((b0 << 8) | b1);
-                            txBlock.q_samples[i] = (uint16_t)((b2 << 8) | b3);
-                        }
-
-                        // Envia para a fila de DSP
-                        #if (DSP_QUEUE_LENGHT == 1)
-                            xQueueOverwrite(xDspQueue, &txBlock);
-                        #else
-                            xQueueSend(xDspQueue, &txBlock, 0);
-                        #endif
-
-                        // Volta a procurar o próximo header
-                        current_state = STATE_SYNC_0;
-                    }
-                    break;
-            }
-        }
+#ifdef DEMOD_TEST
 
-        vTaskDelay(1);
+// Opens a test input; the synthetic one runs at the boot link config
+static qlu_source_t* test_source_open(test_source_id_t id, const demod_config_t* cfg){
+    static qlu_array_source_t array;
+    static qlu_synth_source_t synth;
+
+    switch (id) {
+        case TEST_SOURCE_QPSK_13:  return qlu_array_source_init(&array, complex_qpsk_13,  complex_qpsk_13_meta.n_samples);
+        case TEST_SOURCE_BPSK_13:  return qlu_array_source_init(&array, complex_bpsk_13,  complex_bpsk_13_meta.n_samples);
+        case TEST_SOURCE_SYNTH:    return qlu_synth_source_init(&synth, cfg, 0);
+        case TEST_SOURCE_QAM16_13:
+        default:                   return qlu_array_source_init(&array, complex_qam16_13, complex_qam16_13_meta.n_samples);
     }
 }
 
-void SPISyncedStreamTask_DEBUG(void* params){
-    static uint32_t tail_index = 0;
-    static SyncState current_state = STATE_SYNC_0;
-    static uint16_t payload_idx = 0;
-    static uint8_t temp_payload_buffer[PAYLOAD_SIZE];
-    
-    IqBlock_t txBlock;
+static double test_clock_s(void){
+    return (double)time_us_64() * 1e-6;
+}
 
-    printf("[Core 1] DEBUG: Iniciando Sincronizacao de Frame...\n");
-    
-    // ═══════════════════════════════════════════════════════════
-    // VARIÁVEIS DE DEBUG
-    // ═══════════════════════════════════════════════════════════
-    uint32_t bytes_received_total = 0;
-    uint32_t last_print_time = 0;
-    uint32_t sync_attempts = 0;
-    uint8_t last_10_bytes[10] = {0};
-    uint8_t last_byte_idx = 0;
-    bool first_byte_received = false;
-    // ═══════════════════════════════════════════════════════════
+void SPITestStreamTask(void* params){
+    static qlu_impaired_source_t impaired;
+    static qlu_scenario_source_t scenario_src;
+    static qlu_scenario_t scenario;
+    static char script[TEST_SCENARIO_TEXT_MAX];
+    uint32_t seq = 0;
+    test_source_id_t id = TEST_SOURCE_QAM16_13;
+    qlu_impair_config_t imp = {0};
+    demod_config_t cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = 20e6,
+        .decimation = QLU_ADC_DECIMATION,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = MOD_16QAM
+    };
+    config_calculate_derived(&cfg);
+    imp.sample_rate_hz = (float)cfg.sampling_rate_hz;
+    imp.clock_slip     = (uint16_t)ceil(cfg.samples_per_symbol);
+    qlu_source_t* src = qlu_impaired_source_init(&impaired, test_source_open(id, &cfg), &cfg, &imp, 0x1A2B3C4Du);
+
+    printf("[Core 0] Test Acquisition Task Iniciada (%s)\n", test_source_name[id]);
 
     while(true) {
-        uint32_t current_write_addr = (uint32_t)dma_hw->ch[dma_chan].write_addr;
-        uint32_t head_index = current_write_addr - (uint32_t)rx_ring_buffer;
-        
-        // ═══════════════════════════════════════════════════════════
-        // DEBUG: Print do estado do DMA a cada segundo
-        // ═══════════════════════════════════════════════════════════
-        uint32_t now = to_ms_since_boot(get_absolute_time());
-        if (now - last_print_time >= 1000) {
-            printf("[DEBUG] DMA Status:\n");
-            printf("  Write addr: 0x%08X\n", current_write_addr);
-            printf("  Head index: %u\n", head_index);
-            printf("  Tail index: %u\n", tail_index);
-            printf("  Bytes received (total): %u\n", bytes_received_total);
-            printf("  Current state: %d\n", current_state);
-            printf("  Sync attempts: %u\n", sync_attempts);
-            
-            if (bytes_received_total > 0) {
-                printf("  Last 10 bytes: ");
-                for(int i=0; i<10; i++) {
-                    printf("%02X ", last_10_bytes[i]);
-                }
-                printf("\n");
-            } else {
-                printf("  ⚠️  NO BYTES RECEIVED YET!\n");
-                printf("  Check:\n");
-                printf("    - SPI connections (MOSI, CLK, CS, GND)\n");
-                printf("    - ESP32 is transmitting\n");
-                printf("    - DMA is configured correctly\n");
-            }
-            printf("\n");
-            last_print_time = now;
+        if (xQueueReceive(xTestSource, &id, 0) == pdPASS && id < TEST_SOURCE_COUNT) {
+            impaired.inner = test_source_open(id, &cfg);
+            printf("[TEST] Fonte: %s\n", test_source_name[id]);
         }
-        // ═══════════════════════════════════════════════════════════
-        
-        if (head_index == tail_index) {
-            vTaskDelay(pdMS_TO_TICKS(10)); // Aumentado para 10ms no debug
-            continue;
+        if (xQueueReceive(xTestImpair, &imp, 0) == pdPASS) {
+            // Phase, clock and RNG carry on from the previous settings
+            imp.sample_rate_hz = (float)cfg.sampling_rate_hz;
+            imp.clock_slip     = (uint16_t)ceil(cfg.samples_per_symbol);
+            qlu_impair_set(&impaired.imp, &imp);
+            scenario_src.fixed = imp;
+            printf("[TEST] Impair: SNR %s%.1f dB CFO %.1f Hz PN %.1f Hz %.1f ppm IQ %.2f dB / %.2f deg DC %.3f / %.3f\n",
+                   imp.awgn ? "" : "off ", imp.snr_db, imp.cfo_hz, imp.phase_noise_hz, imp.clock_ppm,
+                   imp.iq_amp_db, imp.iq_phase_deg, imp.dc_i, imp.dc_q);
         }
-
-        // Processa byte a byte do Ring Buffer
-        while(tail_index != head_index) {
-            uint8_t byte = rx_ring_buffer[tail_index];
-            tail_index = (tail_index + 1) % DMA_BUFFER_SIZE;
-            
-            // ═══════════════════════════════════════════════════════════
-            // DEBUG: Primeiro byte recebido
-            // ═══════════════════════════════════════════════════════════
-            if (!first_byte_received) {
-                printf("[DEBUG] ✓ FIRST BYTE RECEIVED: 0x%02X\n", byte);
-                printf("  SPI is working! Data is arriving.\n\n");
-                first_byte_received = true;
-            }
-            // ═══════════════════════════════════════════════════════════
-            
-            bytes_received_total++;
-            
-            // Guarda últimos 10 bytes para debug
-            last_10_bytes[last_byte_idx] = byte;
-            last_byte_idx = (last_byte_idx + 1) % 10;
-
-            switch (current_state) {
-                case STATE_SYNC_0:
-                    if (byte == SYNC_BYTE_0) {
-                        current_state = STATE_SYNC_1;
-                        sync_attempts++;
-                        // DEBUG: Possível início de sync
-                        printf("[DEBUG] Sync attempt #%u: Found 0x%02X\n", 
-                               sync_attempts, byte);
-                    }
-                    break;
-                    
-                case STATE_SYNC_1:
-                    if (byte == SYNC_BYTE_1) {
-                        current_state = STATE_SYNC_2;
-                        printf("[DEBUG]   → Found 0x%02X (2/4)\n", byte);
-                    } else {
-                        printf("[DEBUG]   ✗ Expected 0x%02X, got 0x%02X\n", 
-                               SYNC_BYTE_1, byte);
-                        current_state = STATE_SYNC_0;
-                    }
-                    break;
-                    
-                case STATE_SYNC_2:
-                    if (byte == SYNC_BYTE_2) {
-                        current_state = STATE_SYNC_3;
-                        printf("[DEBUG]   → Found 0x%02X (3/4)\n", byte);
-                    } else {
-                        printf("[DEBUG]   ✗ Expected 0x%02X, got 0x%02X\n", 
-                               SYNC_BYTE_2, byte);
-                        current_state = STATE_SYNC_0;
-                    }
-                    break;
-                    
-                case STATE_SYNC_3:
-                    if (byte == SYNC_BYTE_3) {
-                        current_state = STATE_PAYLOAD;
-                        payload_idx = 0;
-                        printf("[DEBUG]   → Found 0x%02X (4/4) ✓ SYNC LOCKED!\n", byte);
-                        printf("[DEBUG]   → Starting payload reception...\n");
-                    } else {
-                        printf("[DEBUG]   ✗ Expected 0x%02X, got 0x%02X\n", 
-                               SYNC_BYTE_3, byte);
-                        current_state = STATE_SYNC_0;
-                    }
-                    break;
-
-                case STATE_PAYLOAD:
-                    temp_payload_buffer[payload_idx++] = byte;
-
-                    if (payload_idx >= PAYLOAD_SIZE) {
-                        printf("[DEBUG] ✓ FULL PACKET RECEIVED! Processing...\n");
-                        
-                        // Processa payload
-                        for (int i = 0; i < 256; i++) {
-                            uint8_t b0 = temp_payload_buffer[i*4 + 0];
-                            uint8_t b1 = temp_payload_buffer[i*4 + 1];
-                            uint8_t b2 = temp_payload_buffer[i*4 + 2];
-                            uint8_t b3 = temp_payload_buffer[i*4 + 3];
-
-                            txBlock.i_samples[i] = (uint16_t)((b0 << 8) | b1);
-                            txBlock.q_samples[i] = (uint16_t)((b2 << 8) | b3);
-                        }
-                        
-                        // Debug: Print primeiras amostras
-                        printf("[DEBUG] First 3 I/Q pairs:\n");
-                        for(int i=0; i<3; i++) {
-                            printf("  [%d] I=%u Q=%u\n", 
-                                   i, txBlock.i_samples[i], txBlock.q_samples[i]);
-                        }
-
-                        // Envia para fila
-                        if (xQueueSend(xDspQueue, &txBlock, 0) == pdTRUE) {
-                            printf("[DEBUG] ✓ Packet sent to DSP queue!\n\n");
-                        } else {
-                            printf("[DEBUG] ✗ DSP queue full, packet dropped!\n\n");
-                        }
-
-                        current_state = STATE_SYNC_0;
-                    } else {
-                        // Print progresso a cada 256 bytes
-                        if ((payload_idx % 256) == 0) {
-                            printf("[DEBUG]   Payload progress: %u/%u bytes\n", 
-                                   payload_idx, PAYLOAD_SIZE);
-                        }
-                    }
-                    break;
+        if (xQueueReceive(xTestScenario, script, 0) == pdPASS) {
+            const char* err;
+            if (script[0] == '\0') {
+                qlu_impair_set(&impaired.imp, &imp);
+                src = &impaired.base;
+                printf("[TEST] Cenario parado\n");
+            } else if (qlu_scenario_parse(&scenario, script, &err) != 0) {
+                qlu_impair_set(&impaired.imp, &imp);
+                src = &impaired.base;
+                printf("[TEST] Cenario invalido, parado: %s\n", err);
+            } else {
+                src = qlu_scenario_source_init(&scenario_src, &impaired, &scenario, 0);
+                qlu_scenario_source_set_clock(&scenario_src, test_clock_s);
+                printf("[TEST] Cenario %s: %.1f s%s\n", scenario.name, scenario.duration, scenario.loop ? ", loop" : "");
             }
         }
-    }
-}
-
-#ifdef DEMOD_TEST
 
-void SPITestStreamTask(void* params){
-    IqBlock_t txBlock;
-    
-    printf("[Core 0] Test Acquisition Task Iniciada\n");
-    const size_t total_values = COMPLEX_IQ_META.n_samples;  // Total de valores no array
-    size_t read_index = 0U;  // Índice de leitura no array intercalado
-    
-    while(true) {
-        // Lê PROCESS_BLOCK_SIZE pares I/Q do array intercalado
-        for(size_t i = 0; i < PROCESS_BLOCK_SIZE; i++){
-            // Cada par I/Q ocupa 2 posições consecutivas
-            size_t base_idx = read_index + (2 * i);
-            txBlock.i_samples[i] = (uint16_t)(COMPLEX_IQ[(base_idx + 0) % total_values]);  // I
-            txBlock.q_samples[i] = (uint16_t)(COMPLEX_IQ[(base_idx + 1) % total_values]);  // Q
-        }
-        
-        // Avança o índice pelo número de VALORES lidos (não pares!)
-        // Lemos 256 pares = 512 valores
-        read_index = (read_index + PROCESS_BLOCK_SIZE * 2) % total_values;
-        
-        if (xQueueSend(xDspQueue, &txBlock, 0) != pdTRUE) {
-            // printf("Drop!\n"); 
+        // Preenche direto o próximo slot livre do pool
+        int32_t slot = dsp_claim_slot();
+        if (slot >= 0) {
+            dsp_slot_t* s = &dsp_pool[slot];
+            qlu_source_fill(src, s->block.i_samples, s->block.q_samples, PROCESS_BLOCK_SIZE);
+            s->block.timestamp = seq++;
+            s->t_us            = time_us_32();
+            dsp_publish_slot();
         }
         vTaskDelay(pdMS_TO_TICKS(1));
     }
@@ -1198,6 +1331,7 @@ void serverTask(void *p){
     add_http_route("/", create_index_response);
     add_http_route("/ws/stream", create_ws_only_response);
     add_http_route("/ws/config", create_ws_only_response);
+    add_http_route("/ws/eye", create_ws_only_response);
     
     add_new_schema_route("websocket", websocket_schema_upgrade);
 
@@ -1213,6 +1347,16 @@ void serverTask(void *p){
         NULL
     );
 
+    xTaskCreateAffinitySet(
+        WebStreamEyeTask,
+        "Web Stream Eye Task",
+        1024,
+        NULL,
+        4,
+        RP2040_CORE_0,
+        NULL
+    );
+
     xTaskCreateAffinitySet(
         WebConfigProcessTask,
         "Web Config Process Task",
@@ -1243,13 +1387,19 @@ int main()
     sleep_ms(2000);
         printf("[INFO] SYSTEM STARTED...\n");
 
-    xDspQueue        = xQueueCreate(DSP_QUEUE_LENGHT, sizeof(IqBlock_t));
+    spsc_init(&dsp_ring, DSP_POOL_DEPTH);
     
     xToScreenMetrics = xQueueCreate(1, sizeof(QLUMetrics));
     xToWebMetrics    = xQueueCreate(1, sizeof(WebMetrics));
     xDemodConfig     = xQueueCreate(1, sizeof(demod_config_t));
     xConfigRequest   = xQueueCreate(1, sizeof(ConfigRequest)); 
+    #ifdef DEMOD_TEST
+        xTestSource  = xQueueCreate(1, sizeof(test_source_id_t));
+        xTestImpair  = xQueueCreate(1, sizeof(qlu_impair_config_t));
+        xTestScenario = xQueueCreate(1, TEST_SCENARIO_TEXT_MAX);
+    #endif
     lwip_mutex = xSemaphoreCreateMutex();
+    eye_mutex  = xSemaphoreCreateMutex();
 
     // Core 1: Gerencia o buffer DMA e monta os pacotes para o processamento
     #ifdef DEMOD_TEST
@@ -0,0 +1,254 @@
+#ifndef IQ_FILE_H
+
+#define IQ_FILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ---------------------------------------------------------------------------
+// IQ FILE INPUT — raw interleaved captures and SigMF recordings, mmap'ed
+// ---------------------------------------------------------------------------
+//
+//   Sample formats (interleaved I, Q, little endian):
+//       u16    offset binary, as the ADC / compiled-in headers   (cu16_le)
+//       s16    two's complement                                  (ci16_le)
+//       cf32   float, already normalised to the constellation    (cf32_le)
+//
+//   SigMF: `name`, `name.sigmf-meta` or `name.sigmf-data` all open the pair;
+//   core:datatype picks the format and core:sample_rate is returned.
+//
+//   The whole file is mapped read-only with MADV_SEQUENTIAL and handed out as
+//   blocks pointing into the mapping, so nothing is copied. Pages behind the
+//   reader are released every IQ_FILE_RELEASE_BYTES to keep the resident set
+//   small on multi-GB captures.
+
+#define IQ_FILE_RELEASE_BYTES (64u << 20)
+#define IQ_FILE_PATH_MAX      1024
+
+typedef enum {
+    IQ_FILE_U16,
+    IQ_FILE_S16,
+    IQ_FILE_CF32,
+
+    IQ_FILE_NUM_FORMATS
+} iq_file_format_t;
+
+static const char* iq_file_format_name[] = {
+    [IQ_FILE_U16]  = "u16",
+    [IQ_FILE_S16]  = "s16",
+    [IQ_FILE_CF32] = "cf32"
+};
+
+static const char* iq_file_sigmf_datatype[] = {
+    [IQ_FILE_U16]  = "cu16_le",
+    [IQ_FILE_S16]  = "ci16_le",
+    [IQ_FILE_CF32] = "cf32_le"
+};
+
+// Bytes per I/Q pair
+static const uint32_t iq_file_pair_bytes[] = {
+    [IQ_FILE_U16]  = 4,
+    [IQ_FILE_S16]  = 4,
+    [IQ_FILE_CF32] = 8
+};
+
+typedef struct {
+    const uint8_t*   map;
+    size_t           size;          // bytes mapped
+    uint64_t         n_pairs;
+    uint64_t         pos;           // next pair handed out
+    size_t           released;      // bytes already given back to the kernel
+    iq_file_format_t format;
+    double           sample_rate_hz;   // 0 when the file does not say
+    int              fd;
+} iq_file_t;
+
+// Points into the mapping; valid until iq_file_close()
+typedef struct {
+    const void*      data;
+    uint32_t         n_pairs;
+    iq_file_format_t format;
+} iq_block_t;
+
+static inline bool iq_file_format_from_name(iq_file_format_t* fmt, const char* name){
+    for (int f = 0; f < IQ_FILE_NUM_FORMATS; f++) {
+        if (strcmp(iq_file_format_name[f], name) == 0 || strcmp(iq_file_sigmf_datatype[f], name) == 0) {
+            *fmt = (iq_file_format_t)f;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool iq_file_has_suffix(const char* s, const char* suffix){
+    size_t n = strlen(s), m = strlen(suffix);
+    return n >= m && strcmp(s + n - m, suffix) == 0;
+}
+
+// Value of a top-level "key": in a SigMF meta document (string or number),
+// copied into out. Enough for the core:* fields, not a JSON parser.
+static inline bool iq_file_json_field(const char* doc, const char* key, char* out, size_t out_size){
+    char quoted[64];
+    snprintf(quoted, sizeof(quoted), "\"%s\"", key);
+    const char* p = strstr(doc, quoted);
+    if (!p) return false;
+    p = strchr(p + strlen(quoted), ':');
+    if (!p) return false;
+    p++;
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+
+    size_t n = 0;
+    if (*p == '"') {
+        for (p++; *p && *p != '"' && n + 1 < out_size; p++) out[n++] = *p;
+    } else {
+        for (; *p && strchr(",}] \t\r\n", *p) == NULL && n + 1 < out_size; p++) out[n++] = *p;
+    }
+    out[n] = '\0';
+    return n > 0;
+}
+
+static inline char* iq_file_read_text(const char* path){
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* text = (len >= 0) ? malloc((size_t)len + 1) : NULL;
+    if (text) {
+        size_t got = fread(text, 1, (size_t)len, f);
+        text[got] = '\0';
+    }
+    fclose(f);
+    return text;
+}
+
+static inline int iq_file_map(iq_file_t* f, const char* path){
+    struct stat st;
+
+    f->fd = open(path, O_RDONLY);
+    if (f->fd < 0) {
+        fprintf(stderr, "[iq_file] cannot open %s\n", path);
+        return -1;
+    }
+    if (fstat(f->fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        fprintf(stderr, "[iq_file] %s is not a non-empty regular file\n", path);
+        close(f->fd);
+        return -1;
+    }
+
+    f->size = (size_t)st.st_size;
+    f->map  = mmap(NULL, f->size, PROT_READ, MAP_PRIVATE, f->fd, 0);
+    if (f->map == MAP_FAILED) {
+        fprintf(stderr, "[iq_file] mmap failed for %s\n", path);
+        f->map = NULL;
+        close(f->fd);
+        return -1;
+    }
+    madvise((void*)f->map, f->size, MADV_SEQUENTIAL);
+
+    f->n_pairs  = f->size / iq_file_pair_bytes[f->format];
+    f->pos      = 0;
+    f->released = 0;
+    return 0;
+}
+
+// Raw capture in a known format; sample_rate_hz stays 0
+static inline int iq_file_open_raw(iq_file_t* f, const char* path, iq_file_format_t format){
+    *f = (iq_file_t){0};
+    f->format = format;
+    return iq_file_map(f, path);
+}
+
+// `base` + `suffix` into a path buffer; false if it does not fit
+static inline bool iq_file_join(char* out, size_t size, const char* base, const char* suffix){
+    int n = snprintf(out, size, "%s%s", base, suffix);
+    if (n < 0 || (size_t)n >= size) {
+        fprintf(stderr, "[iq_file] path too long: %s%s\n", base, suffix);
+        return false;
+    }
+    return true;
+}
+
+static inline int iq_file_open_sigmf(iq_file_t* f, const char* path){
+    char base[IQ_FILE_PATH_MAX], meta_path[IQ_FILE_PATH_MAX], data_path[IQ_FILE_PATH_MAX], value[64];
+
+    if (!iq_file_join(base, sizeof(base), path, "")) return -1;
+    if (iq_file_has_suffix(base, ".sigmf-meta") || iq_file_has_suffix(base, ".sigmf-data")) {
+        base[strlen(base) - strlen(".sigmf-meta")] = '\0';
+    }
+    if (!iq_file_join(meta_path, sizeof(meta_path), base, ".sigmf-meta") ||
+        !iq_file_join(data_path, sizeof(data_path), base, ".sigmf-data")) return -1;
+
+    char* meta = iq_file_read_text(meta_path);
+    if (!meta) {
+        fprintf(stderr, "[iq_file] cannot read %s\n", meta_path);
+        return -1;
+    }
+
+    *f = (iq_file_t){0};
+    if (!iq_file_json_field(meta, "core:datatype", value, sizeof(value)) ||
+        !iq_file_format_from_name(&f->format, value)) {
+        fprintf(stderr, "[iq_file] %s: unsupported core:datatype (need cu16_le, ci16_le or cf32_le)\n", meta_path);
+        free(meta);
+        return -1;
+    }
+    if (iq_file_json_field(meta, "core:sample_rate", value, sizeof(value))) {
+        f->sample_rate_hz = strtod(value, NULL);
+    }
+    free(meta);
+
+    return iq_file_map(f, data_path);
+}
+
+// Picks SigMF from the file name, raw `format` otherwise
+static inline int iq_file_open(iq_file_t* f, const char* path, iq_file_format_t format){
+    char meta_path[IQ_FILE_PATH_MAX];
+    bool sigmf = iq_file_has_suffix(path, ".sigmf-meta") || iq_file_has_suffix(path, ".sigmf-data");
+
+    if (!sigmf) {
+        if (!iq_file_join(meta_path, sizeof(meta_path), path, ".sigmf-meta")) return -1;
+        sigmf = access(meta_path, R_OK) == 0;
+    }
+    return sigmf ? iq_file_open_sigmf(f, path) : iq_file_open_raw(f, path, format);
+}
+
+// Next block of at most max_pairs; false at the end of the file
+static inline bool iq_file_next_block(iq_file_t* f, iq_block_t* blk, uint32_t max_pairs){
+    if (f->pos >= f->n_pairs) return false;
+
+    uint64_t left = f->n_pairs - f->pos;
+    uint32_t pair_bytes = iq_file_pair_bytes[f->format];
+
+    blk->format  = f->format;
+    blk->n_pairs = (left < max_pairs) ? (uint32_t)left : max_pairs;
+    blk->data    = f->map + f->pos * pair_bytes;
+    f->pos      += blk->n_pairs;
+
+    // Everything before the previous block is done with
+    size_t done = (size_t)(f->pos - blk->n_pairs) * pair_bytes;
+    if (done - f->released >= IQ_FILE_RELEASE_BYTES) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t upto = done & ~(page - 1);
+        madvise((void*)(f->map + f->released), upto - f->released, MADV_DONTNEED);
+        f->released = upto;
+    }
+    return true;
+}
+
+static inline void iq_file_close(iq_file_t* f){
+    if (f->map) {
+        munmap((void*)f->map, f->size);
+        close(f->fd);
+    }
+    *f = (iq_file_t){0};
+}
+
+#endif
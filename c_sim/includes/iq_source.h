@@ -0,0 +1,283 @@
+#ifndef IQ_SOURCE_H
+
+#define IQ_SOURCE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "qlu_source.h"
+#include "iq_file.h"
+
+// ---------------------------------------------------------------------------
+// HOST SAMPLE SOURCES — files, pipes and sockets behind qlu_source_t
+// ---------------------------------------------------------------------------
+//
+//   file    iq_file.h mapping (raw u16/s16/cf32 or SigMF), optional loop
+//   fd      byte stream of raw pairs: stdin, a FIFO or a TCP connection
+//
+//   read() converts to the offset-binary words the firmware sees:
+//       u16    as is
+//       s16    + mid-scale
+//       cf32   · config_get_scale_factor() + mid-scale, clamped
+//
+//   That copy is the fallback for streams and for stages that work on ADC
+//   codes (qlu_impair.h). A file consumer that can take the capture as it
+//   is reads iq_file_source_next() instead: blocks point into the mapping,
+//   nothing is copied and cf32 stays float.
+//
+//   iq_source_open() turns a command-line spec into any of these, plus the
+//   portable array / synth sources of qlu_source.h:
+//       PATH                file (SigMF picked from the name)
+//       -                   stdin
+//       tcp://HOST:PORT     connect
+//       tcp://:PORT         listen on 127.0.0.1, take one connection
+//       synth               qlu_synth_source for the demod config
+
+#define IQ_SOURCE_FD_BUFFER (64u << 10)
+
+typedef struct {
+    uint16_t mid;
+    uint16_t max;
+    float    scale;     // cf32 only
+} iq_source_conv_t;
+
+static inline iq_source_conv_t iq_source_conv_for(const demod_config_t* cfg){
+    uint32_t max_uint = (1u << cfg->signal_resolution) - 1u;
+    return (iq_source_conv_t){
+        .mid   = (uint16_t)(max_uint / 2u),
+        .max   = (uint16_t)max_uint,
+        .scale = (float)config_get_scale_factor(cfg),
+    };
+}
+
+static inline uint16_t iq_source_code(const iq_source_conv_t* c, float v){
+    float code = (float)c->mid + v * c->scale + 0.5f;
+    if (code < 0.0f)          return 0;
+    if (code > (float)c->max) return c->max;
+    return (uint16_t)code;
+}
+
+// n pairs of interleaved `format` at src into planar offset binary
+static inline void iq_source_convert(const iq_source_conv_t* c, iq_file_format_t format, const void* src,
+                                     uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    switch (format) {
+        case IQ_FILE_U16: {
+            const uint16_t* s = src;
+            for (uint32_t k = 0; k < n; k++) { i_out[k] = s[2 * k]; q_out[k] = s[2 * k + 1]; }
+            break;
+        }
+        case IQ_FILE_S16: {
+            const int16_t* s = src;
+            for (uint32_t k = 0; k < n; k++) {
+                i_out[k] = (uint16_t)(s[2 * k]     + c->mid);
+                q_out[k] = (uint16_t)(s[2 * k + 1] + c->mid);
+            }
+            break;
+        }
+        case IQ_FILE_CF32: {
+            const float* s = src;
+            for (uint32_t k = 0; k < n; k++) {
+                i_out[k] = iq_source_code(c, s[2 * k]);
+                q_out[k] = iq_source_code(c, s[2 * k + 1]);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// ---- File -----------------------------------------------------------------
+
+typedef struct {
+    qlu_source_t     base;
+    iq_file_t        file;
+    iq_source_conv_t conv;
+    bool             loop;
+} iq_file_source_t;
+
+// Next mapped block of up to n pairs, restarting at the end when looping
+static inline bool iq_file_source_block(iq_file_source_t* s, iq_block_t* blk, uint32_t n){
+    if (iq_file_next_block(&s->file, blk, n)) return true;
+    if (!s->loop || s->file.n_pairs == 0) return false;
+    s->file.pos      = 0;
+    s->file.released = 0;
+    return iq_file_next_block(&s->file, blk, n);
+}
+
+// Zero-copy read: the block points into the mapping, counted in base.pairs
+// as a read() would be
+static inline bool iq_file_source_next(iq_file_source_t* s, iq_block_t* blk, uint32_t n){
+    if (!iq_file_source_block(s, blk, n)) return false;
+    s->base.pairs += blk->n_pairs;
+    return true;
+}
+
+static uint32_t iq_file_source_read(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    iq_file_source_t* s = (iq_file_source_t*)src;
+    iq_block_t blk;
+
+    if (!iq_file_source_block(s, &blk, n)) return 0;
+    iq_source_convert(&s->conv, blk.format, blk.data, i_out, q_out, blk.n_pairs);
+    return blk.n_pairs;
+}
+
+static void iq_file_source_close(qlu_source_t* src){
+    iq_file_close(&((iq_file_source_t*)src)->file);
+}
+
+static const qlu_source_ops_t iq_file_source_ops = {
+    .name  = "file",
+    .read  = iq_file_source_read,
+    .close = iq_file_source_close
+};
+
+static inline qlu_source_t* iq_file_source_open(iq_file_source_t* s, const char* path, iq_file_format_t format,
+                                                const demod_config_t* cfg, bool loop){
+    *s = (iq_file_source_t){ .base = { .ops = &iq_file_source_ops }, .loop = loop };
+    if (iq_file_open(&s->file, path, format) != 0) return NULL;
+    s->conv = iq_source_conv_for(cfg);
+    return &s->base;
+}
+
+// ---- Byte stream (stdin, FIFO, socket) -------------------------------------
+
+typedef struct {
+    qlu_source_t     base;
+    int              fd;
+    bool             owns_fd;
+    iq_file_format_t format;
+    iq_source_conv_t conv;
+    uint32_t         fill;          // bytes buffered, a partial pair at most carried over
+    uint8_t          buf[IQ_SOURCE_FD_BUFFER];
+} iq_fd_source_t;
+
+// One read() per call: returns what is there, blocks only when nothing is
+static uint32_t iq_fd_source_read(qlu_source_t* src, uint16_t* i_out, uint16_t* q_out, uint32_t n){
+    iq_fd_source_t* s = (iq_fd_source_t*)src;
+    uint32_t pair_bytes = iq_file_pair_bytes[s->format];
+    uint32_t want = n * pair_bytes;
+    if (want > sizeof(s->buf)) want = sizeof(s->buf) - sizeof(s->buf) % pair_bytes;
+
+    while (s->fill < pair_bytes) {
+        if (s->fd < 0) return 0;
+        ssize_t got = read(s->fd, s->buf + s->fill, want - s->fill);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return 0;             // EOF or error: the stream is done
+        s->fill += (uint32_t)got;
+    }
+
+    uint32_t pairs = s->fill / pair_bytes;
+    if (pairs > n) pairs = n;
+    iq_source_convert(&s->conv, s->format, s->buf, i_out, q_out, pairs);
+
+    uint32_t used = pairs * pair_bytes;
+    memmove(s->buf, s->buf + used, s->fill - used);
+    s->fill -= used;
+    return pairs;
+}
+
+static void iq_fd_source_close(qlu_source_t* src){
+    iq_fd_source_t* s = (iq_fd_source_t*)src;
+    if (s->owns_fd && s->fd >= 0) close(s->fd);
+    s->fd = -1;
+}
+
+static const qlu_source_ops_t iq_fd_source_ops = {
+    .name  = "stream",
+    .read  = iq_fd_source_read,
+    .close = iq_fd_source_close
+};
+
+static inline qlu_source_t* iq_fd_source_init(iq_fd_source_t* s, int fd, bool owns_fd, iq_file_format_t format,
+                                              const demod_config_t* cfg){
+    s->base    = (qlu_source_t){ .ops = &iq_fd_source_ops };
+    s->fd      = fd;
+    s->owns_fd = owns_fd;
+    s->format  = format;
+    s->conv    = iq_source_conv_for(cfg);
+    s->fill    = 0;
+    return &s->base;
+}
+
+// "HOST:PORT" connects, ":PORT" listens on loopback for one client
+static inline int iq_source_tcp_connect(const char* addr){
+    char host[256];
+    const char* colon = strrchr(addr, ':');
+    if (!colon || colon - addr >= (long)sizeof(host)) {
+        fprintf(stderr, "[iq_source] bad tcp address '%s' (HOST:PORT or :PORT)\n", addr);
+        return -1;
+    }
+    memcpy(host, addr, (size_t)(colon - addr));
+    host[colon - addr] = '\0';
+    const char* port = colon + 1;
+
+    if (host[0] == '\0') {
+        int ls = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        struct sockaddr_in sa = { .sin_family = AF_INET, .sin_port = htons((uint16_t)atoi(port)),
+                                  .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+        setsockopt(ls, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (ls < 0 || bind(ls, (struct sockaddr*)&sa, sizeof(sa)) != 0 || listen(ls, 1) != 0) {
+            fprintf(stderr, "[iq_source] cannot listen on 127.0.0.1:%s: %s\n", port, strerror(errno));
+            if (ls >= 0) close(ls);
+            return -1;
+        }
+        fprintf(stderr, "[iq_source] waiting for a sender on 127.0.0.1:%s\n", port);
+        int fd = accept(ls, NULL, NULL);
+        close(ls);
+        return fd;
+    }
+
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM }, *res, *r;
+    if (getaddrinfo(host, port, &hints, &res) != 0) {
+        fprintf(stderr, "[iq_source] cannot resolve %s\n", host);
+        return -1;
+    }
+    int fd = -1;
+    for (r = res; r && fd < 0; r = r->ai_next) {
+        fd = socket(r->ai_family, r->ai_socktype, r->ai_protocol);
+        if (fd >= 0 && connect(fd, r->ai_addr, r->ai_addrlen) != 0) { close(fd); fd = -1; }
+    }
+    freeaddrinfo(res);
+    if (fd < 0) fprintf(stderr, "[iq_source] cannot connect to %s\n", addr);
+    return fd;
+}
+
+// ---- Spec -----------------------------------------------------------------
+
+typedef union {
+    qlu_source_t       base;
+    qlu_array_source_t array;
+    qlu_synth_source_t synth;
+    iq_file_source_t   file;
+    iq_fd_source_t     fd;
+} iq_source_t;
+
+// NULL when the spec cannot be opened; the error is already printed
+static inline qlu_source_t* iq_source_open(iq_source_t* s, const char* spec, iq_file_format_t format,
+                                           const demod_config_t* cfg, bool loop){
+    if (strcmp(spec, "-") == 0) {
+        return iq_fd_source_init(&s->fd, STDIN_FILENO, false, format, cfg);
+    }
+    if (strncmp(spec, "tcp://", 6) == 0) {
+        int fd = iq_source_tcp_connect(spec + 6);
+        return (fd < 0) ? NULL : iq_fd_source_init(&s->fd, fd, true, format, cfg);
+    }
+    if (strcmp(spec, "synth") == 0) {
+        return qlu_synth_source_init(&s->synth, cfg, 0);
+    }
+    return iq_file_source_open(&s->file, spec, format, cfg, loop);
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef SCENARIO_FILE_H
+
+#define SCENARIO_FILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "qlu_scenario.h"
+
+// Scenario scripts (QLU/includes/qlu_scenario.h) from files, for the host tools
+
+#define SCENARIO_FILE_MAX (64u << 10)
+
+// false when the file cannot be read or parsed; the error is already printed
+static inline bool scenario_file_load(qlu_scenario_t* sc, const char* path){
+    static char text[SCENARIO_FILE_MAX];
+    const char* err;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    size_t len = fread(text, 1, sizeof(text) - 1, f);
+    fclose(f);
+    text[len] = '\0';
+
+    uint32_t line = qlu_scenario_parse(sc, text, &err);
+    if (line) {
+        fprintf(stderr, "%s:%u: %s\n", path, line, err);
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,196 @@
+/* cic_bench.c
+   Host check for the CIC decimator and its droop compensation
+   (QLU/includes/qlu_cic.h)
+   - passband: complex tones through cic_push_block at every rate, gain
+     against the sinc^3 · FIR model; the compensated response must stay
+     inside the least-squares ripple bounds up to the passband edge
+   - aliasing: a tone folding onto the passband must be rejected
+   - full-scale DC at the largest rate: the wrapping registers must not
+     overflow the output
+   - times cic_push_block per input block
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_cic.h"
+
+#define CIC_BENCH_RES      16
+#define CIC_BENCH_AMP      0.5       // tone amplitude, fraction of full scale
+#define CIC_BENCH_SETTLE   2         // output blocks dropped before measuring
+#define CIC_BENCH_MEASURE  8         // output blocks measured
+#define CIC_BENCH_POINTS   16        // tones across the passband
+
+static uint32_t failures = 0;
+
+static void check(const char *what, double got, double want, double tol) {
+    bool ok = fabs(got - want) <= tol;
+    printf("  %-44s %9.4f  (want %.4f ± %.4f)  %s\n", what, got, want, tol, ok ? "ok" : "FAIL");
+    if (!ok) failures++;
+}
+
+static void check_range(const char *what, double got, double lo, double hi) {
+    bool ok = got >= lo && got <= hi;
+    printf("  %-44s %9.4f  (want %.4f .. %.4f)  %s\n", what, got, lo, hi, ok ? "ok" : "FAIL");
+    if (!ok) failures++;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+// Gain of the cascade in dB at f cycles per output sample, from the taps
+// the decimator actually holds
+static double model_db(const cic_decimator_t* cic, double f) {
+    double comp = ((double)cic->comp_centre - 2.0 * cic->comp_side * cos(2.0 * M_PI * f))
+                / (double)(1 << CIC_COMP_SHIFT);
+    return 20.0 * log10(fabs(cic_droop(cic->rate, f) * comp));
+}
+
+// Complex tone at `f_in` cycles per input sample; returns the output gain in
+// dB at `f_out` cycles per output sample (the tone or its alias)
+static double tone_gain_db(cic_decimator_t* cic, double f_in, double f_out) {
+    const double mid   = (double)((1u << CIC_BENCH_RES) - 1u) / 2.0;
+    const double scale = CIC_BENCH_AMP * mid;
+    cic_reset(cic);
+
+    IqBlock_t in, out;
+    uint64_t n = 0, m = 0;
+    uint32_t blocks = 0;
+    double acc_re = 0.0, acc_im = 0.0;
+    while (blocks < CIC_BENCH_SETTLE + CIC_BENCH_MEASURE) {
+        for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++, n++) {
+            double ph = 2.0 * M_PI * fmod(f_in * (double)n, 1.0);
+            in.i_samples[k] = (uint16_t)lrint(mid + scale * cos(ph));
+            in.q_samples[k] = (uint16_t)lrint(mid + scale * sin(ph));
+        }
+        in.timestamp = (uint32_t)n;
+        if (!cic_push_block(cic, &in, &out)) continue;
+
+        for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++, m++) {
+            if (blocks < CIC_BENCH_SETTLE) continue;
+            double yi = uint16_to_signed(out.i_samples[k], CIC_BENCH_RES);
+            double yq = uint16_to_signed(out.q_samples[k], CIC_BENCH_RES);
+            double ph = 2.0 * M_PI * fmod(f_out * (double)m, 1.0);
+            acc_re += yi * cos(ph) + yq * sin(ph);
+            acc_im += yq * cos(ph) - yi * sin(ph);
+        }
+        blocks++;
+    }
+    double amp = hypot(acc_re, acc_im) / ((double)CIC_BENCH_MEASURE * PROCESS_BLOCK_SIZE);
+    return 20.0 * log10(amp / scale);
+}
+
+// Least-squares compensation ripple over [0, edge]: what the fit allows for
+// a 3-tap FIR, with margin for the Q14 taps
+static void ripple_bounds(double edge, double* lo_db, double* hi_db) {
+    if (edge <= 0.2)      { *lo_db = -0.15; *hi_db = 0.10; }
+    else if (edge <= 0.3) { *lo_db = -0.65; *hi_db = 0.30; }
+    else                  { *lo_db = -2.05; *hi_db = 0.70; }
+}
+
+static void passband_case(uint32_t rate, double edge) {
+    cic_decimator_t cic;
+    if (cic_init(&cic, rate, CIC_BENCH_RES, edge) != 0) {
+        printf("  R=%u edge %.2f: init failed  FAIL\n", rate, edge);
+        failures++;
+        return;
+    }
+    double lo_db, hi_db, g_min = 1e9, g_max = -1e9, err_max = 0.0;
+    ripple_bounds(edge, &lo_db, &hi_db);
+
+    // Tones on whole cycles per output block, up to the edge
+    for (uint32_t p = 0; p <= CIC_BENCH_POINTS; p++) {
+        double f = floor(edge * PROCESS_BLOCK_SIZE * p / CIC_BENCH_POINTS) / PROCESS_BLOCK_SIZE;
+        double g = tone_gain_db(&cic, f / rate, f);
+        double e = fabs(g - model_db(&cic, f));
+        if (g < g_min) g_min = g;
+        if (g > g_max) g_max = g;
+        if (e > err_max) err_max = e;
+    }
+
+    char what[96];
+    printf("  R=%-2u edge %.2f: a = %.4f, passband %+.3f .. %+.3f dB\n",
+           rate, edge, (double)cic.comp_side / (1 << CIC_COMP_SHIFT), g_min, g_max);
+    snprintf(what, sizeof(what), "R=%u edge %.2f gain vs model (dB)", rate, edge);
+    check(what, err_max, 0.0, 0.05);
+    snprintf(what, sizeof(what), "R=%u edge %.2f passband floor (dB)", rate, edge);
+    check_range(what, g_min, lo_db, 0.0);
+    snprintf(what, sizeof(what), "R=%u edge %.2f passband peak (dB)", rate, edge);
+    check_range(what, g_max, 0.0, hi_db);
+}
+
+// A tone at 1/R - f folds onto -f at the output
+static void alias_case(uint32_t rate) {
+    cic_decimator_t cic;
+    if (cic_init(&cic, rate, CIC_BENCH_RES, 0.3) != 0) return;
+    double f = 16.0 / PROCESS_BLOCK_SIZE;
+    double g = tone_gain_db(&cic, (1.0 - f) / rate, -f);
+    char what[96];
+    snprintf(what, sizeof(what), "R=%u alias of f=%.4f (dB)", rate, f);
+    check_range(what, g, -200.0, -50.0);
+}
+
+static void full_scale_case(void) {
+    cic_decimator_t cic;
+    if (cic_init(&cic, CIC_MAX_RATE, CIC_BENCH_RES, 0.3) != 0) return;
+    IqBlock_t in, out;
+    const uint16_t top = (uint16_t)((1u << CIC_BENCH_RES) - 1u);
+    for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++) {
+        in.i_samples[k] = top;
+        in.q_samples[k] = 0;
+    }
+    for (uint32_t b = 0; b < 3 * CIC_MAX_RATE; b++) cic_push_block(&cic, &in, &out);
+    check("full-scale DC at R=32, I code", out.i_samples[PROCESS_BLOCK_SIZE - 1], top, 1.0);
+    check("full-scale DC at R=32, Q code", out.q_samples[PROCESS_BLOCK_SIZE - 1], 0.0, 1.0);
+}
+
+static void throughput(uint32_t rate) {
+    cic_decimator_t cic;
+    if (cic_init(&cic, rate, CIC_BENCH_RES, 0.3) != 0) return;
+    IqBlock_t in, out;
+    for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++) {
+        in.i_samples[k] = (uint16_t)(32767 + (int)(8000.0 * cos(0.01 * k)));
+        in.q_samples[k] = (uint16_t)(32767 + (int)(8000.0 * sin(0.01 * k)));
+    }
+    const uint32_t runs = 200000;
+    volatile uint32_t sink = 0;
+    double t0 = now_sec();
+    for (uint32_t r = 0; r < runs; r++) sink += cic_push_block(&cic, &in, &out);
+    double dt = now_sec() - t0;
+    (void)sink;
+    printf("  R=%-2u %.0f ns/input block, %.1f Msps\n", rate, dt / runs * 1e9,
+           (double)runs * PROCESS_BLOCK_SIZE / dt / 1e6);
+}
+
+int main(void) {
+    static const uint32_t rates[] = { 2, 4, 8, 32 };
+    static const double   edges[] = { 0.2, 0.3, 0.4 };
+    const uint32_t n_rates = sizeof(rates) / sizeof(rates[0]);
+
+    printf("[cic_bench] passband, complex tones at %.2f of full scale\n", CIC_BENCH_AMP);
+    for (uint32_t r = 0; r < n_rates; r++) {
+        for (uint32_t e = 0; e < sizeof(edges) / sizeof(edges[0]); e++) passband_case(rates[r], edges[e]);
+    }
+
+    printf("[cic_bench] aliasing\n");
+    for (uint32_t r = 0; r < n_rates; r++) alias_case(rates[r]);
+
+    printf("[cic_bench] range\n");
+    full_scale_case();
+
+    printf("[cic_bench] throughput\n");
+    for (uint32_t r = 0; r < n_rates; r++) throughput(rates[r]);
+
+    printf("[cic_bench] %s\n", failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}
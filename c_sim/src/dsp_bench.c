@@ -0,0 +1,316 @@
+/* dsp_bench.c
+   Per-stage throughput of the DSP metrics pipeline (QLU/includes/qlu_metrics.h)
+   - stages: conversion, slicing per modulation, symbol accumulation per
+     modulation, skew sums, per-block finalize and the fused block pipeline
+   - each stage runs over a large noisy capture, warmup runs first, then the
+     median of the timed repetitions is reported
+   - output is JSON on stdout (and in -o FILE) so releases can be compared:
+     median samples/s, median/min/max ns per sample
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_metrics.h"
+
+#ifndef BENCH_FLAGS
+#define BENCH_FLAGS ""
+#endif
+
+#define DEFAULT_SAMPLES   (1u << 20)
+#define DEFAULT_WARMUP    3
+#define DEFAULT_REPS      11
+#define MAX_REPS          101
+#define BENCH_SNR_DB      20.0
+
+typedef struct {
+    uint32_t      n;
+    uint16_t*     raw_i;
+    uint16_t*     raw_q;
+    double*       fi;
+    double*       fq;
+    SlicerResult* res;
+    demod_t          demod;
+    metrics_engine_t metrics;
+} bench_ctx_t;
+
+typedef void (*stage_fn)(bench_ctx_t* c);
+
+typedef struct {
+    const char* name;
+    stage_fn    run;
+    modulation_type_t modulation;
+    uint32_t    units;            // samples covered by one run
+} stage_t;
+
+typedef struct {
+    double median_ns;
+    double min_ns;
+    double max_ns;
+} stage_result_t;
+
+static volatile double sink = 0.0;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static uint32_t rng_state = 0x5EED1234u;
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static double gauss(void) {
+    double u1 = ((rng() >> 8) + 1.0) / 16777217.0;
+    double u2 = (rng() >> 8) / 16777216.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static double constellation_level(modulation_type_t mod, uint32_t bits) {
+    switch (mod) {
+        case MOD_BPSK:  return (bits & 1u) ? 1.0 : -1.0;
+        case MOD_QPSK:  return (bits & 1u) ? QPSK_NORM : -QPSK_NORM;
+        default:        return (2.0 * (double)(bits & 3u) - 3.0) * QAM16_NORM;
+    }
+}
+
+static demod_config_t bench_config(modulation_type_t mod) {
+    demod_config_t cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = 20e6,
+        .decimation = 1,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = mod
+    };
+    config_calculate_derived(&cfg);
+    return cfg;
+}
+
+/* Noisy symbols held for sps samples, 16-bit offset binary like the ADC */
+static void make_capture(bench_ctx_t* c, modulation_type_t mod) {
+    demod_t d;
+    demod_init(&d, bench_config(mod));
+    const uint32_t sps   = (uint32_t)ceil(d.config.samples_per_symbol);
+    const double   sigma = sqrt(0.5 * pow(10.0, -BENCH_SNR_DB / 10.0));
+    double si = 0.0, sq = 0.0;
+
+    rng_state = 0x5EED1234u;
+    for (uint32_t k = 0; k < c->n; k++) {
+        if (k % sps == 0) {
+            si = constellation_level(mod, rng());
+            sq = (mod == MOD_BPSK) ? 0.0 : constellation_level(mod, rng() >> 2);
+        }
+        double vi = 32767.0 + (si + sigma * gauss()) * d.scale;
+        double vq = 32767.0 + (sq + sigma * gauss()) * d.scale;
+        c->raw_i[k] = (uint16_t)fmin(fmax(lrint(vi), 0.0), 65535.0);
+        c->raw_q[k] = (uint16_t)fmin(fmax(lrint(vq), 0.0), 65535.0);
+    }
+}
+
+static void prepare(bench_ctx_t* c, modulation_type_t mod) {
+    make_capture(c, mod);
+    demod_init(&c->demod, bench_config(mod));
+    metrics_engine_init(&c->metrics, &c->demod);
+    for (uint32_t k = 0; k < c->n; k++) {
+        metrics_convert(&c->demod, c->raw_i[k], c->raw_q[k], &c->fi[k], &c->fq[k]);
+        c->res[k] = c->metrics.slicer(c->fi[k], c->fq[k]);
+    }
+}
+
+// ---- Stages ----------------------------------------------------------------
+
+static void stage_convert(bench_ctx_t* c) {
+    for (uint32_t k = 0; k < c->n; k++) {
+        metrics_convert(&c->demod, c->raw_i[k], c->raw_q[k], &c->fi[k], &c->fq[k]);
+    }
+    sink += c->fi[c->n - 1];
+}
+
+static void stage_slice(bench_ctx_t* c) {
+    for (uint32_t k = 0; k < c->n; k++) {
+        c->res[k] = metrics_slice_sample(&c->metrics, &c->demod, c->fi[k], c->fq[k]);
+    }
+    sink += c->demod.sum_sample_error_power;
+    demod_reset_accumulators(&c->demod);
+    c->metrics.block_rx_power_sum = 0.0;
+}
+
+static void stage_skew(bench_ctx_t* c) {
+    for (uint32_t k = 0; k < c->n; k++) {
+        metrics_skew_sample(&c->metrics, c->fi[k], c->fq[k], c->res[k]);
+    }
+    sink += c->metrics.sum_IQ;
+    metrics_engine_reset(&c->metrics);
+}
+
+static void stage_symbol(bench_ctx_t* c) {
+    for (uint32_t k = 0; k < c->n; k++) {
+        metrics_symbol_sample(&c->metrics, &c->demod, c->fi[k], c->fq[k]);
+    }
+    sink += c->demod.sum_symbol_error_power;
+    demod_reset_accumulators(&c->demod);
+    compression_reset(&c->metrics.comp);
+}
+
+/* Finalize alone: every call sees one block worth of accumulated sums */
+static void stage_finalize(bench_ctx_t* c) {
+    const uint32_t blocks = c->n / PROCESS_BLOCK_SIZE;
+    demod_t* d = &c->demod;
+    metrics_engine_t* m = &c->metrics;
+
+    demod_reset_accumulators(d);
+    metrics_engine_reset(m);
+    metrics_engine_process_block(m, d, c->raw_i, c->raw_q, PROCESS_BLOCK_SIZE);
+    const demod_t block = *d;
+    const metrics_engine_t acc = *m;
+
+    for (uint32_t b = 0; b < blocks; b++) {
+        d->sum_sample_signal_power = block.sum_sample_signal_power;
+        d->sum_sample_error_power  = block.sum_sample_error_power;
+        d->sample_count            = block.sample_count;
+        d->sum_symbol_signal_power = block.sum_symbol_signal_power;
+        d->sum_symbol_error_power  = block.sum_symbol_error_power;
+        d->symbol_count            = block.symbol_count;
+        m->block_rx_power_sum      = acc.block_rx_power_sum;
+        m->sum_I_sq     += acc.sum_I_sq;
+        m->sum_Q_sq     += acc.sum_Q_sq;
+        m->sum_IQ       += acc.sum_IQ;
+        m->iq_imb_count += acc.iq_imb_count;
+        metrics_engine_finalize_block(m, d, PROCESS_BLOCK_SIZE);
+    }
+    sink += m->out.sqi;
+}
+
+/* What the DSP task runs per locked block */
+static void stage_block(bench_ctx_t* c) {
+    const uint32_t blocks = c->n / PROCESS_BLOCK_SIZE;
+    for (uint32_t b = 0; b < blocks; b++) {
+        metrics_engine_process_block(&c->metrics, &c->demod, c->raw_i + b * PROCESS_BLOCK_SIZE,
+                                     c->raw_q + b * PROCESS_BLOCK_SIZE, PROCESS_BLOCK_SIZE);
+        metrics_engine_finalize_block(&c->metrics, &c->demod, PROCESS_BLOCK_SIZE);
+    }
+    sink += c->metrics.out.sqi;
+}
+
+// ---- Driver ----------------------------------------------------------------
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static stage_result_t run_stage(bench_ctx_t* c, const stage_t* s, uint32_t warmup, uint32_t reps) {
+    double ns[MAX_REPS];
+
+    prepare(c, s->modulation);
+    for (uint32_t w = 0; w < warmup; w++) s->run(c);
+    for (uint32_t r = 0; r < reps; r++) {
+        double t0 = now_sec();
+        s->run(c);
+        ns[r] = (now_sec() - t0) * 1e9 / (double)s->units;
+    }
+    qsort(ns, reps, sizeof(ns[0]), cmp_double);
+    return (stage_result_t){ .median_ns = ns[reps / 2], .min_ns = ns[0], .max_ns = ns[reps - 1] };
+}
+
+static void print_json(FILE* f, const stage_t* stages, const stage_result_t* res, uint32_t n_stages,
+                       uint32_t samples, uint32_t warmup, uint32_t reps) {
+    fprintf(f, "{\n");
+    fprintf(f, "  \"bench\": \"qlu_dsp\",\n");
+    fprintf(f, "  \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf(f, "  \"flags\": \"%s\",\n", BENCH_FLAGS);
+    fprintf(f, "  \"block_size\": %u,\n", PROCESS_BLOCK_SIZE);
+    fprintf(f, "  \"samples\": %u,\n", samples);
+    fprintf(f, "  \"warmup\": %u,\n", warmup);
+    fprintf(f, "  \"reps\": %u,\n", reps);
+    fprintf(f, "  \"stages\": [\n");
+    for (uint32_t s = 0; s < n_stages; s++) {
+        fprintf(f, "    {\"name\": \"%s\", \"samples\": %u, \"median_samples_per_s\": %.0f, "
+                   "\"median_ns_per_sample\": %.3f, \"min_ns_per_sample\": %.3f, \"max_ns_per_sample\": %.3f}%s\n",
+                stages[s].name, stages[s].units, 1e9 / res[s].median_ns,
+                res[s].median_ns, res[s].min_ns, res[s].max_ns, (s + 1 < n_stages) ? "," : "");
+    }
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t samples = DEFAULT_SAMPLES;
+    uint32_t warmup  = DEFAULT_WARMUP;
+    uint32_t reps    = DEFAULT_REPS;
+    const char* out_path = NULL;
+
+    for (int a = 1; a < argc; a++) {
+        if      (strcmp(argv[a], "--samples") == 0 && a + 1 < argc) samples = (uint32_t)strtoul(argv[++a], NULL, 0);
+        else if (strcmp(argv[a], "--warmup")  == 0 && a + 1 < argc) warmup  = (uint32_t)strtoul(argv[++a], NULL, 0);
+        else if (strcmp(argv[a], "--reps")    == 0 && a + 1 < argc) reps    = (uint32_t)strtoul(argv[++a], NULL, 0);
+        else if (strcmp(argv[a], "-o")        == 0 && a + 1 < argc) out_path = argv[++a];
+        else {
+            fprintf(stderr, "usage: %s [--samples N] [--warmup N] [--reps N] [-o FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+    samples -= samples % PROCESS_BLOCK_SIZE;
+    if (samples == 0) samples = PROCESS_BLOCK_SIZE;
+    if (reps == 0) reps = 1;
+    if (reps > MAX_REPS) reps = MAX_REPS;
+
+    bench_ctx_t c = { .n = samples };
+    c.raw_i = malloc(samples * sizeof(*c.raw_i));
+    c.raw_q = malloc(samples * sizeof(*c.raw_q));
+    c.fi    = malloc(samples * sizeof(*c.fi));
+    c.fq    = malloc(samples * sizeof(*c.fq));
+    c.res   = malloc(samples * sizeof(*c.res));
+    if (!c.raw_i || !c.raw_q || !c.fi || !c.fq || !c.res) {
+        fprintf(stderr, "out of memory for %u samples\n", samples);
+        return 1;
+    }
+
+    const stage_t stages[] = {
+        { "convert",        stage_convert,  MOD_16QAM, samples },
+        { "slice_bpsk",     stage_slice,    MOD_BPSK,  samples },
+        { "slice_qpsk",     stage_slice,    MOD_QPSK,  samples },
+        { "slice_16qam",    stage_slice,    MOD_16QAM, samples },
+        { "symbol_bpsk",    stage_symbol,   MOD_BPSK,  samples },
+        { "symbol_qpsk",    stage_symbol,   MOD_QPSK,  samples },
+        { "symbol_16qam",   stage_symbol,   MOD_16QAM, samples },
+        { "skew",           stage_skew,     MOD_16QAM, samples },
+        { "finalize",       stage_finalize, MOD_16QAM, samples },
+        { "block_bpsk",     stage_block,    MOD_BPSK,  samples },
+        { "block_qpsk",     stage_block,    MOD_QPSK,  samples },
+        { "block_16qam",    stage_block,    MOD_16QAM, samples },
+    };
+    const uint32_t n_stages = sizeof(stages) / sizeof(stages[0]);
+    stage_result_t res[sizeof(stages) / sizeof(stages[0])];
+
+    for (uint32_t s = 0; s < n_stages; s++) {
+        res[s] = run_stage(&c, &stages[s], warmup, reps);
+    }
+
+    print_json(stdout, stages, res, n_stages, samples, warmup, reps);
+    if (out_path) {
+        FILE* f = fopen(out_path, "w");
+        if (!f) {
+            fprintf(stderr, "cannot write %s\n", out_path);
+            return 1;
+        }
+        print_json(f, stages, res, n_stages, samples, warmup, reps);
+        fclose(f);
+    }
+
+    free(c.raw_i); free(c.raw_q); free(c.fi); free(c.fq); free(c.res);
+    return 0;
+}
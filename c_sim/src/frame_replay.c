@@ -0,0 +1,276 @@
+/* frame_replay.c
+   Host replay of SPI byte streams through the portable frame parser
+   (sync_stream_feed in QLU/includes/qlu_sync.h)
+   - without arguments: generates clean, bit-flipped, shifted (dropped and
+     inserted bytes) and mid-frame-start v2 streams, replays each one in
+     random-sized chunks and checks that no frame with a wrong payload is
+     ever accepted
+   - with file arguments: replays raw captures (v2 unless --v1) and reports
+     the same figures
+   - --dump DIR writes the generated streams as raw captures
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "qlu_sync.h"
+#include "qlu_crc32.h"
+
+#define RING_SIZE      8192
+#define PAYLOAD_SIZE   1024
+#define FRAME_SIZE     (SYNC_V2_HEADER_SIZE + PAYLOAD_SIZE + SYNC_V2_CRC_SIZE)
+#define STREAM_FRAMES  20000
+#define MAX_CHUNK      2048
+#define DAMAGE_EVERY   50
+
+static uint8_t __attribute__((aligned(RING_SIZE))) ring[RING_SIZE];
+static uint8_t scratch[PAYLOAD_SIZE];
+
+typedef struct {
+    const char* name;
+    uint8_t*    bytes;
+    size_t      len;
+    uint32_t    frames;       // frames written by the generator
+    uint32_t    damaged;      // frames the scenario broke on purpose
+} capture_t;
+
+typedef struct {
+    uint32_t frames;          // parser output, CRC failures included
+    uint32_t good;
+    uint32_t wrong;           // CRC-valid but payload differs from the sender's
+    double   sec;
+} replay_result_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static uint32_t rng_state = 0x13579BDu;
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* Sender payload for a sequence number, so the receiver can check it */
+static uint8_t payload_byte(uint32_t seq, uint32_t k) {
+    uint32_t h = seq * 2654435761u + k * 40503u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return (uint8_t)h;
+}
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);  p[3] = (uint8_t)v;
+}
+
+static size_t write_frame(uint8_t* fr, uint32_t seq) {
+    fr[0] = 0xFE; fr[1] = 0xCA; fr[2] = 0xFE; fr[3] = 0xCA;
+    fr[4] = SYNC_V2_VERSION;
+    fr[5] = SYNC_FMT_BYTE(SYNC_FMT_IQ16_BE, 16);
+    fr[6] = (uint8_t)(PAYLOAD_SIZE >> 8);
+    fr[7] = (uint8_t)PAYLOAD_SIZE;
+    put_be32(fr + 8, seq);
+    for (uint32_t k = 0; k < PAYLOAD_SIZE; k++) fr[SYNC_V2_HEADER_SIZE + k] = payload_byte(seq, k);
+    put_be32(fr + SYNC_V2_HEADER_SIZE + PAYLOAD_SIZE,
+             qlu_crc32(fr + SYNC_MARKER_SIZE, SYNC_V2_HEADER_SIZE - SYNC_MARKER_SIZE + PAYLOAD_SIZE));
+    return FRAME_SIZE;
+}
+
+typedef enum { DAMAGE_NONE, DAMAGE_BITFLIP, DAMAGE_DROP_BYTE, DAMAGE_INSERT_BYTES } damage_t;
+
+/* Every DAMAGE_EVERY-th frame gets the damage; skip_head drops the start of
+   the stream so the parser comes up in the middle of a frame */
+static capture_t build_capture(const char* name, damage_t damage, size_t skip_head) {
+    capture_t c = {0};
+    c.name  = name;
+    c.bytes = malloc((size_t)STREAM_FRAMES * (FRAME_SIZE + 16));
+    rng_state = 0x13579BDu;
+
+    for (uint32_t f = 0; f < STREAM_FRAMES; f++) {
+        uint8_t* fr = c.bytes + c.len;
+        size_t   n  = write_frame(fr, f);
+        bool     hit = (f % DAMAGE_EVERY == DAMAGE_EVERY - 1);
+
+        if (hit && damage == DAMAGE_BITFLIP) {
+            fr[SYNC_V2_HEADER_SIZE + rng() % PAYLOAD_SIZE] ^= (uint8_t)(1u << (rng() & 7));
+            c.damaged++;
+        } else if (hit && damage == DAMAGE_DROP_BYTE) {
+            // Slip: one byte lost inside the payload shifts the rest of the frame
+            size_t at = SYNC_V2_HEADER_SIZE + rng() % PAYLOAD_SIZE;
+            memmove(fr + at, fr + at + 1, n - at - 1);
+            n--;
+            c.damaged++;
+        } else if (hit && damage == DAMAGE_INSERT_BYTES) {
+            // Glitch bytes between two frames, may carry a partial marker
+            static const uint8_t glitch[] = {0xFE, 0xCA, 0xFE, 0x00, 0x55};
+            memmove(fr + sizeof(glitch), fr, n);
+            memcpy(fr, glitch, sizeof(glitch));
+            n += sizeof(glitch);
+        }
+        c.len += n;
+        c.frames++;
+    }
+
+    if (skip_head > 0) {
+        memmove(c.bytes, c.bytes + skip_head, c.len - skip_head);
+        c.len -= skip_head;
+        c.damaged++;   // the first frame is cut
+    }
+    return c;
+}
+
+static bool host_crc(const uint8_t* r, uint32_t mask, const frame_desc_t* d) {
+    return qlu_crc32_ring(r, mask, d->crc_pos, d->crc_len) == d->crc;
+}
+
+static void on_frame(void* user, const frame_desc_t* d, const uint8_t* payload, bool crc_ok) {
+    replay_result_t* res = user;
+    res->frames++;
+    if (!crc_ok) return;
+    res->good++;
+    for (uint32_t k = 0; k < d->length; k++) {
+        if (payload[k] != payload_byte(d->seq, k)) {
+            res->wrong++;
+            return;
+        }
+    }
+}
+
+static void on_frame_unchecked(void* user, const frame_desc_t* d, const uint8_t* payload, bool crc_ok) {
+    replay_result_t* res = user;
+    (void)d; (void)payload;
+    res->frames++;
+    if (crc_ok) res->good++;
+}
+
+static replay_result_t replay(const uint8_t* bytes, size_t len, sync_frame_version_t version,
+                              bool check_payload, sync_stream_t* st) {
+    replay_result_t res = {0};
+    size_t pos = 0;
+
+    sync_stream_init(st, ring, RING_SIZE, scratch, PAYLOAD_SIZE, version,
+                     version == SYNC_FRAME_V2 ? host_crc : NULL);
+    rng_state = 0xC0FFEEu;
+
+    double t0 = now_sec();
+    while (pos < len) {
+        size_t chunk = 1 + rng() % MAX_CHUNK;
+        if (chunk > len - pos) chunk = len - pos;
+        sync_stream_feed(st, bytes + pos, (uint32_t)chunk,
+                         check_payload ? on_frame : on_frame_unchecked, &res);
+        pos += chunk;
+    }
+    res.sec = now_sec() - t0;
+    return res;
+}
+
+static void print_header(void) {
+    printf("  %-14s | frames | good  | crc_err | bad_hdr | resync | lost | kframes/s | MB/s\n", "stream");
+}
+
+static void print_row(const char* name, size_t len, const replay_result_t* r, const sync_parser_t* p) {
+    printf("  %-14s | %6u | %5u | %7u | %7u | %6u | %4u | %9.3f | %7.1f\n",
+           name, r->frames, r->good, p->crc_errors, p->bad_headers, p->resyncs, p->lost_frames,
+           r->frames / r->sec / 1e3, len / r->sec / 1e6);
+}
+
+static bool dump_capture(const char* dir, const capture_t* c) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.bin", dir, c->name);
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(c->bytes, 1, c->len, f) == c->len;
+    fclose(f);
+    return ok;
+}
+
+static int replay_files(int argc, char** argv, sync_frame_version_t version) {
+    static sync_stream_t st;
+    print_header();
+    for (int a = 0; a < argc; a++) {
+        FILE* f = fopen(argv[a], "rb");
+        if (!f) {
+            fprintf(stderr, "  cannot open %s\n", argv[a]);
+            return 1;
+        }
+        fseek(f, 0, SEEK_END);
+        long len = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        uint8_t* bytes = malloc(len > 0 ? (size_t)len : 1);
+        size_t got = fread(bytes, 1, (size_t)len, f);
+        fclose(f);
+
+        const char* name = strrchr(argv[a], '/');
+        replay_result_t r = replay(bytes, got, version, false, &st);
+        print_row(name ? name + 1 : argv[a], got, &r, &st.parser);
+        free(bytes);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    static sync_stream_t st;
+    sync_frame_version_t version = SYNC_FRAME_V2;
+    const char* dump_dir = NULL;
+    int a = 1;
+
+    for (; a < argc && argv[a][0] == '-'; a++) {
+        if (strcmp(argv[a], "--v1") == 0) version = SYNC_FRAME_V1;
+        else if (strcmp(argv[a], "--dump") == 0 && a + 1 < argc) dump_dir = argv[++a];
+        else {
+            fprintf(stderr, "usage: %s [--v1] [--dump DIR] [capture.bin ...]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("========================================================================\n");
+    printf("  Frame parser replay  (ring %u B, frame v%d, chunks 1..%u B)\n",
+           RING_SIZE, version == SYNC_FRAME_V2 ? 2 : 1, MAX_CHUNK);
+    printf("========================================================================\n");
+
+    if (a < argc) return replay_files(argc - a, argv + a, version);
+
+    capture_t caps[] = {
+        build_capture("clean",     DAMAGE_NONE,         0),
+        build_capture("bitflip",   DAMAGE_BITFLIP,      0),
+        build_capture("drop_byte", DAMAGE_DROP_BYTE,    0),
+        build_capture("insert",    DAMAGE_INSERT_BYTES, 0),
+        build_capture("mid_start", DAMAGE_NONE,         FRAME_SIZE / 3),
+    };
+    const uint32_t n_caps = sizeof(caps) / sizeof(caps[0]);
+    uint32_t failures = 0;
+
+    print_header();
+    for (uint32_t c = 0; c < n_caps; c++) {
+        replay_result_t r = replay(caps[c].bytes, caps[c].len, SYNC_FRAME_V2, true, &st);
+        print_row(caps[c].name, caps[c].len, &r, &st.parser);
+
+        // A slipped frame can take the next one with it (its marker is
+        // partly swallowed), so up to two frames per damage are lost
+        bool ok = (r.wrong == 0) && (r.good + 2 * caps[c].damaged >= caps[c].frames) && (r.good <= caps[c].frames);
+        if (caps[c].damaged == 0) ok = ok && (r.good == caps[c].frames) && (st.parser.lost_frames == 0);
+        if (!ok) {
+            printf("    FAIL: %u wrong payloads, %u/%u good\n", r.wrong, r.good, caps[c].frames);
+            failures++;
+        }
+
+        if (dump_dir && !dump_capture(dump_dir, &caps[c])) {
+            fprintf(stderr, "  cannot write %s/%s.bin\n", dump_dir, caps[c].name);
+            failures++;
+        }
+        free(caps[c].bytes);
+    }
+
+    printf("\n  %s\n", failures ? "FAIL: replay mismatch" : "OK: no corrupted frame was accepted, losses bounded");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+/* impair_bench.c
+   Host check and benchmark for the channel impairments (QLU/includes/qlu_impair.h)
+   - ziggurat normals: mean, variance and 3-sigma tail against N(0, 1)
+   - AWGN: the sample-level SNR the demod measures on a clean synthetic
+     16QAM stream matches the configured one
+   - CFO, Wiener phase noise, IQ skew and clock drift land where the model
+     says: phase slope, increment variance, skew.py matrix, slips and rate
+   - times the u16 path (the firmware test-mode entry) per impairment
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_source.h"
+#include "qlu_impair.h"
+
+#define BENCH_PAIRS   (1u << 20)
+#define BENCH_BLOCK   4096
+#define FS_HZ         20e6f
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static uint32_t failures = 0;
+
+static void check(const char *what, double got, double want, double tol) {
+    bool ok = fabs(got - want) <= tol;
+    printf("  %-34s %12.5f  (want %.5f ± %.5f)  %s\n", what, got, want, tol, ok ? "ok" : "FAIL");
+    if (!ok) failures++;
+}
+
+static demod_config_t link_config(void) {
+    demod_config_t cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = FS_HZ,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = MOD_16QAM
+    };
+    config_calculate_derived(&cfg);
+    return cfg;
+}
+
+static void check_ziggurat(void) {
+    qlu_ziggurat_t z;
+    const uint32_t n = 10000000;
+    double sum = 0.0, sum2 = 0.0;
+    uint32_t tail = 0;
+
+    qlu_zig_init(&z, 1);
+    double t0 = now_sec();
+    for (uint32_t k = 0; k < n; k++) {
+        float x = qlu_zig_normal(&z);
+        sum  += x;
+        sum2 += (double)x * x;
+        tail += fabsf(x) > 3.0f;
+    }
+    double dt = now_sec() - t0;
+
+    printf("\n[ziggurat]  %.1f M normals/s\n", n / dt / 1e6);
+    check("mean", sum / n, 0.0, 0.002);
+    check("variance", sum2 / n - (sum / n) * (sum / n), 1.0, 0.003);
+    check("P(|x| > 3)", (double)tail / n, 0.0026998, 0.0002);
+}
+
+/* Sample-level SNR against the ideal points, as main.c's PRE figure */
+static double measured_snr_db(const demod_config_t *cfg, float snr_db) {
+    static uint16_t i_raw[BENCH_BLOCK], q_raw[BENCH_BLOCK];
+    qlu_synth_source_t synth;
+    qlu_impaired_source_t imp;
+    qlu_impair_config_t ic = { .sample_rate_hz = FS_HZ, .awgn = true, .snr_db = snr_db };
+    double scale = config_get_scale_factor(cfg), sig = 0.0, err = 0.0;
+
+    qlu_source_t *src = qlu_impaired_source_init(&imp, qlu_synth_source_init(&synth, cfg, 0), cfg, &ic, 7);
+    for (uint32_t done = 0; done < BENCH_PAIRS; done += BENCH_BLOCK) {
+        qlu_source_fill(src, i_raw, q_raw, BENCH_BLOCK);
+        for (uint32_t k = 0; k < BENCH_BLOCK; k++) {
+            double fi = uint16_to_signed(i_raw[k], cfg->signal_resolution) / scale;
+            double fq = uint16_to_signed(q_raw[k], cfg->signal_resolution) / scale;
+            SlicerResult r = get_slicer_by_mod[cfg->modulation](fi, fq);
+            sig += slicer_calculate_power(r.ideal_i, r.ideal_q);
+            err += slicer_calculate_power(fi - r.ideal_i, fq - r.ideal_q);
+        }
+    }
+    return 10.0 * log10(sig / err);
+}
+
+static void check_awgn(void) {
+    demod_config_t cfg = link_config();
+    printf("\n[awgn]  16QAM, %u pairs, u16 path\n", BENCH_PAIRS);
+    check("SNR 20 dB", measured_snr_db(&cfg, 20.0f), 20.0, 0.25);
+    check("SNR 30 dB", measured_snr_db(&cfg, 30.0f), 30.0, 0.25);
+}
+
+static void check_lo(void) {
+    static float i[BENCH_BLOCK], q[BENCH_BLOCK];
+    qlu_impair_t imp;
+
+    printf("\n[lo]\n");
+
+    // CFO: a constant (1, 0) turns by 2π·f/fs per sample
+    const float cfo = 12345.0f;
+    qlu_impair_init(&imp, &(qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .cfo_hz = cfo }, 1);
+    double worst = 0.0;
+    for (uint32_t blk = 0; blk < 64; blk++) {
+        for (uint32_t k = 0; k < BENCH_BLOCK; k++) { i[k] = 1.0f; q[k] = 0.0f; }
+        qlu_impair_apply_f32(&imp, i, q, BENCH_BLOCK);
+        for (uint32_t k = 0; k < BENCH_BLOCK; k++) {
+            double n    = (double)blk * BENCH_BLOCK + k + 1;
+            double want = remainder(2.0 * M_PI * cfo / FS_HZ * n, 2.0 * M_PI);
+            double d    = fabs(remainder(atan2(q[k], i[k]) - want, 2.0 * M_PI));
+            if (d > worst) worst = d;
+        }
+    }
+    check("CFO phase error after 256k, rad", worst, 0.0, 2e-3);
+
+    // Phase noise: increments are N(0, 2π·Δν/fs)
+    const float lw = 5000.0f;
+    qlu_impair_init(&imp, &(qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .phase_noise_hz = lw }, 3);
+    double sum2 = 0.0, prev = 0.0;
+    uint32_t count = 0;
+    for (uint32_t blk = 0; blk < 64; blk++) {
+        for (uint32_t k = 0; k < BENCH_BLOCK; k++) { i[k] = 1.0f; q[k] = 0.0f; }
+        qlu_impair_apply_f32(&imp, i, q, BENCH_BLOCK);
+        for (uint32_t k = 0; k < BENCH_BLOCK; k++) {
+            double a = atan2(q[k], i[k]);
+            double d = remainder(a - prev, 2.0 * M_PI);
+            sum2 += d * d;
+            prev  = a;
+            count++;
+        }
+    }
+    double want = 2.0 * M_PI * lw / FS_HZ;
+    check("phase noise var / model", sum2 / count / want, 1.0, 0.05);
+}
+
+static void check_skew_and_clock(void) {
+    static float i[BENCH_BLOCK], q[BENCH_BLOCK];
+    qlu_impair_t imp;
+
+    printf("\n[receiver]\n");
+
+    // IQ skew: skew.py apply_iq_skew on one point
+    const float amp_db = 1.5f, phase_deg = 8.0f, x = 0.3f, y = -0.7f;
+    double alpha = pow(10.0, amp_db / 20.0) - 1.0, phi = phase_deg * M_PI / 180.0;
+    double want_i = (1.0 + alpha) * (x * cos(phi / 2) + y * sin(phi / 2));
+    double want_q = -x * sin(phi / 2) + y * cos(phi / 2);
+    qlu_impair_init(&imp, &(qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .iq_amp_db = amp_db, .iq_phase_deg = phase_deg }, 1);
+    i[0] = x; q[0] = y;
+    qlu_impair_apply_f32(&imp, i, q, 1);
+    check("IQ skew |error| vs skew.py", hypot(i[0] - want_i, q[0] - want_q), 0.0, 1e-6);
+
+    // Clock: ±100 ppm with 4-sample slips on a ramp. Between slips the
+    // ramp advances by 1 ∓ 1e-4 per sample; every 4/1e-4 samples it jumps
+    // ahead 5 (fast) or back 3 (slow)
+    const float ppm = 100.0f;
+    const uint16_t slip = 4;
+    const uint32_t n = 50 * BENCH_BLOCK;
+    for (int dir = 1; dir >= -1; dir -= 2) {
+        qlu_impair_init(&imp, &(qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .clock_ppm = dir * ppm, .clock_slip = slip }, 1);
+        uint32_t slips = 0;
+        double step_sum = 0.0, last = 0.0;
+        for (uint32_t done = 0; done < n; done += BENCH_BLOCK) {
+            for (uint32_t k = 0; k < BENCH_BLOCK; k++) { i[k] = (float)((done + k) % 8192); q[k] = 0.0f; }
+            qlu_impair_apply_f32(&imp, i, q, BENCH_BLOCK);
+            for (uint32_t k = 0; k < BENCH_BLOCK; k++) {
+                uint32_t at = done + k;
+                double d = i[k] - last;
+                last = i[k];
+                if (at < 2u * slip || at % 8192 <= slip + 1u) continue;       // ramp wrap / delay line fill
+                if (fabs(d - 1.0) > 0.5) slips++;
+                else                      step_sum += d - 1.0;
+            }
+        }
+        char what[64];
+        snprintf(what, sizeof(what), "clock %+.0f ppm, %u-sample slips", dir * ppm, slip);
+        check(what, slips, n * ppm * 1e-6 / slip, 1.0);
+        snprintf(what, sizeof(what), "clock %+.0f ppm, mean step - 1 (ppm)", dir * ppm);
+        check(what, step_sum / (n - slips) * -1e6, dir * ppm, 2.0);
+    }
+}
+
+static void bench(const char *name, qlu_impair_config_t ic) {
+    static uint16_t i_raw[BENCH_BLOCK], q_raw[BENCH_BLOCK];
+    demod_config_t cfg = link_config();
+    qlu_synth_source_t synth;
+    qlu_impair_t imp;
+    const uint32_t rounds = 16 * BENCH_PAIRS / BENCH_BLOCK;
+
+    qlu_source_t *src = qlu_synth_source_init(&synth, &cfg, 0);
+    qlu_source_fill(src, i_raw, q_raw, BENCH_BLOCK);
+    qlu_impair_init(&imp, &ic, 5);
+
+    double t0 = now_sec();
+    for (uint32_t r = 0; r < rounds; r++) {
+        qlu_impair_apply_u16(&imp, &cfg, i_raw, q_raw, BENCH_BLOCK);
+    }
+    double dt = now_sec() - t0;
+    printf("  %-22s %8.1f Msps\n", name, (double)rounds * BENCH_BLOCK / dt / 1e6);
+}
+
+int main(void) {
+    printf("========================================================================\n");
+    printf("  Channel impairment check and bench  (fs %.0f MHz)\n", FS_HZ / 1e6);
+    printf("========================================================================\n");
+
+    check_ziggurat();
+    check_awgn();
+    check_lo();
+    check_skew_and_clock();
+
+    printf("\n[throughput]  u16 in place, blocks of %u\n", BENCH_BLOCK);
+    bench("none",           (qlu_impair_config_t){ .sample_rate_hz = FS_HZ });
+    bench("AWGN",           (qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .awgn = true, .snr_db = 20.0f });
+    bench("CFO",            (qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .cfo_hz = 1e3f });
+    bench("CFO + PN",       (qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .cfo_hz = 1e3f, .phase_noise_hz = 100.0f });
+    bench("IQ skew + DC",   (qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .iq_amp_db = 1.0f, .iq_phase_deg = 5.0f, .dc_i = 0.01f });
+    bench("clock",          (qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .clock_ppm = 50.0f });
+    bench("all",            (qlu_impair_config_t){ .sample_rate_hz = FS_HZ, .awgn = true, .snr_db = 20.0f, .cfo_hz = 1e3f,
+                                                   .phase_noise_hz = 100.0f, .clock_ppm = 50.0f, .iq_amp_db = 1.0f,
+                                                   .iq_phase_deg = 5.0f, .dc_i = 0.01f, .dc_q = -0.01f });
+
+    printf("\n  %s\n", failures ? "FAIL: an impairment is off its model" : "OK: every impairment matches its model");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,122 @@
+/* iqpack_bench.c
+   Host check and benchmark for the IQ sample transport (QLU/includes/qlu_iqpack.h)
+   - round trip: native 12/8-bit codes survive pack -> unpack -> pack exactly,
+     16-bit samples come back within the quantisation step of the format
+   - times every unpack kernel and reports the pairs/s a 1 MHz SPI link
+     carries with each format (frame v2 overhead included)
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "qlu_iqpack.h"
+
+#define BENCH_PAIRS       256
+#define BENCH_ITERATIONS  200000
+#define SPI_CLOCK_HZ      1000000.0
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static uint32_t rng_state = 0x2468ACEu;
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static const char* format_name[SYNC_FMT_COUNT] = {
+    [SYNC_FMT_IQ16_BE] = "IQ16 BE",
+    [SYNC_FMT_IQ12]    = "IQ12 packed",
+    [SYNC_FMT_IQ8]     = "IQ8"
+};
+
+static const uint32_t format_bits[SYNC_FMT_COUNT] = {
+    [SYNC_FMT_IQ16_BE] = 16,
+    [SYNC_FMT_IQ12]    = 12,
+    [SYNC_FMT_IQ8]     = 8
+};
+
+/* Returns the number of mismatching samples */
+static uint32_t round_trip(sync_sample_format_t f) {
+    static uint16_t i_in[BENCH_PAIRS], q_in[BENCH_PAIRS], i_out[BENCH_PAIRS], q_out[BENCH_PAIRS];
+    static uint8_t  wire[BENCH_PAIRS * 4], wire2[BENCH_PAIRS * 4];
+    const uint32_t bits = format_bits[f];
+    const int32_t  step = 1 << (16 - bits);
+    uint32_t bad = 0;
+
+    // 1. Full 16-bit input: error bounded by one step of the format
+    for (uint32_t k = 0; k < BENCH_PAIRS; k++) {
+        i_in[k] = (uint16_t)rng();
+        q_in[k] = (uint16_t)rng();
+    }
+    iq_pack_kernels[f](i_in, q_in, wire, BENCH_PAIRS);
+    iq_unpack_kernels[f](wire, i_out, q_out, BENCH_PAIRS);
+    for (uint32_t k = 0; k < BENCH_PAIRS; k++) {
+        if (abs((int32_t)i_out[k] - (int32_t)i_in[k]) >= step) bad++;
+        if (abs((int32_t)q_out[k] - (int32_t)q_in[k]) >= step) bad++;
+    }
+
+    // 2. Native codes: repacking the unpacked block gives the same bytes
+    iq_pack_kernels[f](i_out, q_out, wire2, BENCH_PAIRS);
+    if (memcmp(wire, wire2, iq_payload_bytes(f, BENCH_PAIRS)) != 0) bad++;
+
+    // 3. Full scale and mid scale land where the DSP expects them
+    i_in[0] = 0x0000; q_in[0] = 0xFFFF;
+    iq_pack_kernels[f](i_in, q_in, wire, 1);
+    iq_unpack_kernels[f](wire, i_out, q_out, 1);
+    if (i_out[0] != 0x0000 || q_out[0] != 0xFFFF) bad++;
+
+    return bad;
+}
+
+int main(void) {
+    static uint8_t  wire[BENCH_PAIRS * 4];
+    static uint16_t i_in[BENCH_PAIRS], q_in[BENCH_PAIRS], i_out[BENCH_PAIRS], q_out[BENCH_PAIRS];
+    volatile uint32_t sink = 0;
+    uint32_t failures = 0;
+
+    printf("========================================================================\n");
+    printf("  IQ transport bench  (%u pairs per frame, SPI %.1f MHz)\n", BENCH_PAIRS, SPI_CLOCK_HZ / 1e6);
+    printf("========================================================================\n");
+    printf("  format      | bytes/frame | round trip | unpack Mpairs/s | SPI kpairs/s\n");
+
+    for (uint32_t f = 0; f < SYNC_FMT_COUNT; f++) {
+        uint32_t bad = round_trip((sync_sample_format_t)f);
+        failures += bad;
+
+        for (uint32_t k = 0; k < BENCH_PAIRS; k++) {
+            i_in[k] = (uint16_t)rng();
+            q_in[k] = (uint16_t)rng();
+        }
+        iq_pack_kernels[f](i_in, q_in, wire, BENCH_PAIRS);
+
+        double t0 = now_sec();
+        for (uint32_t it = 0; it < BENCH_ITERATIONS; it++) {
+            iq_unpack_kernels[f](wire, i_out, q_out, BENCH_PAIRS);
+            sink += i_out[it & (BENCH_PAIRS - 1)];
+            wire[it & (BENCH_PAIRS - 1)] ^= (uint8_t)it;   // keep the loop honest
+        }
+        double dt = now_sec() - t0;
+
+        uint32_t payload = iq_payload_bytes((sync_sample_format_t)f, BENCH_PAIRS);
+        uint32_t frame   = SYNC_V2_HEADER_SIZE + payload + SYNC_V2_CRC_SIZE;
+        double   spi_pairs_s = SPI_CLOCK_HZ / 8.0 / (double)frame * BENCH_PAIRS;
+
+        printf("  %-11s | %11u | %10s | %15.1f | %12.1f\n",
+               format_name[f], frame, bad ? "FAIL" : "ok",
+               (double)BENCH_ITERATIONS * BENCH_PAIRS / dt / 1e6, spi_pairs_s / 1e3);
+    }
+
+    (void)sink;
+    printf("\n  %s\n", failures ? "FAIL: round trip mismatch" : "OK: every format round-trips");
+    return failures ? 1 : 0;
+}
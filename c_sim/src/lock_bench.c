@@ -0,0 +1,194 @@
+/* lock_bench.c
+   Host check for the lock detector (QLU/includes/qlu_lock.h)
+   - every configured modulation against every transmitted one, through
+     AWGN from 0 to 30 dB, plus pure noise on both axes and on I only:
+     share of blocks spent locked
+   - the right modulation stays locked down to 6 dB; noise, another axis
+     count or another order never holds lock once the order is decidable
+   - times the probe per block
+   Raw interleaved u16 streams given on the command line (gen_streamv2.py
+   .u16 files) are probed with each configured modulation and reported.
+
+       lock_bench.exe [FILE.u16 ...]
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_source.h"
+#include "qlu_impair.h"
+#include "qlu_lock.h"
+
+#define LOCK_BENCH_BLOCKS 2000
+#define LOCK_NOISE_SNR    (-100)      // column label for the noise-only input
+#define LOCK_NOISE_I_SNR  (-101)      // noise on I only: low Q/I like BPSK
+
+static const int snr_list[] = { LOCK_NOISE_SNR, LOCK_NOISE_I_SNR, 0, 2, 4, 6, 8, 10, 12, 14, 16, 20, 30 };
+#define SNR_COUNT (sizeof(snr_list) / sizeof(snr_list[0]))
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static demod_config_t make_config(modulation_type_t mod) {
+    demod_config_t cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = 20e6,
+        .decimation = 1,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = mod
+    };
+    config_calculate_derived(&cfg);
+    return cfg;
+}
+
+// Noise on I, and on Q as well or not, at 0.3 of the synthetic sources'
+// scale: clear of the rails, a clipped Gaussian is flatter than the detector
+// expects noise to be
+static void fill_noise(IqBlock_t* b, qlu_ziggurat_t* z, const demod_t* d, bool with_q) {
+    double mid = (double)((1u << d->config.signal_resolution) - 1u) / 2.0;
+    double sd  = 0.3;
+    for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++) {
+        double i = mid + d->scale * sd * qlu_zig_normal(z);
+        double q = mid + (with_q ? d->scale * sd * qlu_zig_normal(z) : 0.0);
+        b->i_samples[k] = (uint16_t)fmin(fmax(i + 0.5, 0.0), 65535.0);
+        b->q_samples[k] = (uint16_t)fmin(fmax(q + 0.5, 0.0), 65535.0);
+    }
+}
+
+// Share of blocks the detector configured for `cfg_mod` spends locked
+static double locked_share(modulation_type_t cfg_mod, modulation_type_t tx_mod, int snr_db) {
+    demod_config_t cfg = make_config(cfg_mod);
+    demod_config_t tx  = make_config(tx_mod);
+    demod_t demod;
+    demod_init(&demod, cfg);
+
+    qlu_synth_source_t synth;
+    qlu_impaired_source_t impaired;
+    qlu_impair_config_t imp = { .sample_rate_hz = (float)tx.sampling_rate_hz, .awgn = true, .snr_db = (float)snr_db };
+    qlu_source_t* src = qlu_impaired_source_init(&impaired, qlu_synth_source_init(&synth, &tx, 7), &tx, &imp, 9);
+
+    lock_detector_t det;
+    lock_detector_reset(&det, cfg_mod, 0);
+    IqBlock_t block;
+    for (uint32_t b = 0; b < LOCK_BENCH_BLOCKS; b++) {
+        if (snr_db == LOCK_NOISE_SNR)        fill_noise(&block, &impaired.imp.zig, &demod, true);
+        else if (snr_db == LOCK_NOISE_I_SNR) fill_noise(&block, &impaired.imp.zig, &demod, false);
+        else qlu_source_fill(src, block.i_samples, block.q_samples, PROCESS_BLOCK_SIZE);
+        lock_detector_update(&det, lock_probe_block(&det, &block, &demod), b);
+    }
+    return (double)det.locked_blocks / LOCK_BENCH_BLOCKS;
+}
+
+// Lowest SNR from which the order (or axis count) is told apart
+static int decidable_snr(modulation_type_t cfg_mod, modulation_type_t tx_mod) {
+    if (cfg_mod == MOD_BPSK || tx_mod == MOD_BPSK) return 4;
+    return (cfg_mod == MOD_QPSK) ? 16 : 12;        // 16QAM as QPSK : QPSK as 16QAM
+}
+
+static void probe_file(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) { fprintf(stderr, "[lock_bench] cannot open %s\n", path); return; }
+    fseek(f, 0, SEEK_END);
+    long bytes = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint32_t n_pairs = (uint32_t)(bytes / 4);
+    uint16_t* pairs = malloc((size_t)n_pairs * 4);
+    if (!pairs || n_pairs == 0 || fread(pairs, 4, n_pairs, f) != n_pairs) {
+        fprintf(stderr, "[lock_bench] cannot read %s\n", path);
+        fclose(f); free(pairs);
+        return;
+    }
+    fclose(f);
+
+    printf("  %-42s", strrchr(path, '/') ? strrchr(path, '/') + 1 : path);
+    for (int m = 0; m < MOD_NUM_MODULATIONS; m++) {
+        demod_t demod;
+        demod_init(&demod, make_config((modulation_type_t)m));
+        lock_detector_t det;
+        lock_detector_reset(&det, (modulation_type_t)m, 0);
+        IqBlock_t block;
+        uint32_t pos = 0;
+        for (uint32_t b = 0; b < LOCK_BENCH_BLOCKS; b++) {
+            for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++, pos = (pos + 1) % n_pairs) {
+                block.i_samples[k] = pairs[2 * pos];
+                block.q_samples[k] = pairs[2 * pos + 1];
+            }
+            lock_detector_update(&det, lock_probe_block(&det, &block, &demod), b);
+        }
+        printf("  %5s %5.1f%% (%5.1f dB)", get_modulation_name[m],
+               100.0 * det.locked_blocks / LOCK_BENCH_BLOCKS, det.last_probe_mer_db);
+    }
+    printf("\n");
+    free(pairs);
+}
+
+int main(int argc, char** argv) {
+    uint32_t failures = 0;
+
+    printf("[lock_bench] locked share of %u blocks, configured x transmitted\n", LOCK_BENCH_BLOCKS);
+    printf("  %-14s", "cfg / tx");
+    for (uint32_t s = 0; s < SNR_COUNT; s++) {
+        if (snr_list[s] == LOCK_NOISE_SNR)        printf(" %6s", "noise");
+        else if (snr_list[s] == LOCK_NOISE_I_SNR) printf(" %6s", "nz I");
+        else                                      printf(" %4d dB", snr_list[s]);
+    }
+    printf("\n");
+
+    for (int c = 0; c < MOD_NUM_MODULATIONS; c++) {
+        for (int t = 0; t < MOD_NUM_MODULATIONS; t++) {
+            printf("  %-6s / %-5s", get_modulation_name[c], get_modulation_name[t]);
+            for (uint32_t s = 0; s < SNR_COUNT; s++) {
+                int snr = snr_list[s];
+                bool noise = (snr == LOCK_NOISE_SNR || snr == LOCK_NOISE_I_SNR);
+                if (noise && t > 0) { printf(" %6s", "-"); continue; }
+                double share = locked_share((modulation_type_t)c, (modulation_type_t)t, snr);
+
+                bool ok = true;
+                if (noise)                                          ok = share < 0.01;
+                else if (c == t && snr >= 6)                        ok = share > 0.99;
+                else if (c != t && snr >= decidable_snr(c, t))      ok = share < 0.01;
+                if (!ok) failures++;
+                printf(" %5.1f%%%s", 100.0 * share, ok ? "" : "!");
+            }
+            printf("\n");
+        }
+    }
+
+    // Probe cost per block, configured for the densest slicer set
+    {
+        demod_config_t cfg = make_config(MOD_16QAM);
+        demod_t demod;
+        demod_init(&demod, cfg);
+        qlu_synth_source_t synth;
+        IqBlock_t block;
+        qlu_source_fill(qlu_synth_source_init(&synth, &cfg, 0), block.i_samples, block.q_samples, PROCESS_BLOCK_SIZE);
+        lock_detector_t det;
+        lock_detector_reset(&det, MOD_16QAM, 0);
+        const uint32_t runs = 200000;
+        volatile bool sink = false;
+        double t0 = now_sec();
+        for (uint32_t r = 0; r < runs; r++) sink ^= lock_probe_block(&det, &block, &demod);
+        double dt = now_sec() - t0;
+        (void)sink;
+        printf("  probe: %.0f ns/block (%u samples)\n", dt / runs * 1e9, LOCK_PROBE_SAMPLES);
+    }
+
+    if (argc > 1) {
+        printf("[lock_bench] streams, locked share and last probe MER per configured modulation\n");
+        for (int a = 1; a < argc; a++) probe_file(argv[a]);
+    }
+
+    printf("[lock_bench] %s\n", failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}
@@ -1,21 +1,58 @@
 /* mcu2_demod_modular.c
    Modular MCU2 BPSK demodulator using configuration header
    Independent of transmitter metadata - only needs link parameters
+
+   Usage:
+     main.exe                       compiled-in COMPLEX_IQ array
+     main.exe [options] SOURCE      any iq_source.h spec:
+                                      FILE             raw capture or SigMF recording
+                                      -                stdin
+                                      tcp://HOST:PORT  connect, tcp://:PORT listens
+                                      synth            random symbols for --mod
+       --format u16|s16|cf32        raw sample format (default u16)
+       --rate HZ                    sampling rate (default 20e6, SigMF wins)
+       --bw HZ                      link bandwidth (default 10e6)
+       --mod BPSK|QPSK|16QAM        modulation (default 16QAM)
+       --bits N                     ADC resolution of u16 captures (default 16)
+       --every N                    progress line every N symbols, 0 = off
+       --pairs N                    stop after N pairs (default: end of source,
+                                    1M pairs for synth)
+       --loop                       restart files at the end (needs --pairs)
+     channel impairments on the source (qlu_impair.h), off unless given:
+       --snr DB                     AWGN at DB against the unit-power constellation
+       --cfo HZ                     carrier offset
+       --pn HZ                      Wiener phase noise linewidth
+       --ppm PPM                    ADC clock offset, + = fast
+       --slip N                     samples skipped/repeated per clock wrap
+                                    (default: samples per symbol)
+       --iq-amp DB, --iq-phase DEG  IQ gain / phase skew (skew.py model)
+       --dc I,Q                     DC offset, normalised units
 */
 
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <time.h>
 
 // #include "complex_bpsk.h"
 #include "complex_qpsk.h"
 #include "complex_qam16.h"
 
-#include "mod_configs.h" 
-#include "slicers.h"
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_source.h"
+#include "iq_source.h"
+#include "qlu_impair.h"
 
 #define PRINT_EVERY_N_SYMBOLS 100
+#define SOURCE_BLOCK_PAIRS    4096
+#define SYNTH_DEFAULT_PAIRS   (1u << 20)
+#define IMPAIR_SEED           0x1A2B3C4Du
+
+static uint32_t print_every_n_symbols = PRINT_EVERY_N_SYMBOLS;
 
 #define COMPLEX_IQ  complex_qam16
 
@@ -25,14 +62,61 @@
 
 #define COMPLEX_IQ_META CONCAT(COMPLEX_IQ, _meta)
 
-void demod_init(demod_t *demod,demod_config_t cfg);
 void print_final_stats(const demod_t *demod);
 void process_sample(demod_t *demod, int16_t i, int16_t q);
-void get_sample(demod_t *demod, int16_t *i, int16_t *q);
+void process_sample_normalized(demod_t *demod, double fi, double fq);
+void process_block(demod_t *demod, const uint16_t *i_raw, const uint16_t *q_raw, uint32_t n);
+void process_mapped_block(demod_t *demod, const iq_block_t *blk);
 static inline void config_print(const demod_config_t *cfg);
+static int run_source(const char *spec, iq_file_format_t format, demod_config_t cfg, uint64_t max_pairs, bool loop,
+                      const qlu_impair_config_t *impair);
 
-int main(void) {
+int main(int argc, char **argv) {
     demod_t demod;
+    const char *spec = NULL;
+    iq_file_format_t format = IQ_FILE_U16;
+    uint64_t max_pairs = 0;
+    bool loop = false;
+    bool impaired = false;
+    qlu_impair_config_t impair = {0};
+    demod_config_t file_cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = 20e6,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = MOD_16QAM
+    };
+
+    for (int a = 1; a < argc; a++) {
+        bool has_value = (a + 1 < argc);
+        if      (strcmp(argv[a], "--format") == 0 && has_value && iq_file_format_from_name(&format, argv[a + 1])) a++;
+        else if (strcmp(argv[a], "--mod") == 0 && has_value && get_modulation_from_name(&file_cfg.modulation, argv[a + 1])) a++;
+        else if (strcmp(argv[a], "--rate")  == 0 && has_value) file_cfg.sampling_rate_hz  = strtod(argv[++a], NULL);
+        else if (strcmp(argv[a], "--bw")    == 0 && has_value) file_cfg.link_bw_hz        = strtod(argv[++a], NULL);
+        else if (strcmp(argv[a], "--bits")  == 0 && has_value) file_cfg.signal_resolution = (uint8_t)atoi(argv[++a]);
+        else if (strcmp(argv[a], "--every") == 0 && has_value) print_every_n_symbols      = (uint32_t)strtoul(argv[++a], NULL, 0);
+        else if (strcmp(argv[a], "--pairs") == 0 && has_value) max_pairs                  = strtoull(argv[++a], NULL, 0);
+        else if (strcmp(argv[a], "--loop")  == 0)              loop                       = true;
+        else if (strcmp(argv[a], "--snr")   == 0 && has_value) { impair.awgn = true; impair.snr_db = strtof(argv[++a], NULL); impaired = true; }
+        else if (strcmp(argv[a], "--cfo")   == 0 && has_value) { impair.cfo_hz         = strtof(argv[++a], NULL); impaired = true; }
+        else if (strcmp(argv[a], "--pn")    == 0 && has_value) { impair.phase_noise_hz = strtof(argv[++a], NULL); impaired = true; }
+        else if (strcmp(argv[a], "--ppm")   == 0 && has_value) { impair.clock_ppm      = strtof(argv[++a], NULL); impaired = true; }
+        else if (strcmp(argv[a], "--slip")  == 0 && has_value) { impair.clock_slip     = (uint16_t)atoi(argv[++a]); impaired = true; }
+        else if (strcmp(argv[a], "--iq-amp")   == 0 && has_value) { impair.iq_amp_db    = strtof(argv[++a], NULL); impaired = true; }
+        else if (strcmp(argv[a], "--iq-phase") == 0 && has_value) { impair.iq_phase_deg = strtof(argv[++a], NULL); impaired = true; }
+        else if (strcmp(argv[a], "--dc")    == 0 && has_value &&
+                 sscanf(argv[a + 1], "%f,%f", &impair.dc_i, &impair.dc_q) == 2) { a++; impaired = true; }
+        else if ((argv[a][0] != '-' || argv[a][1] == '\0') && spec == NULL) spec = argv[a];
+        else {
+            fprintf(stderr, "usage: %s [--format u16|s16|cf32] [--rate HZ] [--bw HZ] [--mod BPSK|QPSK|16QAM]\n"
+                            "          [--bits N] [--every N] [--pairs N] [--loop]\n"
+                            "          [--snr DB] [--cfo HZ] [--pn HZ] [--ppm PPM] [--slip N] [--iq-amp DB] [--iq-phase DEG]\n"
+                            "          [--dc I,Q] [FILE|-|tcp://HOST:PORT|synth]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (spec) return run_source(spec, format, file_cfg, max_pairs, loop, impaired ? &impair : NULL);
     
     demod_config_t cfg = {
         .link_bw_hz = 10e6,
@@ -69,16 +153,19 @@ int main(void) {
            demod.config.samples_per_symbol, 
            COMPLEX_IQ_META.samples_per_symbol);
     
-    scanf("%c");
+    getchar();  // pause before streaming
 
 
 
-    int16_t i, q;
+    qlu_array_source_t array;
+    qlu_source_t *src = qlu_array_source_init(&array, COMPLEX_IQ, COMPLEX_IQ_META.n_samples);
+    uint16_t i_raw[SOURCE_BLOCK_PAIRS], q_raw[SOURCE_BLOCK_PAIRS];
     uint32_t max_iterations = 3600;
 
-    for (size_t iter=0; iter < max_iterations; iter++){
-        get_sample(&demod, &i, &q);
-        process_sample(&demod, i, q);
+    while (src->pairs < max_iterations) {
+        uint32_t want = max_iterations - (uint32_t)src->pairs;
+        if (want > SOURCE_BLOCK_PAIRS) want = SOURCE_BLOCK_PAIRS;
+        process_block(&demod, i_raw, q_raw, qlu_source_fill(src, i_raw, q_raw, want));
     }
 
     print_final_stats(&demod);
@@ -93,50 +180,144 @@ int main(void) {
     return 0;
 }
 
-void demod_init(demod_t *demod,demod_config_t cfg) {
-    demod->config                  = cfg;
-    demod->scale                   = config_get_scale_factor(&demod->config);
-    demod->stream_idx              = 0;
-    demod->sym                     = (symbol_acc_t){0, 0, 0};
-    demod->sum_symbol_signal_power = 0.0;
-    demod->sum_symbol_error_power  = 0.0;
-    demod->symbol_count            = 0;
-    demod->sum_sample_signal_power = 0.0;
-    demod->sum_sample_error_power  = 0.0;
-    demod->sample_count            = 0;
-}
+static int run_source(const char *spec, iq_file_format_t format, demod_config_t cfg, uint64_t max_pairs, bool loop,
+                      const qlu_impair_config_t *impair) {
+    demod_t demod;
+    iq_source_t source;
+    qlu_impaired_source_t impaired;
+    static uint16_t i_raw[SOURCE_BLOCK_PAIRS], q_raw[SOURCE_BLOCK_PAIRS];
+    struct timespec t0, t1;
 
-static inline int32_t uint16_to_signed(uint16_t raw, uint8_t resolution) {
-    uint32_t max_uint = ((1u << resolution) - 1u);
-    uint32_t half = max_uint / 2u;
-    int32_t tmp = (int32_t)raw - (int32_t)half;
-    if (tmp < -32768) tmp = -32768;
-    if (tmp >  32767) tmp =  32767;
-    return tmp;
-}
+    config_calculate_derived(&cfg);
+    qlu_source_t *src = iq_source_open(&source, spec, format, &cfg, loop && max_pairs > 0);
+    if (!src) return 1;
 
-void get_sample(demod_t *demod, int16_t *i, int16_t *q) {
-    uint32_t total_entries = COMPLEX_IQ_META.n_samples;
+    if (src->ops == &iq_file_source_ops && source.file.file.sample_rate_hz > 0.0) {
+        cfg.sampling_rate_hz = source.file.file.sample_rate_hz;
+        config_calculate_derived(&cfg);
+    }
+    if (src->ops == &qlu_synth_source_ops && max_pairs == 0) max_pairs = SYNTH_DEFAULT_PAIRS;
+    demod_init(&demod, cfg);
+
+    qlu_impair_config_t impair_cfg = {0};
+    if (impair) {
+        impair_cfg = *impair;
+        impair_cfg.sample_rate_hz = (float)cfg.sampling_rate_hz;
+        if (impair_cfg.clock_slip == 0) impair_cfg.clock_slip = (uint16_t)ceil(cfg.samples_per_symbol);
+        src = qlu_impaired_source_init(&impaired, src, &cfg, &impair_cfg, IMPAIR_SEED);
+    }
 
-    if (demod->stream_idx >= total_entries) 
-        demod->stream_idx = 0;
+    printf("========================================================================\n");
+    printf("  MCU2 - Independent Demodulator (%s input)\n", qlu_source_name(src));
+    printf("========================================================================\n");
+    printf("  Source:                 %s\n", spec);
+    if (src->ops == &iq_file_source_ops) {
+        printf("  Format:                 %s, %llu I/Q pairs (%.1f MB, mmap)\n",
+               iq_file_format_name[source.file.file.format], (unsigned long long)source.file.file.n_pairs,
+               source.file.file.size / 1e6);
+    } else if (src->ops == &iq_fd_source_ops) {
+        printf("  Format:                 %s stream\n", iq_file_format_name[format]);
+    }
+    if (impair) {
+        printf("  Impairments:            ");
+        if (impair_cfg.awgn)                 printf("SNR %.1f dB  ", impair_cfg.snr_db);
+        if (impair_cfg.cfo_hz != 0.0f)       printf("CFO %.1f Hz  ", impair_cfg.cfo_hz);
+        if (impair_cfg.phase_noise_hz != 0.0f) printf("PN %.1f Hz  ", impair_cfg.phase_noise_hz);
+        if (impair_cfg.clock_ppm != 0.0f)    printf("clock %+.1f ppm (slip %u)  ", impair_cfg.clock_ppm, impair_cfg.clock_slip);
+        if (impaired.imp.skew)               printf("IQ %.2f dB / %.2f deg  ", impair_cfg.iq_amp_db, impair_cfg.iq_phase_deg);
+        if (impaired.imp.dc)                 printf("DC %.3f,%.3f", impair_cfg.dc_i, impair_cfg.dc_q);
+        printf("\n");
+    }
+    config_print(&demod.config);
+    printf("========================================================================\n\n");
+
+    // A mapped file with nothing in between is read in place; streams and
+    // impaired sources go through the converting read()
+    bool mapped = (src->ops == &iq_file_source_ops);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (;;) {
+        uint32_t want = SOURCE_BLOCK_PAIRS;
+        if (max_pairs && max_pairs - src->pairs < want) want = (uint32_t)(max_pairs - src->pairs);
+        if (want == 0) break;
+
+        if (mapped) {
+            iq_block_t blk;
+            if (!iq_file_source_next(&source.file, &blk, want)) break;
+            process_mapped_block(&demod, &blk);
+        } else {
+            uint32_t n = qlu_source_read(src, i_raw, q_raw, want);
+            if (n == 0) break;
+            process_block(&demod, i_raw, q_raw, n);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
 
-    uint16_t raw_i = COMPLEX_IQ[demod->stream_idx++];
-    if (demod->stream_idx >= total_entries)
-        demod->stream_idx = 0;
-    uint16_t raw_q = COMPLEX_IQ[demod->stream_idx++];
+    double sec = (double)(t1.tv_sec - t0.tv_sec) + 1e-9 * (double)(t1.tv_nsec - t0.tv_nsec);
+    uint64_t pairs = src->pairs;
+    print_final_stats(&demod);
+    printf("\nTHROUGHPUT:\n");
+    printf("  Processed:              %llu pairs in %.3f s%s\n", (unsigned long long)pairs, sec,
+           mapped ? " (mapped, in place)" : "");
+    if (mapped) {
+        printf("  Rate:                   %.2f Msps, %.1f MB/s\n", pairs / sec / 1e6,
+               pairs * (double)iq_file_pair_bytes[source.file.file.format] / sec / 1e6);
+    } else {
+        printf("  Rate:                   %.2f Msps\n", pairs / sec / 1e6);
+    }
 
-    *i = (int16_t)uint16_to_signed(raw_i, demod->config.signal_resolution);
-    *q = (int16_t)uint16_to_signed(raw_q, demod->config.signal_resolution);
-    
+    qlu_source_close(src);
+    return 0;
 }
 
 
 void process_sample(demod_t *demod, int16_t i, int16_t q) {
     // Convert to normalized floating point
-    double fi = (double)i / demod->scale;
-    double fq = (double)q / demod->scale;
+    process_sample_normalized(demod, (double)i / demod->scale, (double)q / demod->scale);
+}
+
+// Offset-binary block from a qlu_source_t, as the firmware DSP block carries
+void process_block(demod_t *demod, const uint16_t *i_raw, const uint16_t *q_raw, uint32_t n) {
+    for (uint32_t k = 0; k < n; k++) {
+        process_sample(demod,
+                       (int16_t)uint16_to_signed(i_raw[k], demod->config.signal_resolution),
+                       (int16_t)uint16_to_signed(q_raw[k], demod->config.signal_resolution));
+    }
+}
+
+// Mapped file block, read in place: the format is resolved once per block
+// and cf32 goes to the slicer as the float it is
+void process_mapped_block(demod_t *demod, const iq_block_t *blk) {
+    switch (blk->format) {
+        case IQ_FILE_U16: {
+            const uint16_t *s = blk->data;
+            for (uint32_t k = 0; k < blk->n_pairs; k++) {
+                process_sample(demod,
+                               (int16_t)uint16_to_signed(s[2 * k],     demod->config.signal_resolution),
+                               (int16_t)uint16_to_signed(s[2 * k + 1], demod->config.signal_resolution));
+            }
+            break;
+        }
+        case IQ_FILE_S16: {
+            const int16_t *s = blk->data;
+            for (uint32_t k = 0; k < blk->n_pairs; k++) {
+                process_sample(demod, s[2 * k], s[2 * k + 1]);
+            }
+            break;
+        }
+        case IQ_FILE_CF32: {
+            const float *s = blk->data;
+            for (uint32_t k = 0; k < blk->n_pairs; k++) {
+                process_sample_normalized(demod, s[2 * k], s[2 * k + 1]);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
 
+void process_sample_normalized(demod_t *demod, double fi, double fq) {
     /* === PRE-FILTER SNR (Sample Level) === */
     SlicerResult result = get_slicer_by_mod[demod->config.modulation](fi,fq);
     double sample_error_i = fi - result.ideal_i;
@@ -173,7 +354,7 @@ void process_sample(demod_t *demod, int16_t i, int16_t q) {
         demod->sym.acc_q = 0.0;
         demod->sym.count = 0;
 
-        if ((demod->symbol_count % PRINT_EVERY_N_SYMBOLS) == 0) {
+        if (print_every_n_symbols && (demod->symbol_count % print_every_n_symbols) == 0) {
             
             // double avg_sym_sig_power = demod->sum_symbol_signal_power / demod->symbol_count;
             double avg_sym_sig_power = GET_AVG_POWER(demod,symbol,signal);
@@ -0,0 +1,182 @@
+/* scenario_gen.c
+   Real-time I/Q generator driven by a scenario script
+   (QLU/includes/qlu_scenario.h), replacing the simulator's fixed MER:/SKEW:
+   arrays with continuously varying conditions
+   - synthetic symbols for --mod through the scripted impairments, written
+     to stdout as v2 frames of GEN_FRAME_PAIRS pairs (what sdr_simulator.ino
+     sends over SPI) or, with --raw, as interleaved u16 pairs
+   - paced to the wall clock at --pair-rate; the default is the 1 MHz SPI
+     link at the frame's sample width. Scenario time is the pair count, so
+     a run is the same stream whatever the pacing; --fast drops the pacing
+   - one status line per scenario second on stderr
+
+       scenario_gen.exe --fast --seconds 60 scenarios/rain_fade.scn > fade.bin
+       frame_replay.exe fade.bin
+       scenario_gen.exe scenarios/rain_fade.scn | QLU_HOST_IQ=- build-host/QLU_host
+       scenario_gen.exe --raw --fast scenarios/lnb_rotation.scn | main.exe -
+
+   Usage: scenario_gen.exe [--mod M] [--bits 16|12|8] [--raw] [--pair-rate HZ]
+                           [--fast] [--seconds S] SCRIPT
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_source.h"
+#include "qlu_impair.h"
+#include "qlu_scenario.h"
+#include "qlu_sync.h"
+#include "qlu_iqpack.h"
+#include "qlu_crc32.h"
+#include "scenario_file.h"
+
+#define GEN_SPI_HZ       1e6
+#define GEN_FRAME_PAIRS  256
+#define GEN_FRAME_MAX    (SYNC_V2_HEADER_SIZE + GEN_FRAME_PAIRS * 4 + SYNC_V2_CRC_SIZE)
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);  p[3] = (uint8_t)v;
+}
+
+static size_t write_frame(uint8_t* fr, sync_sample_format_t format, uint32_t seq,
+                          const uint16_t* i_in, const uint16_t* q_in) {
+    uint32_t len = iq_payload_bytes(format, GEN_FRAME_PAIRS);
+    fr[0] = 0xFE; fr[1] = 0xCA; fr[2] = 0xFE; fr[3] = 0xCA;
+    fr[4] = SYNC_V2_VERSION;
+    fr[5] = iq_format_byte(format);
+    fr[6] = (uint8_t)(len >> 8);
+    fr[7] = (uint8_t)len;
+    put_be32(fr + 8, seq);
+    iq_pack_kernels[format](i_in, q_in, fr + SYNC_V2_HEADER_SIZE, GEN_FRAME_PAIRS);
+    put_be32(fr + SYNC_V2_HEADER_SIZE + len,
+             qlu_crc32(fr + SYNC_MARKER_SIZE, SYNC_V2_HEADER_SIZE - SYNC_MARKER_SIZE + len));
+    return SYNC_V2_HEADER_SIZE + len + SYNC_V2_CRC_SIZE;
+}
+
+static bool write_all(const void* data, size_t len) {
+    const uint8_t* p = data;
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;          // reader went away
+        p   += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static void sleep_until(const struct timespec* t0, double sec) {
+    struct timespec at = *t0;
+    at.tv_sec  += (time_t)sec;
+    at.tv_nsec += (long)((sec - floor(sec)) * 1e9);
+    if (at.tv_nsec >= 1000000000L) { at.tv_sec++; at.tv_nsec -= 1000000000L; }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &at, NULL) == EINTR) {}
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "usage: %s [--mod BPSK|QPSK|16QAM] [--bits 16|12|8] [--raw] [--pair-rate HZ]\n"
+                    "          [--fast] [--seconds S] SCRIPT\n", prog);
+}
+
+int main(int argc, char** argv) {
+    static qlu_scenario_t sc;
+    qlu_synth_source_t synth;
+    qlu_impaired_source_t impaired;
+    qlu_scenario_source_t scenario;
+    static uint16_t i_buf[GEN_FRAME_PAIRS], q_buf[GEN_FRAME_PAIRS];
+    static uint8_t frame[GEN_FRAME_MAX];
+
+    modulation_type_t mod = MOD_16QAM;
+    sync_sample_format_t format = SYNC_FMT_IQ16_BE;
+    const char* script = NULL;
+    double pair_rate = 0.0, seconds = 0.0;
+    bool raw = false, fast = false;
+
+    for (int a = 1; a < argc; a++) {
+        bool has_value = (a + 1 < argc);
+        if      (strcmp(argv[a], "--mod") == 0 && has_value && get_modulation_from_name(&mod, argv[a + 1])) a++;
+        else if (strcmp(argv[a], "--bits") == 0 && has_value) {
+            int bits = atoi(argv[++a]);
+            format = (bits == 8) ? SYNC_FMT_IQ8 : (bits == 12) ? SYNC_FMT_IQ12 : SYNC_FMT_IQ16_BE;
+        }
+        else if (strcmp(argv[a], "--raw")       == 0)              raw       = true;
+        else if (strcmp(argv[a], "--fast")      == 0)              fast      = true;
+        else if (strcmp(argv[a], "--pair-rate") == 0 && has_value) pair_rate = strtod(argv[++a], NULL);
+        else if (strcmp(argv[a], "--seconds")   == 0 && has_value) seconds   = strtod(argv[++a], NULL);
+        else if (argv[a][0] != '-' && script == NULL)              script    = argv[a];
+        else { usage(argv[0]); return 2; }
+    }
+    if (!script) { usage(argv[0]); return 2; }
+    if (!scenario_file_load(&sc, script)) return 1;
+
+    // Pairs per second of the SPI link: payload share of each frame
+    uint32_t frame_bytes = SYNC_V2_HEADER_SIZE + iq_payload_bytes(format, GEN_FRAME_PAIRS) + SYNC_V2_CRC_SIZE;
+    if (pair_rate <= 0.0) pair_rate = GEN_SPI_HZ / 8.0 / frame_bytes * GEN_FRAME_PAIRS;
+    if (seconds <= 0.0 && !sc.loop) seconds = sc.duration;
+
+    demod_config_t cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = 20e6,
+        .decimation = 1,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = mod
+    };
+    config_calculate_derived(&cfg);
+
+    qlu_impair_config_t base = {
+        .sample_rate_hz = (float)cfg.sampling_rate_hz,
+        .clock_slip     = (uint16_t)ceil(cfg.samples_per_symbol),
+    };
+    qlu_impaired_source_init(&impaired, qlu_synth_source_init(&synth, &cfg, 0), &cfg, &base, 0);
+    qlu_source_t* src = qlu_scenario_source_init(&scenario, &impaired, &sc, pair_rate);
+
+    signal(SIGPIPE, SIG_IGN);
+    fprintf(stderr, "[scenario_gen] %s: %s, %s, %.0f pairs/s%s, %s\n",
+            sc.name[0] ? sc.name : script, get_modulation_name[mod], raw ? "raw u16" : "v2 frames",
+            pair_rate, fast ? " (unpaced)" : "", seconds > 0.0 ? "until the end" : "looping");
+
+    struct timespec t0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    uint32_t seq = 0;
+    double next_status = 0.0;
+
+    for (;;) {
+        double t = (double)src->pairs / pair_rate;
+        if (seconds > 0.0 && t >= seconds) break;
+        if (!fast) sleep_until(&t0, t);
+
+        qlu_source_fill(src, i_buf, q_buf, GEN_FRAME_PAIRS);
+        bool ok;
+        if (raw) {
+            uint16_t pairs[2 * GEN_FRAME_PAIRS];
+            for (uint32_t k = 0; k < GEN_FRAME_PAIRS; k++) { pairs[2 * k] = i_buf[k]; pairs[2 * k + 1] = q_buf[k]; }
+            ok = write_all(pairs, sizeof(pairs));
+        } else {
+            ok = write_all(frame, write_frame(frame, format, seq++, i_buf, q_buf));
+        }
+        if (!ok) break;
+
+        if (t >= next_status) {
+            const qlu_impair_config_t* c = &scenario.now;
+            fprintf(stderr, "[scenario_gen] t %7.1f s  SNR %5.1f dB  CFO %7.1f Hz  PN %5.1f Hz  %+6.1f ppm  IQ %4.2f dB / %5.2f deg\n",
+                    scenario.t, c->awgn ? c->snr_db : INFINITY, c->cfo_hz, c->phase_noise_hz, c->clock_ppm,
+                    c->iq_amp_db, c->iq_phase_deg);
+            next_status += 1.0;
+        }
+    }
+
+    qlu_source_close(src);
+    return 0;
+}
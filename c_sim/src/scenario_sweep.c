@@ -0,0 +1,411 @@
+/* scenario_sweep.c
+   Regression sweep of the DSP metrics (QLU/includes/qlu_metrics.h) over the
+   gen_streamv2.py grid: 20 SNRs x 3 modulations x 4 skew scenarios
+   - every scenario is synthesised with the same link model as the Python
+     generator (symbols held sps samples, AWGN, then IQ skew, 16-bit offset
+     binary at the converter scale), or read from the raw captures written
+     next to the headers (--dir sdr_simulator/headers)
+   - a pthread worker pool takes scenarios off a shared counter; each worker
+     owns its demod, metrics engine and RNG, results go to per-scenario slots
+   - measured SNR, MER, skew score and SQI are compared with the values the
+     link model predicts; scenarios where the slicer makes decision errors
+     (biased decision-directed estimates) are reported but not checked
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_metrics.h"
+#include "iq_file.h"
+
+#define SWEEP_BLOCKS       300
+#define SWEEP_MAX_THREADS  64
+#define SWEEP_SNR_FIRST    1
+#define SWEEP_SNR_LAST     39
+#define SWEEP_SNR_STEP     2
+#define SWEEP_SNR_COUNT    ((SWEEP_SNR_LAST - SWEEP_SNR_FIRST) / SWEEP_SNR_STEP + 1)
+
+// Checked only where every distorted point sits this many noise sigmas
+// away from a decision threshold
+#define DECISION_MARGIN_SIGMAS 4.5
+
+// The skew score takes |amplitude| and |phase| of estimates made over the
+// ~7k-sample decayed window, which biases it 5-10 pts low even without skew
+#define TOL_SNR_DB   1.0
+#define TOL_MER_DB   1.0
+#define TOL_SKEW_PTS 12.0
+#define TOL_SQI_PTS  4.0
+
+typedef struct {
+    const char* label;
+    double phase_deg;
+    double amp_db;
+} skew_scenario_t;
+
+// gen_streamv2.py SKEW_SCENARIOS
+static const skew_scenario_t skew_scenarios[] = {
+    { "perfect",            0.0, 0.0 },
+    { "moderate_phase",     8.0, 0.0 },
+    { "combined_moderate",  6.0, 0.8 },
+    { "combined_severe",   12.0, 2.0 },
+};
+#define SKEW_COUNT (sizeof(skew_scenarios) / sizeof(skew_scenarios[0]))
+
+// File name labels of gen_streamv2.py
+static const char* mod_file_label[] = {
+    [MOD_BPSK]  = "bpsk",
+    [MOD_QPSK]  = "qpsk",
+    [MOD_16QAM] = "qam16"
+};
+
+#define SCENARIO_COUNT (SWEEP_SNR_COUNT * MOD_NUM_MODULATIONS * SKEW_COUNT)
+
+typedef struct {
+    modulation_type_t mod;
+    uint32_t skew;
+    int      snr_db;
+} scenario_t;
+
+typedef struct {
+    double snr, mer, skew, sqi;
+} metric_set_t;
+
+typedef struct {
+    metric_set_t meas;
+    metric_set_t nom;
+    double   skew_applied;     // score of the applied imbalance itself
+    double   stability;
+    bool     checked;
+    bool     pass;
+    bool     loaded;           // input found (always true when synthesised)
+} scenario_result_t;
+
+typedef struct {
+    const char*       dir;
+    uint32_t          blocks;
+    atomic_uint       next;
+    scenario_result_t results[SCENARIO_COUNT];
+} sweep_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static scenario_t scenario_at(uint32_t idx) {
+    scenario_t s;
+    s.skew   = idx % SKEW_COUNT;
+    idx     /= SKEW_COUNT;
+    s.mod    = (modulation_type_t)(idx % MOD_NUM_MODULATIONS);
+    idx     /= MOD_NUM_MODULATIONS;
+    s.snr_db = SWEEP_SNR_FIRST + (int)idx * SWEEP_SNR_STEP;
+    return s;
+}
+
+static demod_config_t sweep_config(modulation_type_t mod) {
+    demod_config_t cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = 20e6,
+        .decimation = 1,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = mod
+    };
+    config_calculate_derived(&cfg);
+    return cfg;
+}
+
+// ---- Link model ------------------------------------------------------------
+
+typedef struct {
+    double m00, m01, m10, m11;     // apply_iq_skew as a 2x2 matrix
+    double gain_sq;                // (1 + alpha)²
+} skew_matrix_t;
+
+static skew_matrix_t skew_matrix(const skew_scenario_t* sk) {
+    double half = 0.5 * sk->phase_deg * M_PI / 180.0;
+    double g    = pow(10.0, sk->amp_db / 20.0);
+    return (skew_matrix_t){
+        .m00 =  g * cos(half), .m01 = g * sin(half),
+        .m10 = -sin(half),     .m11 = cos(half),
+        .gain_sq = g * g
+    };
+}
+
+static uint32_t constellation(modulation_type_t mod, double* pi, double* pq) {
+    uint32_t n = 0;
+    switch (mod) {
+        case MOD_BPSK:
+            pi[n] =  1.0; pq[n++] = 0.0;
+            pi[n] = -1.0; pq[n++] = 0.0;
+            break;
+        case MOD_QPSK:
+            for (int a = -1; a <= 1; a += 2)
+                for (int b = -1; b <= 1; b += 2) { pi[n] = a * QPSK_NORM; pq[n++] = b * QPSK_NORM; }
+            break;
+        default:
+            for (int a = -3; a <= 3; a += 2)
+                for (int b = -3; b <= 3; b += 2) { pi[n] = a * QAM16_NORM; pq[n++] = b * QAM16_NORM; }
+            break;
+    }
+    return n;
+}
+
+// Distance from v to the nearest decision threshold of one slicer axis
+static double threshold_distance(modulation_type_t mod, double v, bool q_axis) {
+    if (mod == MOD_BPSK && q_axis) return INFINITY;
+    double d = fabs(v);
+    if (mod == MOD_16QAM) d = fmin(d, fabs(fabs(v) - 2.0 * QAM16_NORM));
+    return d;
+}
+
+/* What the metrics converge to for this link model, assuming no decision
+   errors: the skew distortion d = M·s - s is deterministic per point, the
+   noise goes through M as well (the generator skews the noisy signal) */
+static void nominal_metrics(const scenario_t* s, const demod_config_t* cfg, double stability,
+                            metric_set_t* nom, double* skew_applied, bool* checkable) {
+    double pi[16], pq[16];
+    const skew_scenario_t* sk = &skew_scenarios[s->skew];
+    skew_matrix_t m = skew_matrix(sk);
+    uint32_t n = constellation(s->mod, pi, pq);
+    const double sps    = ceil(cfg->samples_per_symbol);
+    const double sigma2 = pow(10.0, -s->snr_db / 10.0);     // unit signal power
+    double d_ii = 0.0, d_qq = 0.0, d_iq = 0.0, margin = INFINITY;
+
+    for (uint32_t k = 0; k < n; k++) {
+        double yi = m.m00 * pi[k] + m.m01 * pq[k];
+        double yq = m.m10 * pi[k] + m.m11 * pq[k];
+        double di = yi - pi[k], dq = yq - pq[k];
+        d_ii += di * di / n;
+        d_qq += dq * dq / n;
+        d_iq += di * dq / n;
+        SlicerResult r = get_slicer_by_mod[s->mod](yi, yq);
+        if (fabs(r.ideal_i - pi[k]) > 1e-6 || fabs(r.ideal_q - pq[k]) > 1e-6) margin = 0.0;
+        margin = fmin(margin, threshold_distance(s->mod, yi, false) / sqrt(m.gain_sq));
+        margin = fmin(margin, threshold_distance(s->mod, yq, true));
+    }
+
+    double noise_i = 0.5 * sigma2 * m.gain_sq;
+    double noise_q = 0.5 * sigma2;
+    nom->snr = -10.0 * log10(d_ii + d_qq + noise_i + noise_q);
+    nom->mer = -10.0 * log10(d_ii + d_qq + (noise_i + noise_q) / sps);
+
+    double pwr_i = d_ii + noise_i, pwr_q = d_qq + noise_q;
+    double amp_db = 10.0 * log10((pwr_i + 1e-12) / (pwr_q + 1e-12));
+    double arg = fmax(-1.0, fmin(1.0, 2.0 * d_iq / (sqrt(pwr_i * pwr_q) + 1e-12)));
+    nom->skew = calculate_skew_score(amp_db, asin(arg) * 180.0 / M_PI);
+
+    double cn0 = nom->mer + 10.0 * log10(metrics_symbol_rate_hz(cfg));
+    nom->sqi = calculate_sqi(normalize_mer(nom->mer, s->mod), normalize_cn0(cn0), nom->skew, stability);
+
+    *skew_applied = calculate_skew_score(sk->amp_db, sk->phase_deg);
+    *checkable = margin >= DECISION_MARGIN_SIGMAS * sqrt(0.5 * sigma2);
+}
+
+// ---- Sources ---------------------------------------------------------------
+
+typedef struct {
+    uint64_t state;
+    modulation_type_t mod;
+    skew_matrix_t m;
+    double   sigma;            // per component
+    double   scale;
+    uint32_t sps;
+    uint32_t hold;             // samples left of the current symbol
+    double   si, sq;
+} synth_t;
+
+static uint32_t synth_rng(synth_t* g) {
+    g->state ^= g->state << 13;
+    g->state ^= g->state >> 7;
+    g->state ^= g->state << 17;
+    return (uint32_t)(g->state >> 32);
+}
+
+static double synth_gauss(synth_t* g) {
+    double u1 = ((synth_rng(g) >> 8) + 1.0) / 16777217.0;
+    double u2 = (synth_rng(g) >> 8) / 16777216.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static void synth_init(synth_t* g, const scenario_t* s, const demod_t* d, uint32_t idx) {
+    g->state = 0x9E3779B97F4A7C15ull ^ ((uint64_t)(idx + 1) * 0xD1B54A32D192ED03ull);
+    g->mod   = s->mod;
+    g->m     = skew_matrix(&skew_scenarios[s->skew]);
+    g->sigma = sqrt(0.5 * pow(10.0, -s->snr_db / 10.0));
+    g->scale = d->scale;
+    g->sps   = (uint32_t)ceil(d->config.samples_per_symbol);
+    g->hold  = 0;
+}
+
+static uint16_t to_offset_binary(double v, double scale) {
+    double x = nearbyint(32767.0 + v * scale);
+    return (uint16_t)fmin(fmax(x, 0.0), 65535.0);
+}
+
+static void synth_block(synth_t* g, uint16_t* i_out, uint16_t* q_out) {
+    for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++) {
+        if (g->hold == 0) {
+            uint32_t bits = synth_rng(g);
+            switch (g->mod) {
+                case MOD_BPSK: g->si = (bits & 1u) ? 1.0 : -1.0; g->sq = 0.0; break;
+                case MOD_QPSK: g->si = (bits & 1u) ? QPSK_NORM : -QPSK_NORM;
+                               g->sq = (bits & 2u) ? QPSK_NORM : -QPSK_NORM; break;
+                default:       g->si = (2.0 * (bits & 3u) - 3.0) * QAM16_NORM;
+                               g->sq = (2.0 * ((bits >> 2) & 3u) - 3.0) * QAM16_NORM; break;
+            }
+            g->hold = g->sps;
+        }
+        g->hold--;
+        double ni = g->si + g->sigma * synth_gauss(g);
+        double nq = g->sq + g->sigma * synth_gauss(g);
+        i_out[k] = to_offset_binary(g->m.m00 * ni + g->m.m01 * nq, g->scale);
+        q_out[k] = to_offset_binary(g->m.m10 * ni + g->m.m11 * nq, g->scale);
+    }
+}
+
+// Capture blocks loop over the file, as the simulator loops its arrays
+static void capture_block(const iq_file_t* f, uint64_t* pos, uint16_t* i_out, uint16_t* q_out) {
+    const uint16_t* s = (const uint16_t*)f->map;
+    for (uint32_t k = 0; k < PROCESS_BLOCK_SIZE; k++) {
+        if (*pos >= f->n_pairs) *pos = 0;
+        i_out[k] = s[2 * *pos];
+        q_out[k] = s[2 * *pos + 1];
+        (*pos)++;
+    }
+}
+
+// ---- Workers ---------------------------------------------------------------
+
+static void run_scenario(sweep_t* sw, uint32_t idx) {
+    scenario_t s = scenario_at(idx);
+    scenario_result_t* r = &sw->results[idx];
+    uint16_t i_buf[PROCESS_BLOCK_SIZE], q_buf[PROCESS_BLOCK_SIZE];
+    demod_t demod;
+    metrics_engine_t metrics;
+    synth_t synth;
+    iq_file_t file = {0};
+    uint64_t file_pos = 0;
+
+    demod_init(&demod, sweep_config(s.mod));
+    metrics_engine_init(&metrics, &demod);
+
+    if (sw->dir) {
+        char path[IQ_FILE_PATH_MAX];
+        snprintf(path, sizeof(path), "%s/complex_%s_%s_%d.u16",
+                 sw->dir, mod_file_label[s.mod], skew_scenarios[s.skew].label, s.snr_db);
+        if (iq_file_open_raw(&file, path, IQ_FILE_U16) != 0) return;
+    } else {
+        synth_init(&synth, &s, &demod, idx);
+    }
+
+    for (uint32_t b = 0; b < sw->blocks; b++) {
+        if (sw->dir) capture_block(&file, &file_pos, i_buf, q_buf);
+        else         synth_block(&synth, i_buf, q_buf);
+        metrics_engine_process_block(&metrics, &demod, i_buf, q_buf, PROCESS_BLOCK_SIZE);
+        metrics_engine_finalize_block(&metrics, &demod, PROCESS_BLOCK_SIZE);
+    }
+    if (sw->dir) iq_file_close(&file);
+
+    r->loaded    = true;
+    r->meas      = (metric_set_t){ metrics.smooth_snr, metrics.smooth_mer, metrics.smooth_skew, metrics.smooth_sqi };
+    r->stability = metrics.smooth_stability;
+    nominal_metrics(&s, &demod.config, r->stability, &r->nom, &r->skew_applied, &r->checked);
+
+    r->pass = !r->checked ||
+              (fabs(r->meas.snr  - r->nom.snr)  <= TOL_SNR_DB &&
+               fabs(r->meas.mer  - r->nom.mer)  <= TOL_MER_DB &&
+               fabs(r->meas.skew - r->nom.skew) <= TOL_SKEW_PTS &&
+               fabs(r->meas.sqi  - r->nom.sqi)  <= TOL_SQI_PTS);
+}
+
+static void* worker(void* arg) {
+    sweep_t* sw = arg;
+    for (;;) {
+        uint32_t idx = atomic_fetch_add(&sw->next, 1u);
+        if (idx >= SCENARIO_COUNT) return NULL;
+        run_scenario(sw, idx);
+    }
+}
+
+static uint32_t online_cpus(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n < 1) ? 1u : (uint32_t)n;
+}
+
+int main(int argc, char** argv) {
+    static sweep_t sw;
+    uint32_t n_threads = online_cpus();
+    bool quiet = false;
+
+    sw.blocks = SWEEP_BLOCKS;
+    for (int a = 1; a < argc; a++) {
+        if      (strcmp(argv[a], "--threads") == 0 && a + 1 < argc) n_threads = (uint32_t)strtoul(argv[++a], NULL, 0);
+        else if (strcmp(argv[a], "--blocks")  == 0 && a + 1 < argc) sw.blocks = (uint32_t)strtoul(argv[++a], NULL, 0);
+        else if (strcmp(argv[a], "--dir")     == 0 && a + 1 < argc) sw.dir    = argv[++a];
+        else if (strcmp(argv[a], "--quiet")   == 0) quiet = true;
+        else {
+            fprintf(stderr, "usage: %s [--threads N] [--blocks N] [--dir CAPTURE_DIR] [--quiet]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n_threads < 1) n_threads = 1;
+    if (n_threads > SWEEP_MAX_THREADS) n_threads = SWEEP_MAX_THREADS;
+    atomic_init(&sw.next, 0u);
+
+    printf("========================================================================\n");
+    printf("  Scenario sweep  (%u scenarios, %u blocks of %u each, %u threads, %s)\n",
+           (uint32_t)SCENARIO_COUNT, sw.blocks, PROCESS_BLOCK_SIZE, n_threads, sw.dir ? sw.dir : "synthesised");
+    printf("  tolerance: SNR/MER %.1f dB, skew %.0f pts, SQI %.0f pts\n",
+           TOL_SNR_DB, TOL_SKEW_PTS, TOL_SQI_PTS);
+    printf("========================================================================\n");
+
+    pthread_t threads[SWEEP_MAX_THREADS];
+    double t0 = now_sec();
+    for (uint32_t t = 0; t < n_threads; t++) pthread_create(&threads[t], NULL, worker, &sw);
+    for (uint32_t t = 0; t < n_threads; t++) pthread_join(threads[t], NULL);
+    double dt = now_sec() - t0;
+
+    uint32_t checked = 0, failed = 0, missing = 0;
+    if (!quiet) {
+        printf("  %-5s %-18s %3s | %13s | %13s | %17s | %13s | %5s | %s\n",
+               "mod", "skew", "snr", "SNR meas/nom", "MER meas/nom", "skew meas/nom/app", "SQI meas/nom", "stab", "check");
+    }
+    for (uint32_t idx = 0; idx < SCENARIO_COUNT; idx++) {
+        // Printed grouped by modulation and skew, SNR ascending
+        uint32_t per_snr = MOD_NUM_MODULATIONS * SKEW_COUNT;
+        uint32_t group = idx / SWEEP_SNR_COUNT, snr_i = idx % SWEEP_SNR_COUNT;
+        uint32_t slot  = snr_i * per_snr + group;
+        scenario_t s = scenario_at(slot);
+        const scenario_result_t* r = &sw.results[slot];
+
+        if (!r->loaded) { missing++; continue; }
+        if (r->checked) checked++;
+        if (!r->pass)   failed++;
+        if (quiet && r->pass) continue;
+
+        printf("  %-5s %-18s %3d | %5.1f / %5.1f | %5.1f / %5.1f | %5.1f/%5.1f/%5.1f | %5.1f / %5.1f | %5.1f | %s\n",
+               get_modulation_name[s.mod], skew_scenarios[s.skew].label, s.snr_db,
+               r->meas.snr, r->nom.snr, r->meas.mer, r->nom.mer,
+               r->meas.skew, r->nom.skew, r->skew_applied, r->meas.sqi, r->nom.sqi, r->stability,
+               !r->checked ? "-" : (r->pass ? "ok" : "FAIL"));
+    }
+
+    printf("\n  %u scenarios in %.2f s (%.1f Msamples/s), %u checked, %u failed, %u missing\n",
+           (uint32_t)SCENARIO_COUNT - missing, dt,
+           (double)(SCENARIO_COUNT - missing) * sw.blocks * PROCESS_BLOCK_SIZE / dt / 1e6, checked, failed, missing);
+    if (missing)     printf("  FAIL: captures missing\n");
+    else if (failed) printf("  FAIL: metrics drift from the link model\n");
+    else             printf("  OK: metrics track the link model\n");
+    return (failed || missing) ? 1 : 0;
+}
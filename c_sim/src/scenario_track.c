@@ -0,0 +1,266 @@
+/* scenario_track.c
+   Faster-than-real-time run of scenario scripts (QLU/includes/qlu_scenario.h)
+   through the DSP metrics pipeline (QLU/includes/qlu_metrics.h)
+   - synthetic symbols for --mod go through the scripted impairments and into
+     the metrics engine in PROCESS_BLOCK_SIZE blocks, as in the DSP task
+   - timeline every --every seconds: targets against the EMA SNR and MER,
+     stability, skew score and SQI
+   - tracking: every time the SNR or skew target moves, how long after it
+     stops the measurement takes to settle (stay within 10% of the change,
+     at least TRACK_SNR_BAND_DB / TRACK_SKEW_BAND_PTS, of where it ends up);
+     SNR moves must settle before the next one starts
+   - --pair-rate is how many pairs make a scenario second; the default is
+     what the simulator's SPI link delivers, so times match the bench
+   - --csv FILE writes every block
+
+   Usage: scenario_track.exe [options] SCRIPT...
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_metrics.h"
+#include "qlu_source.h"
+#include "qlu_impair.h"
+#include "qlu_scenario.h"
+#include "scenario_file.h"
+
+// 1 MHz SPI, v2 frames of 256 pairs at 16 bits (1024 + 16 bytes)
+#define TRACK_SPI_HZ            1e6
+#define TRACK_PAIR_RATE_DEFAULT (TRACK_SPI_HZ / 8.0 / (1024.0 + 16.0) * 256.0)
+#define TRACK_EVERY_DEFAULT     5.0
+
+#define TRACK_SNR_BAND_DB       0.5
+#define TRACK_SKEW_BAND_PTS     2.0
+#define TRACK_BAND_FRACTION     0.1
+#define TRACK_MOVE_EPS          1e-4        // target change per block that counts as moving
+
+typedef struct {
+    float t;
+    float snr_target, snr, mer;
+    float stability;
+    float skew_target, skew;
+    float sqi;
+} track_point_t;
+
+typedef struct {
+    const char* label;
+    size_t      target_off, meas_off;
+    double      band;
+    bool        must_settle;
+} track_metric_t;
+
+static const track_metric_t track_metrics[] = {
+    { "SNR",  offsetof(track_point_t, snr_target),  offsetof(track_point_t, snr),  TRACK_SNR_BAND_DB,   true  },
+    { "skew", offsetof(track_point_t, skew_target), offsetof(track_point_t, skew), TRACK_SKEW_BAND_PTS, false },
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static float field(const track_point_t* p, size_t off) {
+    return *(const float*)((const char*)p + off);
+}
+
+// Skew score the metrics should converge to for the scripted imbalance
+static float skew_target(const qlu_impair_config_t* c) {
+    return (float)calculate_skew_score(c->iq_amp_db, c->iq_phase_deg);
+}
+
+static bool target_moves(const track_point_t* pts, uint32_t k, size_t off) {
+    return fabsf(field(&pts[k], off) - field(&pts[k - 1], off)) > TRACK_MOVE_EPS;
+}
+
+// Any scripted change moves every measurement (skew costs SNR), so a hold
+// ends with the next move of any target
+static bool any_target_moves(const track_point_t* pts, uint32_t k) {
+    for (uint32_t m = 0; m < sizeof(track_metrics) / sizeof(track_metrics[0]); m++) {
+        if (target_moves(pts, k, track_metrics[m].target_off)) return true;
+    }
+    return false;
+}
+
+/* Every stretch where the target of m moves, then holds until anything
+   moves again: the settled value is the mean measurement over the last quarter of the
+   hold, the settle time runs from the end of the move to the last block
+   outside the band around it. Returns the moves that did not settle. */
+static uint32_t report_tracking(const track_metric_t* m, const track_point_t* pts, uint32_t n, double block_sec) {
+    uint32_t unsettled = 0, moves = 0;
+
+    for (uint32_t k = 1; k < n; ) {
+        if (!target_moves(pts, k, m->target_off)) { k++; continue; }
+
+        uint32_t start = k - 1, end = k;
+        while (end + 1 < n && target_moves(pts, end + 1, m->target_off)) end++;
+        uint32_t hold_end = end + 1;
+        while (hold_end < n && !any_target_moves(pts, hold_end)) hold_end++;
+
+        double settled = 0.0;
+        uint32_t tail = hold_end - (hold_end - end) / 4;
+        if (tail >= hold_end) tail = hold_end - 1;
+        for (uint32_t j = tail; j < hold_end; j++) settled += field(&pts[j], m->meas_off);
+        settled /= (hold_end - tail);
+
+        double from = field(&pts[start], m->meas_off);
+        double band = fmax(m->band, TRACK_BAND_FRACTION * fabs(settled - from));
+        uint32_t last_out = end;
+        for (uint32_t j = end; j < hold_end; j++) {
+            if (fabs(field(&pts[j], m->meas_off) - settled) > band) last_out = j;
+        }
+        // Settled only if the hold has a quarter left after the last excursion
+        bool ok = (hold_end - last_out) * 4 >= (hold_end - end);
+
+        if (moves++ == 0) {
+            printf("  %-5s | %8s | %15s | %7s | %15s | %9s | %s\n",
+                   "", "at s", "target", "move s", "measured", "settle s", "blocks");
+        }
+        printf("  %-5s | %8.2f | %6.1f -> %6.1f | %7.2f | %6.1f -> %6.1f | ",
+               m->label, pts[start].t, field(&pts[start], m->target_off), field(&pts[end], m->target_off),
+               pts[end].t - pts[start].t, from, settled);
+        if (ok) {
+            printf("%9.3f | %u\n", (last_out - end) * block_sec, last_out - end);
+        } else {
+            printf("%9s | %s\n", "-", m->must_settle ? "FAIL" : "not settled");
+            if (m->must_settle) unsettled++;
+        }
+        k = end + 1;
+    }
+    if (moves == 0) printf("  %-5s | target does not move\n", m->label);
+    return unsettled;
+}
+
+static uint32_t run_script(const char* path, modulation_type_t mod, double pair_rate, double every, FILE* csv) {
+    static qlu_scenario_t sc;
+    qlu_synth_source_t synth;
+    qlu_impaired_source_t impaired;
+    qlu_scenario_source_t scenario;
+    demod_t demod;
+    metrics_engine_t metrics;
+    uint16_t i_buf[PROCESS_BLOCK_SIZE], q_buf[PROCESS_BLOCK_SIZE];
+
+    if (!scenario_file_load(&sc, path)) return 1;
+
+    demod_config_t cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = 20e6,
+        .decimation = 1,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = mod
+    };
+    config_calculate_derived(&cfg);
+    demod_init(&demod, cfg);
+    metrics_engine_init(&metrics, &demod);
+
+    qlu_impair_config_t base = {
+        .sample_rate_hz = (float)cfg.sampling_rate_hz,
+        .clock_slip     = (uint16_t)ceil(cfg.samples_per_symbol),
+    };
+    qlu_impaired_source_init(&impaired, qlu_synth_source_init(&synth, &cfg, 0), &cfg, &base, 0);
+    qlu_source_t* src = qlu_scenario_source_init(&scenario, &impaired, &sc, pair_rate);
+
+    double   block_sec = PROCESS_BLOCK_SIZE / pair_rate;
+    uint32_t n_blocks  = (uint32_t)ceil(sc.duration / block_sec);
+    track_point_t* pts = calloc(n_blocks ? n_blocks : 1, sizeof(*pts));
+
+    printf("========================================================================\n");
+    printf("  Scenario %s (%s)  %.1f s, %s, %.0f pairs/s, %u blocks of %u\n",
+           sc.name[0] ? sc.name : "-", path, sc.duration, get_modulation_name[mod], pair_rate, n_blocks, PROCESS_BLOCK_SIZE);
+    printf("========================================================================\n");
+    printf("  %8s | %6s %6s %6s | %6s | %6s %6s | %6s\n",
+           "t s", "SNR*", "SNR", "MER", "stab", "skew*", "skew", "SQI");
+
+    double t0 = now_sec(), next_print = 0.0;
+    for (uint32_t b = 0; b < n_blocks; b++) {
+        if (qlu_source_fill(src, i_buf, q_buf, PROCESS_BLOCK_SIZE) != PROCESS_BLOCK_SIZE) { n_blocks = b; break; }
+        metrics_engine_process_block(&metrics, &demod, i_buf, q_buf, PROCESS_BLOCK_SIZE);
+        metrics_engine_finalize_block(&metrics, &demod, PROCESS_BLOCK_SIZE);
+
+        // Targets as the scenario had them for this block
+        track_point_t* p = &pts[b];
+        p->t           = (float)((b + 1) * block_sec);
+        p->snr_target  = scenario.now.awgn ? scenario.now.snr_db : NAN;
+        p->snr         = (float)metrics.smooth_snr;
+        p->mer         = (float)metrics.smooth_mer;
+        p->stability   = (float)metrics.smooth_stability;
+        p->skew_target = skew_target(&scenario.now);
+        p->skew        = (float)metrics.smooth_skew;
+        p->sqi         = (float)metrics.smooth_sqi;
+
+        if (csv) {
+            fprintf(csv, "%s,%.6f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f\n", sc.name, p->t, p->snr_target, p->snr,
+                    p->mer, p->stability, p->skew_target, p->skew, p->sqi);
+        }
+        if (every > 0.0 && p->t >= next_print) {
+            printf("  %8.2f | %6.1f %6.1f %6.1f | %6.1f | %6.1f %6.1f | %6.1f\n",
+                   p->t, p->snr_target, p->snr, p->mer, p->stability, p->skew_target, p->skew, p->sqi);
+            next_print += every;
+        }
+    }
+    double dt = now_sec() - t0;
+
+    // The EMA alone needs this many blocks to cover 90% of a step
+    uint32_t ema_blocks = (uint32_t)ceil(log(0.1) / log(1.0 - METRICS_EMA_ALPHA));
+    printf("\n  tracking (EMA alone: 90%% of a step in %u blocks = %.3f s; skew every %u blocks)\n",
+           ema_blocks, ema_blocks * block_sec, METRICS_SKEW_EVERY_N_BLOCKS);
+
+    uint32_t unsettled = 0;
+    for (uint32_t m = 0; m < sizeof(track_metrics) / sizeof(track_metrics[0]); m++) {
+        if (m == 0 && !sc.track[QLU_SCN_SNR].n) continue;
+        unsettled += report_tracking(&track_metrics[m], pts, n_blocks, block_sec);
+    }
+    printf("\n  %.1f scenario s in %.2f s (%.0fx real time, %.1f Msamples/s)\n",
+           n_blocks * block_sec, dt, n_blocks * block_sec / dt, n_blocks * (double)PROCESS_BLOCK_SIZE / dt / 1e6);
+
+    free(pts);
+    qlu_source_close(src);
+    return unsettled;
+}
+
+int main(int argc, char** argv) {
+    modulation_type_t mod = MOD_16QAM;
+    double pair_rate = TRACK_PAIR_RATE_DEFAULT;
+    double every = TRACK_EVERY_DEFAULT;
+    FILE* csv = NULL;
+    uint32_t failures = 0, scripts = 0;
+
+    for (int a = 1; a < argc; a++) {
+        bool has_value = (a + 1 < argc);
+        if      (strcmp(argv[a], "--mod") == 0 && has_value && get_modulation_from_name(&mod, argv[a + 1])) a++;
+        else if (strcmp(argv[a], "--pair-rate") == 0 && has_value) pair_rate = strtod(argv[++a], NULL);
+        else if (strcmp(argv[a], "--every")     == 0 && has_value) every     = strtod(argv[++a], NULL);
+        else if (strcmp(argv[a], "--csv")       == 0 && has_value) {
+            if (!(csv = fopen(argv[++a], "w"))) { perror(argv[a]); return 1; }
+            fprintf(csv, "scenario,t,snr_target,snr,mer,stability,skew_target,skew,sqi\n");
+        }
+        else if (argv[a][0] != '-') {
+            if (pair_rate <= 0.0) pair_rate = TRACK_PAIR_RATE_DEFAULT;
+            failures += run_script(argv[a], mod, pair_rate, every, csv);
+            scripts++;
+            printf("\n");
+        }
+        else {
+            fprintf(stderr, "usage: %s [--mod BPSK|QPSK|16QAM] [--pair-rate HZ] [--every S] [--csv FILE] SCRIPT...\n", argv[0]);
+            return 2;
+        }
+    }
+    if (csv) fclose(csv);
+    if (scripts == 0) {
+        fprintf(stderr, "usage: %s [--mod BPSK|QPSK|16QAM] [--pair-rate HZ] [--every S] [--csv FILE] SCRIPT...\n", argv[0]);
+        return 2;
+    }
+
+    printf("  %s\n", failures ? "FAIL: a script did not load or the SNR did not settle" : "OK: the metrics follow every scripted change");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,188 @@
+/* source_bench.c
+   Host check and benchmark for the sample sources (QLU/includes/qlu_source.h,
+   c_sim/includes/iq_source.h)
+   - the same synthetic 16QAM stream goes through every source: written to a
+     temporary file, pushed through a pipe by a child process and sent over a
+     loopback TCP connection; each source must hand back exactly those pairs
+   - times every source on its own, draining it in blocks of BENCH_BLOCK
+     pairs as the demod harness does
+
+   Usage: source_bench.exe [PAIRS]
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define PROCESS_BLOCK_SIZE 256
+#include "qlu_demod.h"
+#include "qlu_source.h"
+#include "iq_source.h"
+
+#define BENCH_PAIRS_DEFAULT (4u << 20)
+#define BENCH_BLOCK         4096
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static uint16_t *ref;       // interleaved u16, n_pairs
+static uint32_t  n_pairs;
+
+/* Drains src against ref (the compare is part of the timed loop); returns mismatches */
+static uint32_t drain(qlu_source_t *src, uint32_t limit, double *sec) {
+    static uint16_t i_out[BENCH_BLOCK], q_out[BENCH_BLOCK];
+    uint32_t bad = 0, pos = 0;
+    volatile uint32_t sink = 0;
+
+    double t0 = now_sec();
+    while (pos < limit) {
+        uint32_t want = (limit - pos < BENCH_BLOCK) ? limit - pos : BENCH_BLOCK;
+        uint32_t got  = qlu_source_read(src, i_out, q_out, want);
+        if (got == 0) break;
+        for (uint32_t k = 0; k < got; k++) {
+            bad += (i_out[k] != ref[2 * (pos + k)]) + (q_out[k] != ref[2 * (pos + k) + 1]);
+        }
+        sink += i_out[got - 1];
+        pos  += got;
+    }
+    *sec = now_sec() - t0;
+    (void)sink;
+    return bad + (limit - pos) * 2;     // missing pairs count as mismatches
+}
+
+static void write_all(int fd, const void *data, size_t len) {
+    const uint8_t *p = data;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n <= 0) _exit(1);
+        p += n;
+        len -= (size_t)n;
+    }
+}
+
+static void report(const char *name, uint32_t pairs, double sec, uint32_t bad, uint32_t *failures) {
+    printf("  %-8s | %10u | %8.3f | %9.1f | %8.1f | %s\n", name, pairs, sec,
+           pairs / sec / 1e6, pairs * 4.0 / sec / 1e6, bad ? "FAIL" : "ok");
+    if (bad) (*failures)++;
+}
+
+int main(int argc, char **argv) {
+    iq_source_t source;
+    uint32_t failures = 0;
+    double sec;
+    char path[] = "/tmp/qlu_source_bench_XXXXXX";
+
+    n_pairs = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_PAIRS_DEFAULT;
+
+    demod_config_t cfg = {
+        .link_bw_hz = 10e6,
+        .sampling_rate_hz = 20e6,
+        .roll_off = 0.25,
+        .signal_resolution = 16,
+        .modulation = MOD_16QAM
+    };
+    config_calculate_derived(&cfg);
+    signal(SIGPIPE, SIG_IGN);
+
+    // Reference stream, and the file every other source is fed from
+    ref = malloc((size_t)n_pairs * 2 * sizeof(uint16_t));
+    {
+        static uint16_t i_out[BENCH_BLOCK], q_out[BENCH_BLOCK];
+        qlu_source_t *synth = qlu_synth_source_init(&source.synth, &cfg, 0);
+        for (uint32_t pos = 0; pos < n_pairs; ) {
+            uint32_t got = qlu_source_read(synth, i_out, q_out, (n_pairs - pos < BENCH_BLOCK) ? n_pairs - pos : BENCH_BLOCK);
+            for (uint32_t k = 0; k < got; k++) { ref[2 * (pos + k)] = i_out[k]; ref[2 * (pos + k) + 1] = q_out[k]; }
+            pos += got;
+        }
+    }
+    int tmp = mkstemp(path);
+    if (tmp < 0) { perror("mkstemp"); return 1; }
+    write_all(tmp, ref, (size_t)n_pairs * 4);
+    close(tmp);
+
+    printf("========================================================================\n");
+    printf("  Sample source bench  (%u pairs, 16QAM, blocks of %u)\n", n_pairs, BENCH_BLOCK);
+    printf("========================================================================\n");
+    printf("  source   |      pairs |        s |  Mpairs/s |     MB/s | check\n");
+
+    // array: the reference itself, wrapping like the compiled-in streams
+    {
+        uint32_t bad = drain(qlu_array_source_init(&source.array, ref, n_pairs * 2), n_pairs, &sec);
+        report("array", n_pairs, sec, bad, &failures);
+    }
+
+    {
+        uint32_t bad = drain(qlu_synth_source_init(&source.synth, &cfg, 0), n_pairs, &sec);
+        report("synth", n_pairs, sec, bad, &failures);
+    }
+
+    {
+        qlu_source_t *src = iq_file_source_open(&source.file, path, IQ_FILE_U16, &cfg, false);
+        uint32_t bad = src ? drain(src, n_pairs, &sec) : 1;
+        if (src) qlu_source_close(src);
+        report("file", n_pairs, sec, bad, &failures);
+    }
+
+    {
+        int p[2];
+        if (pipe(p) != 0) { perror("pipe"); return 1; }
+        pid_t child = fork();
+        if (child == 0) {
+            close(p[0]);
+            write_all(p[1], ref, (size_t)n_pairs * 4);
+            _exit(0);
+        }
+        close(p[1]);
+        qlu_source_t *src = iq_fd_source_init(&source.fd, p[0], true, IQ_FILE_U16, &cfg);
+        uint32_t bad = drain(src, n_pairs, &sec);
+        qlu_source_close(src);
+        waitpid(child, NULL, 0);
+        report("pipe", n_pairs, sec, bad, &failures);
+    }
+
+    {
+        int ls = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in sa = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+        socklen_t sl = sizeof(sa);
+        if (ls < 0 || bind(ls, (struct sockaddr*)&sa, sizeof(sa)) != 0 || listen(ls, 1) != 0 ||
+            getsockname(ls, (struct sockaddr*)&sa, &sl) != 0) {
+            perror("tcp");
+            return 1;
+        }
+        pid_t child = fork();
+        if (child == 0) {
+            char addr[32];
+            snprintf(addr, sizeof(addr), "127.0.0.1:%u", ntohs(sa.sin_port));
+            int fd = iq_source_tcp_connect(addr);
+            if (fd < 0) _exit(1);
+            write_all(fd, ref, (size_t)n_pairs * 4);
+            _exit(0);
+        }
+        int fd = accept(ls, NULL, NULL);
+        close(ls);
+        qlu_source_t *src = iq_fd_source_init(&source.fd, fd, true, IQ_FILE_U16, &cfg);
+        uint32_t bad = drain(src, n_pairs, &sec);
+        qlu_source_close(src);
+        waitpid(child, NULL, 0);
+        report("tcp", n_pairs, sec, bad, &failures);
+    }
+
+    unlink(path);
+    free(ref);
+
+    printf("\n  %s\n", failures ? "FAIL: a source altered the stream" : "OK: every source delivers the same pairs");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,335 @@
+/* sync_bench.c
+   Host benchmark for the SPI frame extractor (QLU/includes/qlu_sync.h)
+   - replays a synthetic DMA ring (frames + inter-frame garbage, random chunk sizes)
+   - runs the legacy byte-wise state machine and the word-wise parser on it
+   - checks both extract the same payloads and reports parser bytes/s
+   - tracking fast path: every frame is either a predicted-offset hit or the
+     result of a (counted) resync
+   - frame v2: injects CRC corruption, dropped sequence numbers and false
+     markers, and checks the parser counters account for every one of them
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "qlu_sync.h"
+#include "qlu_crc32.h"
+
+#define RING_SIZE      4096
+#define PAYLOAD_SIZE   1024
+#define STREAM_FRAMES  20000
+#define MAX_CHUNK      1024
+#define GARBAGE_EVERY  8
+#define MAX_GARBAGE    37
+
+static uint8_t __attribute__((aligned(RING_SIZE))) ring[RING_SIZE];
+
+typedef struct {
+    uint8_t* bytes;
+    size_t   len;
+    uint32_t frames;
+} stream_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t checksum;
+    double   parse_sec;
+    uint32_t track_hits;
+    uint32_t resyncs;
+} bench_result_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static uint32_t rng_state = 0x12345678u;
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32_t fold_checksum(uint32_t acc, const uint8_t* payload) {
+    for (uint32_t k = 0; k < PAYLOAD_SIZE; k++) acc = (acc * 31u) + payload[k];
+    return acc;
+}
+
+/* Same wire format as sdr_simulator.ino, with some garbage between frames */
+static stream_t build_stream(void) {
+    stream_t s;
+    s.bytes  = malloc((size_t)STREAM_FRAMES * (SYNC_MARKER_SIZE + PAYLOAD_SIZE + MAX_GARBAGE));
+    s.len    = 0;
+    s.frames = STREAM_FRAMES;
+    for (uint32_t f = 0; f < STREAM_FRAMES; f++) {
+        if (f % GARBAGE_EVERY == 0) {
+            uint32_t n = rng() % (MAX_GARBAGE + 1);
+            for (uint32_t k = 0; k < n; k++) {
+                uint8_t b = (uint8_t)rng();
+                s.bytes[s.len++] = (b == SYNC_MARKER_BYTE0) ? 0x00 : b;
+            }
+        }
+        s.bytes[s.len++] = 0xFE; s.bytes[s.len++] = 0xCA;
+        s.bytes[s.len++] = 0xFE; s.bytes[s.len++] = 0xCA;
+        for (uint32_t k = 0; k < PAYLOAD_SIZE; k++) s.bytes[s.len++] = (uint8_t)rng();
+    }
+    return s;
+}
+
+/* ---- Legacy extractor (SPISyncedStreamTask before the rewrite) ---------- */
+
+typedef enum { STATE_SYNC_0, STATE_SYNC_1, STATE_SYNC_2, STATE_SYNC_3, STATE_PAYLOAD } SyncState;
+
+typedef struct {
+    uint32_t  tail_index;
+    SyncState current_state;
+    uint16_t  payload_idx;
+    uint8_t   temp_payload_buffer[PAYLOAD_SIZE];
+} legacy_parser_t;
+
+static void legacy_consume(legacy_parser_t* lp, uint32_t head_index, bench_result_t* res) {
+    while (lp->tail_index != head_index) {
+        uint8_t byte = ring[lp->tail_index];
+        lp->tail_index = (lp->tail_index + 1) % RING_SIZE;
+
+        switch (lp->current_state) {
+            case STATE_SYNC_0:
+                if (byte == 0xFE) lp->current_state = STATE_SYNC_1;
+                break;
+            case STATE_SYNC_1:
+                lp->current_state = (byte == 0xCA) ? STATE_SYNC_2 : STATE_SYNC_0;
+                break;
+            case STATE_SYNC_2:
+                lp->current_state = (byte == 0xFE) ? STATE_SYNC_3 : STATE_SYNC_0;
+                break;
+            case STATE_SYNC_3:
+                if (byte == 0xCA) {
+                    lp->current_state = STATE_PAYLOAD;
+                    lp->payload_idx = 0;
+                } else {
+                    lp->current_state = STATE_SYNC_0;
+                }
+                break;
+            case STATE_PAYLOAD:
+                lp->temp_payload_buffer[lp->payload_idx++] = byte;
+                if (lp->payload_idx >= PAYLOAD_SIZE) {
+                    // Checksum is bench bookkeeping, kept out of the parse time
+                    double t0 = now_sec();
+                    res->frames++;
+                    res->checksum = fold_checksum(res->checksum, lp->temp_payload_buffer);
+                    res->parse_sec -= now_sec() - t0;
+                    lp->current_state = STATE_SYNC_0;
+                }
+                break;
+        }
+    }
+}
+
+/* ---- Replay: DMA writes a random-sized chunk, then the parser runs ------- */
+
+static bench_result_t run(const stream_t* s, bool legacy) {
+    static legacy_parser_t lp;
+    static sync_parser_t   parser;
+    static uint8_t         payload[PAYLOAD_SIZE];
+    bench_result_t res = {0};
+    uint32_t written = 0;   // DMA byte count; ring index = written & (RING_SIZE - 1)
+    size_t   pos     = 0;
+
+    memset(&lp, 0, sizeof(lp));
+    sync_parser_init(&parser, ring, RING_SIZE, PAYLOAD_SIZE, SYNC_FRAME_V1, 0);
+    rng_state = 0xCAFEu;
+
+    while (pos < s->len) {
+        size_t chunk = 1 + rng() % MAX_CHUNK;
+        if (chunk > s->len - pos) chunk = s->len - pos;
+        for (size_t k = 0; k < chunk; k++) {
+            ring[written & (RING_SIZE - 1)] = s->bytes[pos++];
+            written++;
+        }
+
+        if (legacy) {
+            double t0 = now_sec();
+            legacy_consume(&lp, written & (RING_SIZE - 1), &res);
+            res.parse_sec += now_sec() - t0;
+        } else {
+            for (;;) {
+                double t0 = now_sec();
+                bool got = sync_parser_poll(&parser, written, payload);
+                res.parse_sec += now_sec() - t0;
+                if (!got) break;
+                res.frames++;
+                res.checksum = fold_checksum(res.checksum, payload);
+            }
+        }
+    }
+    res.track_hits = parser.track_hits;
+    res.resyncs    = parser.resyncs;
+    return res;
+}
+
+/* ---- Frame v2: sequence, format and CRC ------------------------------- */
+
+#define V2_CORRUPT_EVERY  97    // flip one payload bit
+#define V2_DROP_EVERY     53    // sequence number skipped by the sender
+#define V2_FALSE_EVERY    29    // marker followed by an invalid header
+
+typedef struct {
+    stream_t s;
+    uint32_t corrupted;
+    uint32_t dropped;
+    uint32_t false_markers;
+} stream_v2_t;
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);  p[3] = (uint8_t)v;
+}
+
+/* Same v2 wire format as sdr_simulator.ino, with injected faults */
+static stream_v2_t build_stream_v2(void) {
+    const size_t frame_len = SYNC_V2_HEADER_SIZE + PAYLOAD_SIZE + SYNC_V2_CRC_SIZE;
+    stream_v2_t v = {0};
+    uint32_t seq = 0;
+
+    v.s.bytes = malloc((size_t)STREAM_FRAMES * (frame_len + MAX_GARBAGE + SYNC_V2_HEADER_SIZE));
+    rng_state = 0xBEEFu;
+
+    for (uint32_t f = 0; f < STREAM_FRAMES; f++) {
+        if (f % V2_FALSE_EVERY == 0) {
+            // Marker + version byte that is not 2: must be skipped as a bad header
+            uint8_t* h = v.s.bytes + v.s.len;
+            h[0] = 0xFE; h[1] = 0xCA; h[2] = 0xFE; h[3] = 0xCA;
+            h[4] = 0x7F;
+            v.s.len += SYNC_MARKER_SIZE + 1;
+            v.false_markers++;
+        }
+        if (f % V2_DROP_EVERY == 0 && f > 0) {
+            seq++;
+            v.dropped++;
+        }
+
+        uint8_t* fr = v.s.bytes + v.s.len;
+        fr[0] = 0xFE; fr[1] = 0xCA; fr[2] = 0xFE; fr[3] = 0xCA;
+        fr[4] = SYNC_V2_VERSION;
+        fr[5] = SYNC_FMT_BYTE(SYNC_FMT_IQ16_BE, 16);
+        fr[6] = (uint8_t)(PAYLOAD_SIZE >> 8);
+        fr[7] = (uint8_t)PAYLOAD_SIZE;
+        put_be32(fr + 8, seq++);
+        for (uint32_t k = 0; k < PAYLOAD_SIZE; k++) {
+            uint8_t b = (uint8_t)rng();
+            fr[SYNC_V2_HEADER_SIZE + k] = (b == SYNC_MARKER_BYTE0) ? 0x00 : b;
+        }
+        put_be32(fr + SYNC_V2_HEADER_SIZE + PAYLOAD_SIZE,
+                 qlu_crc32(fr + SYNC_MARKER_SIZE, SYNC_V2_HEADER_SIZE - SYNC_MARKER_SIZE + PAYLOAD_SIZE));
+
+        // Corrupt after the CRC was computed, away from any 0xFE pattern
+        if (f % V2_CORRUPT_EVERY == 0 && f > 0) {
+            fr[SYNC_V2_HEADER_SIZE + (rng() % PAYLOAD_SIZE)] ^= 0x01;
+            v.corrupted++;
+        }
+        v.s.len += frame_len;
+        v.s.frames++;
+    }
+    return v;
+}
+
+typedef struct {
+    uint32_t frames;
+    uint32_t crc_ok;
+    uint32_t crc_errors;
+    uint32_t lost;
+    uint32_t bad_headers;
+    uint32_t track_hits;
+    uint32_t resyncs;
+    double   crc_sec;
+} v2_result_t;
+
+static v2_result_t run_v2(const stream_v2_t* v) {
+    static sync_parser_t parser;
+    v2_result_t res = {0};
+    uint32_t written = 0;
+    size_t   pos     = 0;
+
+    sync_parser_init(&parser, ring, RING_SIZE, PAYLOAD_SIZE, SYNC_FRAME_V2, 0);
+    rng_state = 0xF00Du;
+
+    while (pos < v->s.len) {
+        size_t chunk = 1 + rng() % MAX_CHUNK;
+        if (chunk > v->s.len - pos) chunk = v->s.len - pos;
+        for (size_t k = 0; k < chunk; k++) {
+            ring[written & (RING_SIZE - 1)] = v->s.bytes[pos++];
+            written++;
+        }
+
+        frame_desc_t d;
+        while (sync_parser_poll_desc(&parser, written, &d)) {
+            double t0 = now_sec();
+            bool ok = qlu_crc32_ring(ring, RING_SIZE - 1, d.crc_pos, d.crc_len) == d.crc;
+            res.crc_sec += now_sec() - t0;
+            if (sync_parser_commit(&parser, &d, ok)) res.crc_ok++;
+        }
+    }
+
+    res.frames      = parser.frames;
+    res.crc_errors  = parser.crc_errors;
+    res.lost        = parser.lost_frames;
+    res.bad_headers = parser.bad_headers;
+    res.track_hits  = parser.track_hits;
+    res.resyncs     = parser.resyncs;
+    return res;
+}
+
+int main(void) {
+    stream_t s = build_stream();
+
+    bench_result_t legacy = run(&s, true);
+    bench_result_t swar   = run(&s, false);
+
+    printf("========================================================================\n");
+    printf("  SPI frame extractor bench  (%u frames, %zu bytes, ring %u B)\n", s.frames, s.len, RING_SIZE);
+    printf("========================================================================\n");
+    printf("  parser              | frames | MB/s\n");
+    printf("  legacy state machine| %6u | %8.1f\n", legacy.frames, s.len / legacy.parse_sec / 1e6);
+    printf("  word-wise + memcpy  | %6u | %8.1f\n", swar.frames,   s.len / swar.parse_sec / 1e6);
+    printf("  speed-up            |        | %8.2fx\n", legacy.parse_sec / swar.parse_sec);
+
+    printf("  fast path hits      | %6u | resyncs %u\n", swar.track_hits, swar.resyncs);
+
+    // The first frame comes from the search, every later one is a hit or a resync
+    bool ok = (legacy.frames == s.frames) && (swar.frames == s.frames) && (legacy.checksum == swar.checksum) &&
+              (swar.track_hits + swar.resyncs + 1 == swar.frames);
+    printf("\n  %s\n", ok ? "OK: both parsers extracted identical payloads" : "FAIL: parsers disagree");
+
+    stream_v2_t v2 = build_stream_v2();
+    v2_result_t r2 = run_v2(&v2);
+
+    // A corrupted frame never commits its sequence number, so the next good
+    // frame sees it as a gap: loss = dropped + corrupted.
+    uint32_t expect_lost = v2.dropped + v2.corrupted;
+
+    printf("\n  frame v2             | injected | counted\n");
+    printf("  frames               | %8u | %7u\n", v2.s.frames, r2.frames);
+    printf("  CRC errors           | %8u | %7u\n", v2.corrupted, r2.crc_errors);
+    printf("  lost (gap + CRC)     | %8u | %7u\n", expect_lost, r2.lost);
+    printf("  bad headers          | %8u | %7u\n", v2.false_markers, r2.bad_headers);
+    printf("  resyncs              | %8u | %7u  (fast path hits %u)\n",
+           v2.false_markers - 1, r2.resyncs, r2.track_hits);
+    printf("  table CRC-32         | %.1f MB/s\n",
+           (double)r2.frames * (PAYLOAD_SIZE + SYNC_V2_HEADER_SIZE - SYNC_MARKER_SIZE) / r2.crc_sec / 1e6);
+
+    bool ok2 = (r2.frames == v2.s.frames) && (r2.crc_errors == v2.corrupted) &&
+               (r2.crc_ok == v2.s.frames - v2.corrupted) && (r2.lost == expect_lost) &&
+               (r2.bad_headers == v2.false_markers) && (r2.resyncs == v2.false_markers - 1) &&
+               (r2.track_hits + r2.resyncs + 1 == r2.frames) && (qlu_crc32((const uint8_t*)"123456789", 9) == 0xCBF43926u);
+    printf("\n  %s\n", ok2 ? "OK: v2 counters match the injected faults" : "FAIL: v2 counters disagree");
+
+    free(s.bytes);
+    free(v2.s.bytes);
+    return (ok && ok2) ? 0 : 1;
+}
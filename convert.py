@@ -1,7 +1,13 @@
+import struct
 import numpy as np
 from modulations.base import ModulationInfo
 from pathlib import Path
 
+STREAM_BLOB_MAGIC       = b"QLSB"
+STREAM_BLOB_VERSION     = 1
+STREAM_BLOB_HEADER_FMT  = "<4sHHIIffIf"
+STREAM_BLOB_HEADER_SIZE = struct.calcsize(STREAM_BLOB_HEADER_FMT)
+
 class ToHeaderConverter:
     def __init__(self, resolution: int, max_amp: float = 1.5):
         """
@@ -42,7 +48,7 @@ class ToHeaderConverter:
 
         return scaled, scale
 
-    def write_stream_meta_data(self, lines, arr_name, n_samples, scale, info: ModulationInfo):        
+    def write_stream_meta_type(self, lines):
         lines.append("#ifndef STREAM_METADATA_TYPE")
         lines.append("#define STREAM_METADATA_TYPE")
         lines.append("typedef struct {")
@@ -56,6 +62,9 @@ class ToHeaderConverter:
         lines.append("#endif")
         lines.append("")
 
+    def write_stream_meta_data(self, lines, arr_name, n_samples, scale, info: ModulationInfo):
+        self.write_stream_meta_type(lines)
+
         lines.append(f"static const stream_meta_t {arr_name}_meta = {{")
         lines.append(f"    .sampling_rate = {int(info.sampling_rate)},")
         lines.append(f"    .signal_resolution = {int(self.resolution)},")
@@ -168,4 +177,84 @@ class ToHeaderConverter:
         lines.append("")
 
         header_text = "\n".join(lines)
-        Path(save_path).write_text(header_text)
\ No newline at end of file
+        Path(save_path).write_text(header_text)
+
+    def complex_u16(self, complex_st) -> np.ndarray:
+        """
+        Same samples as complex_st, interleaved I,Q uint16 little endian.
+        """
+        z = np.asarray(complex_st, dtype=np.complex128)
+
+        Iu, _ = self._scale_to_uint(z.real)
+        Qu, _ = self._scale_to_uint(z.imag)
+
+        iq_u = np.empty(Iu.size * 2, dtype="<u2")
+        iq_u[0::2] = Iu
+        iq_u[1::2] = Qu
+        return iq_u
+
+    def complex_raw(self, complex_st, save_path: str):
+        """
+        complex_u16 as a raw capture file (c_sim `--format u16`,
+        scenario_sweep and golden_metrics.py `--dir`).
+        """
+        self.complex_u16(complex_st).tofile(save_path)
+
+    def complex_blob(self, complex_st, info: ModulationInfo) -> bytes:
+        """
+        Same samples as complex_st as a binary stream blob: a 32 byte
+        little endian header (magic, version, header size, then the fields
+        of stream_meta_t in order) followed by the complex_u16 payload.
+        The header is 4 byte aligned so the firmware reads the meta in place.
+        """
+        iq_u = self.complex_u16(complex_st)
+        _, scale = self._scale_to_uint(np.zeros(1))   # fixed by max_amp
+
+        header = struct.pack(STREAM_BLOB_HEADER_FMT,
+                             STREAM_BLOB_MAGIC, STREAM_BLOB_VERSION, STREAM_BLOB_HEADER_SIZE,
+                             int(info.sampling_rate), int(self.resolution),
+                             float(info.carrier_freq), float(info.samples_per_symbol),
+                             int(iq_u.size), float(scale))
+        return header + iq_u.tobytes()
+
+
+class StreamPack:
+    """
+    Concatenates stream blobs into one binary file linked into the firmware
+    with .incbin, replacing one literal-array header per stream. Blobs start
+    on 4 byte boundaries; add() returns the byte offset used in the index.
+    """
+    def __init__(self, symbol: str = "simulation_streams"):
+        self.symbol = symbol
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, name: str, blob: bytes) -> int:
+        offset = len(self.data)
+        self.data += blob
+        self.data += bytes(-len(self.data) % 4)
+        self.offsets[name] = offset
+        return offset
+
+    def write_bin(self, save_path: str):
+        Path(save_path).write_bytes(self.data)
+
+    def write_asm(self, save_path: str, bin_path: str):
+        """
+        Assembly unit that places the pack in flash rodata between
+        <symbol> and <symbol>_end. The .incbin path is absolute: the Arduino
+        build assembles a copy of the sketch from its own directory.
+        """
+        bin_path = Path(bin_path).resolve().as_posix()
+        lines = []
+        lines.append(f"/* Generated by gen_streamv2.py: {len(self.offsets)} streams, {len(self.data)} bytes */")
+        lines.append("")
+        lines.append(f"    .section .rodata.{self.symbol}, \"a\"")
+        lines.append("    .balign 4")
+        lines.append(f"    .global {self.symbol}")
+        lines.append(f"    .global {self.symbol}_end")
+        lines.append(f"{self.symbol}:")
+        lines.append(f"    .incbin \"{bin_path}\"")
+        lines.append(f"{self.symbol}_end:")
+        lines.append("")
+        Path(save_path).write_text("\n".join(lines))
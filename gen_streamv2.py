@@ -8,6 +8,11 @@ Changes vs original generate_stream.py:
   3. measure_iq_imbalance() on the received signal  
   4. calculate_sqi() to get the unified report
   5. SDR simulator sweep now also includes skew levels
+
+The simulator streams are packed into one binary file linked with .incbin
+(sdr_simulator/simulation_streams.S) and looked up through an offset index
+in simulation_base.h; --headers writes the old literal-array header per
+stream instead.
 """
 
 import warnings
@@ -15,6 +20,7 @@ warnings.filterwarnings("ignore", category=UserWarning)
 
 import os
 import shutil
+import argparse
 from pathlib import Path
 
 import numpy as np
@@ -26,7 +32,7 @@ from modulations.util  import MegaHz, bytes_to_bits, bits_to_bytes, tx_rx_error
 
 from modulations.skew    import apply_iq_skew, measure_iq_imbalance, skew_range_sweep
 from modulations.metrics import calculate_mer, calculate_cn0, signal_stability, calculate_sqi
-from convert import ToHeaderConverter
+from convert import ToHeaderConverter, StreamPack, STREAM_BLOB_MAGIC, STREAM_BLOB_VERSION
 
 SKEW_SCENARIOS = [
     # label                 phase_deg  amplitude_db   description
@@ -38,6 +44,11 @@ SKEW_SCENARIOS = [
 
 
 def main():
+    parser = argparse.ArgumentParser(description="SQI demonstration and SDR simulator stream generation")
+    parser.add_argument("--headers", action="store_true",
+                        help="one literal-array header per stream instead of the .incbin pack")
+    args = parser.parse_args()
+
     stream_str   = "t2OcohNI8LVpbG28G4mV7R8Ht34YJSyKQMbrIwerCKnJvTXKdybsJCKclGk3xNoBwlR58RslAN4pAwjJq4fTpL7aIH44wlOK63468oUbjrZhE5rOq4uAwmB40w98tRDqS35WbZdLM7bNbzCHf7r2YlT70U7KY1jv8BsQSrZwqIx873tL2"
     byte_stream  = bytearray(stream_str, encoding="ascii")
     bit_stream   = bytes_to_bits(byte_stream, msb_first=True)
@@ -86,6 +97,7 @@ def main():
                 sampling_rate          = sampling_rate,
                 amplitude_imbalance_db = meas_amp,
                 phase_imbalance_deg    = meas_phase,
+                samples_per_symbol     = info.samples_per_symbol,
             )
 
             print(
@@ -105,6 +117,9 @@ def main():
     snr_range    = list(range(1, 41, 2))
     h_converter  = ToHeaderConverter(resolution=16)
     folder_path  = "sdr_simulator/headers"
+    pack         = StreamPack("simulation_streams")
+    pack_path    = os.path.join(folder_path, "simulation_streams.bin")
+    asm_path     = "sdr_simulator/simulation_streams.S"
 
     if os.path.exists(folder_path):
         shutil.rmtree(folder_path)
@@ -128,17 +143,30 @@ def main():
                 header_name = arr_name + ".h"
                 save_path   = os.path.join(folder_path, header_name)
 
-                # Embed SQI in header comment via arr metadata
-                h_converter.complex_st(
-                    skewed_iq, info,
-                    save_path  = save_path,
-                    arr_name   = arr_name,
-                    elem_per_line = 7,
-                )
+                if args.headers:
+                    h_converter.complex_st(
+                        skewed_iq, info,
+                        save_path  = save_path,
+                        arr_name   = arr_name,
+                        elem_per_line = 7,
+                    )
+                else:
+                    pack.add(arr_name, h_converter.complex_blob(skewed_iq, info))
+                # Raw copy for the host regression sweep (c_sim `make sweep`)
+                h_converter.complex_raw(skewed_iq, os.path.join(folder_path, arr_name + ".u16"))
 
     # ===========================================================================
     # SIMULATION BASE HEADER — lookup tables for modulation × skew × SNR
     # ===========================================================================
+    if args.headers:
+        # A stale .S would .incbin a pack that no longer exists
+        if os.path.exists(asm_path):
+            os.remove(asm_path)
+    else:
+        pack.write_bin(pack_path)
+        pack.write_asm(asm_path, pack_path)
+        print(f"[INFO] Stream pack: {len(pack.offsets)} streams, {len(pack.data)} bytes -> {pack_path}")
+
     print(f"[INFO] Generating Simulation Base Header")
 
     available_modulations = [cls.__name__.split("Modem")[0].lower() for cls in modems_cls]
@@ -153,10 +181,17 @@ def main():
     lines.append("\n")
 
     # includes
-    for snr in snr_range:
-        for mod in available_modulations:
-            for sk_label in skew_labels:
-                lines.append(f'#include "complex_{mod}_{sk_label}_{snr}.h"')
+    if args.headers:
+        for snr in snr_range:
+            for mod in available_modulations:
+                for sk_label in skew_labels:
+                    lines.append(f'#include "complex_{mod}_{sk_label}_{snr}.h"')
+    else:
+        lines.append("#include <stdint.h>")
+        lines.append("#include <stddef.h>")
+        lines.append("")
+        h_converter.write_stream_data_type(lines)
+        h_converter.write_stream_meta_type(lines)
     lines.append("\n")
 
     # Modulations enum
@@ -189,55 +224,60 @@ def main():
     lines.append(f"unsigned int available_snr[] = {{{','.join(map(str, snr_range))}}};")
     lines.append(f"size_t available_snr_count = {len(snr_range)};\n")
 
-    # Per modulation × skew: data and meta lookup by SNR index
-    for mod in available_modulations:
-        for sk_label in skew_labels:
-            # data array
-            lines.append(f"const stream_data_t* {mod}_{sk_label}_by_snr[] = " + "{")
-            for snr in range(0, snr_range[-1] + 1):
-                name = f"complex_{mod}_{sk_label}_{snr}"
-                if snr not in snr_range:
-                    lines.append(f"{PAD}nullptr,")
-                else:
-                    lines.append(f"{PAD}{name},")
+    if args.headers:
+        # Per modulation × skew: data and meta lookup by SNR index
+        for mod in available_modulations:
+            for sk_label in skew_labels:
+                # data array
+                lines.append(f"const stream_data_t* {mod}_{sk_label}_by_snr[] = " + "{")
+                for snr in range(0, snr_range[-1] + 1):
+                    name = f"complex_{mod}_{sk_label}_{snr}"
+                    if snr not in snr_range:
+                        lines.append(f"{PAD}nullptr,")
+                    else:
+                        lines.append(f"{PAD}{name},")
+                lines.append("};\n")
+
+                # meta array
+                lines.append(f"const stream_meta_t* {mod}_{sk_label}_meta_by_snr[] = " + "{")
+                for snr in range(0, snr_range[-1] + 1):
+                    name = f"&complex_{mod}_{sk_label}_{snr}_meta"
+                    if snr not in snr_range:
+                        lines.append(f"{PAD}nullptr,")
+                    else:
+                        lines.append(f"{PAD}{name},")
+                lines.append("};\n")
+
+        # Per modulation: array of skew scenario pointers (data)
+        for mod in available_modulations:
+            lines.append(f"const stream_data_t** {mod}_data_by_skew[] = " + "{")
+            for sk_label in skew_labels:
+                lines.append(f"{PAD}[SKEW_{sk_label.upper()}] = {mod}_{sk_label}_by_snr,")
             lines.append("};\n")
 
-            # meta array
-            lines.append(f"const stream_meta_t* {mod}_{sk_label}_meta_by_snr[] = " + "{")
-            for snr in range(0, snr_range[-1] + 1):
-                name = f"&complex_{mod}_{sk_label}_{snr}_meta"
-                if snr not in snr_range:
-                    lines.append(f"{PAD}nullptr,")
-                else:
-                    lines.append(f"{PAD}{name},")
+            lines.append(f"const stream_meta_t** {mod}_meta_by_skew[] = " + "{")
+            for sk_label in skew_labels:
+                lines.append(f"{PAD}[SKEW_{sk_label.upper()}] = {mod}_{sk_label}_meta_by_snr,")
             lines.append("};\n")
 
-    # Per modulation: array of skew scenario pointers (data)
-    for mod in available_modulations:
-        lines.append(f"const stream_data_t** {mod}_data_by_skew[] = " + "{")
-        for sk_label in skew_labels:
-            lines.append(f"{PAD}[SKEW_{sk_label.upper()}] = {mod}_{sk_label}_by_snr,")
+        # Top-level: data_by_modulation[mod][skew][snr]
+        lines.append("const stream_data_t*** data_by_modulation[] = " + "{")
+        for mod in available_modulations:
+            lines.append(f"{PAD}[{mod.upper()}] = {mod}_data_by_skew,")
         lines.append("};\n")
 
-        lines.append(f"const stream_meta_t** {mod}_meta_by_skew[] = " + "{")
-        for sk_label in skew_labels:
-            lines.append(f"{PAD}[SKEW_{sk_label.upper()}] = {mod}_{sk_label}_meta_by_snr,")
+        lines.append("const stream_meta_t*** meta_by_modulation[] = " + "{")
+        for mod in available_modulations:
+            lines.append(f"{PAD}[{mod.upper()}] = {mod}_meta_by_skew,")
         lines.append("};\n")
 
-    # Top-level: data_by_modulation[mod][skew][snr]
-    lines.append("const stream_data_t*** data_by_modulation[] = " + "{")
-    for mod in available_modulations:
-        lines.append(f"{PAD}[{mod.upper()}] = {mod}_data_by_skew,")
-    lines.append("};\n")
+        # Accessor macros
+        lines.append("#define GET_DATA(modulation,skew,snr) (data_by_modulation[modulation][skew][snr])")
+        lines.append("#define GET_META(modulation,skew,snr) (meta_by_modulation[modulation][skew][snr])")
+        lines.append("static inline int simulation_streams_check() { return 0; }\n")
+    else:
+        write_stream_index(lines, pack, available_modulations, skew_labels, snr_range)
 
-    lines.append("const stream_meta_t*** meta_by_modulation[] = " + "{")
-    for mod in available_modulations:
-        lines.append(f"{PAD}[{mod.upper()}] = {mod}_meta_by_skew,")
-    lines.append("};\n")
-
-    # Accessor macros
-    lines.append("#define GET_DATA(modulation,skew,snr) (data_by_modulation[modulation][skew][snr])")
-    lines.append("#define GET_META(modulation,skew,snr) (meta_by_modulation[modulation][skew][snr])")
     lines.append("#define GET_MODULATION_NAME(modulation) (modulations_str[modulation])")
     lines.append("#define GET_SKEW_NAME(skew) (skew_str[skew])")
 
@@ -246,11 +286,86 @@ def main():
     header_text = "\n".join(lines)
     Path(os.path.join(folder_path, "simulation_base.h")).write_text(header_text)
 
-    print(f"[INFO] Done — headers in {folder_path}/")
+    print(f"[INFO] Done — {'headers' if args.headers else 'stream pack'} in {folder_path}/")
     print(f"[INFO] Total headers: {len(snr_range)} SNRs × "
           f"{len(modems_cls)} modulations × {len(SKEW_SCENARIOS)} skew scenarios = "
           f"{len(snr_range) * len(modems_cls) * len(SKEW_SCENARIOS)} files")
 
 
+def write_stream_index(lines, pack, available_modulations, skew_labels, snr_range):
+    """
+    Offset index into the .incbin pack with the same GET_DATA / GET_META
+    lookup the literal-array tables had; SNRs that were not generated map to
+    STREAM_NONE and read back as nullptr.
+    """
+    PAD      = " " * 4
+    snr_slot = snr_range[-1] + 1
+    magic    = int.from_bytes(STREAM_BLOB_MAGIC, "little")
+
+    lines.append("// Stream blob: this header then meta.n_samples interleaved I,Q samples")
+    lines.append(f"#define STREAM_BLOB_MAGIC   0x{magic:08X}u  // \"{STREAM_BLOB_MAGIC.decode()}\"")
+    lines.append(f"#define STREAM_BLOB_VERSION {STREAM_BLOB_VERSION}")
+    lines.append("#define STREAM_NONE         0xFFFFFFFFu")
+    lines.append(f"#define SNR_SLOTS           {snr_slot}")
+    lines.append("")
+    lines.append("typedef struct {")
+    lines.append("    uint32_t magic;")
+    lines.append("    uint16_t version;")
+    lines.append("    uint16_t header_size;")
+    lines.append("    stream_meta_t meta;")
+    lines.append("} stream_blob_t;\n")
+
+    lines.append(f"// {pack.symbol}.S")
+    lines.append(f'extern "C" const uint8_t {pack.symbol}[];')
+    lines.append(f'extern "C" const uint8_t {pack.symbol}_end[];\n')
+
+    # index[modulation][skew][snr] -> byte offset of the blob in the pack
+    lines.append("const uint32_t stream_index[MODULATIONS_COUNT][SKEW_COUNT][SNR_SLOTS] = {")
+    for mod in available_modulations:
+        lines.append(f"{PAD}{{ // {mod.upper()}")
+        for sk_label in skew_labels:
+            offsets = []
+            for snr in range(snr_slot):
+                name = f"complex_{mod}_{sk_label}_{snr}"
+                offsets.append(str(pack.offsets[name]) if name in pack.offsets else "STREAM_NONE")
+            lines.append(f"{PAD * 2}{{ {', '.join(offsets)} }}, // SKEW_{sk_label.upper()}")
+        lines.append(f"{PAD}}},")
+    lines.append("};\n")
+
+    lines.append("static inline const stream_blob_t* stream_blob(int modulation, int skew, int snr) {")
+    lines.append(f"{PAD}uint32_t offset = stream_index[modulation][skew][snr];")
+    lines.append(f"{PAD}return (offset == STREAM_NONE) ? nullptr : (const stream_blob_t*)({pack.symbol} + offset);")
+    lines.append("}\n")
+
+    lines.append("static inline const stream_data_t* stream_blob_data(const stream_blob_t* blob) {")
+    lines.append(f"{PAD}return blob ? (const stream_data_t*)((const uint8_t*)blob + blob->header_size) : nullptr;")
+    lines.append("}\n")
+
+    lines.append("static inline const stream_meta_t* stream_blob_meta(const stream_blob_t* blob) {")
+    lines.append(f"{PAD}return blob ? &blob->meta : nullptr;")
+    lines.append("}\n")
+
+    # A pack from another generator run (or a truncated flash image) would
+    # otherwise stream garbage; returns the number of bad entries
+    lines.append("static inline int simulation_streams_check() {")
+    lines.append(f"{PAD}size_t pack_size = (size_t)({pack.symbol}_end - {pack.symbol});")
+    lines.append(f"{PAD}int bad = 0;")
+    lines.append(f"{PAD}for (int m = 0; m < MODULATIONS_COUNT; m++)")
+    lines.append(f"{PAD}for (int s = 0; s < SKEW_COUNT; s++)")
+    lines.append(f"{PAD}for (int n = 0; n < SNR_SLOTS; n++) {{")
+    lines.append(f"{PAD * 2}uint32_t offset = stream_index[m][s][n];")
+    lines.append(f"{PAD * 2}if (offset == STREAM_NONE) continue;")
+    lines.append(f"{PAD * 2}const stream_blob_t* blob = stream_blob(m, s, n);")
+    lines.append(f"{PAD * 2}if (offset + sizeof(stream_blob_t) > pack_size || blob->magic != STREAM_BLOB_MAGIC ||")
+    lines.append(f"{PAD * 2}    blob->version != STREAM_BLOB_VERSION || blob->header_size < sizeof(stream_blob_t) ||")
+    lines.append(f"{PAD * 2}    offset + blob->header_size + blob->meta.n_samples * sizeof(stream_data_t) > pack_size) bad++;")
+    lines.append(f"{PAD}}}")
+    lines.append(f"{PAD}return bad;")
+    lines.append("}\n")
+
+    lines.append("#define GET_DATA(modulation,skew,snr) (stream_blob_data(stream_blob(modulation,skew,snr)))")
+    lines.append("#define GET_META(modulation,skew,snr) (stream_blob_meta(stream_blob(modulation,skew,snr)))")
+
+
 if __name__ == "__main__":
     main()
\ No newline at end of file
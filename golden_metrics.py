@@ -0,0 +1,260 @@
+"""
+golden_metrics.py — C-vs-Python golden comparison of the link metrics
+
+Feeds identical u16 IQ to
+  * the firmware metrics engine (QLU/includes/qlu_metrics.h) through the
+    plain C API of libqlu_dsp (QLU/libs/qlu_dsp), built as a shared library
+    by c_sim `make golden` or the host CMake project, driven through ctypes,
+    and
+  * the reference implementation (modulations/metrics.py, modulations/skew.py)
+and diffs MER, C/N0, skew score, stability and SQI against per-metric
+tolerances. Exit status is non-zero when any checked scenario is out of
+tolerance, so it can gate changes to either side.
+
+The firmware runs blocks of PROCESS_BLOCK_SIZE samples through EMA smoothed,
+windowed estimators; the reference runs once over the whole capture. Each
+capture is looped to --blocks blocks so the C side settles, and the reference
+sees the same looped samples:
+    MER, C/N0    symbol decisions after integrate-and-dump (samples_per_symbol)
+    skew         error-vector imbalance -> skew_score
+    stability    power CV over the last METRICS_STABILITY_WINDOW_CNT blocks,
+                 one block per window, as the firmware ring holds
+    SQI          calculate_sqi with the above
+
+The reference runs with normalise_power=False: the firmware slices at the
+fixed converter scale, while the reference default (unit average power before
+slicing) shifts MER by up to ~10 dB and the skew score by up to ~60 pts under
+amplitude imbalance, and caps 16QAM MER at ~36 dB on finite random data.
+
+Usage:
+    cd c_sim && make golden
+    python3 golden_metrics.py [--lib PATH] [--dir DIR] [--blocks N] [--quiet]
+
+    --dir reads the complex_<mod>_<skew>_<snr>.u16 captures gen_streamv2.py
+    writes; without it the same grid is synthesised in memory.
+"""
+
+import argparse
+import ctypes
+import sys
+import time
+from pathlib import Path
+
+import numpy as np
+
+from modulations.bpsk    import BpskModem
+from modulations.qpsk    import QpskModem
+from modulations.qam16   import Qam16Modem
+from modulations.util    import MegaHz
+from modulations.skew    import apply_iq_skew, measure_iq_imbalance, skew_score
+from modulations.metrics import calculate_mer, calculate_cn0, signal_stability, calculate_sqi
+from convert             import ToHeaderConverter
+from gen_streamv2        import SKEW_SCENARIOS
+
+# Link parameters of the generated captures (gen_streamv2.py)
+LINK_BW       = MegaHz(10.0)
+SAMPLING_RATE = 2 * LINK_BW
+ROLL_OFF      = 0.25
+RESOLUTION    = 16
+SEED          = 333
+SNR_RANGE     = list(range(1, 41, 2))
+N_BITS        = 4096
+
+STABILITY_WINDOW_CNT = 16          # METRICS_STABILITY_WINDOW_CNT
+DEFAULT_BLOCKS       = 400         # multiple of the skew (20) and reset (5) periods
+
+# label -> (modem class, modulation_type_t index)
+MODULATIONS = {
+    "bpsk":  (BpskModem,  0),
+    "qpsk":  (QpskModem,  1),
+    "qam16": (Qam16Modem, 2),
+}
+
+# The firmware skew score is an EMA of per-window scores over a decayed
+# ~7k-sample window; |amplitude|, |phase| of a short window read a few pts
+# lower than one estimate over the whole capture when the error is tiny
+TOLERANCE = {
+    "mer":       0.5,    # dB
+    "cn0":       0.5,    # dB-Hz
+    "skew":      3.0,    # pts
+    "stability": 0.5,    # pts
+    "sqi":       1.0,    # pts
+}
+METRICS = list(TOLERANCE)
+
+
+# ---------------------------------------------------------------------------
+# C side — libqlu_dsp through ctypes (mirrors QLU/libs/qlu_dsp/qlu_dsp.h)
+# ---------------------------------------------------------------------------
+
+class QluDspConfig(ctypes.Structure):
+    _fields_ = [("modulation",       ctypes.c_int32),
+                ("sampling_rate_hz", ctypes.c_double),
+                ("link_bw_hz",       ctypes.c_double),
+                ("roll_off",         ctypes.c_double),
+                ("resolution",       ctypes.c_uint32)]
+
+
+class QluDspReport(ctypes.Structure):
+    _fields_ = [(name, ctypes.c_double) for name in (
+                    "snr", "mer", "evm", "cn0", "stability", "skew_score", "sqi",
+                    "compression_db", "ampm_deg", "scale", "samples_per_symbol", "symbol_rate_hz")] + \
+               [("samples", ctypes.c_uint64), ("blocks", ctypes.c_uint64)]
+
+
+class CMetrics:
+    def __init__(self, lib_path: str):
+        lib = ctypes.CDLL(lib_path)
+        lib.qlu_dsp_block_size.restype  = ctypes.c_uint32
+        lib.qlu_dsp_open.restype        = ctypes.c_void_p
+        lib.qlu_dsp_open.argtypes       = [ctypes.POINTER(QluDspConfig)]
+        lib.qlu_dsp_feed_u16.argtypes   = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint16), ctypes.c_uint64]
+        lib.qlu_dsp_read.argtypes       = [ctypes.c_void_p, ctypes.POINTER(QluDspReport)]
+        lib.qlu_dsp_close.argtypes      = [ctypes.c_void_p]
+        self.lib        = lib
+        self.block_size = int(lib.qlu_dsp_block_size())
+
+    def run(self, modulation: int, iq_u16: np.ndarray) -> QluDspReport:
+        iq  = np.ascontiguousarray(iq_u16, dtype=np.uint16)
+        cfg = QluDspConfig(modulation, SAMPLING_RATE, LINK_BW, ROLL_OFF, RESOLUTION)
+        h   = self.lib.qlu_dsp_open(ctypes.byref(cfg))
+        if not h:
+            raise RuntimeError(f"qlu_dsp_open rejected modulation {modulation}")
+        report = QluDspReport()
+        try:
+            self.lib.qlu_dsp_feed_u16(h, iq.ctypes.data_as(ctypes.POINTER(ctypes.c_uint16)), iq.size // 2)
+            self.lib.qlu_dsp_read(h, ctypes.byref(report))
+        finally:
+            self.lib.qlu_dsp_close(h)
+        return report
+
+
+# ---------------------------------------------------------------------------
+# Python side — reference metrics on the same samples
+# ---------------------------------------------------------------------------
+
+def u16_to_complex(iq_u16: np.ndarray, scale: float) -> np.ndarray:
+    """Inverse of the converter mapping, as metrics_convert does it."""
+    half = ((1 << RESOLUTION) - 1) // 2
+    iq   = iq_u16.astype(np.float64) - half
+    return (iq[0::2] + 1j * iq[1::2]) / scale
+
+
+def reference_metrics(x: np.ndarray, modem_cls, sps: int, block: int) -> dict:
+    # One window per firmware block; the half sample keeps int() from rounding down
+    window_ms = (block + 0.5) / SAMPLING_RATE * 1000.0
+
+    amp_db, phase_deg = measure_iq_imbalance(x, modem_cls=modem_cls, normalise_power=False)
+    report = calculate_sqi(
+        complex_iq             = x,
+        modem_cls              = modem_cls,
+        sampling_rate          = SAMPLING_RATE,
+        amplitude_imbalance_db = amp_db,
+        phase_imbalance_deg    = phase_deg,
+        window_size_ms         = window_ms,
+        samples_per_symbol     = sps,
+        normalise_power        = False,
+    )
+    return {
+        "mer":       calculate_mer(x, modem_cls, SAMPLING_RATE, sps, normalise_power=False),
+        "cn0":       calculate_cn0(x, SAMPLING_RATE, modem_cls, sps, normalise_power=False),
+        "skew":      skew_score(amp_db, phase_deg),
+        "stability": signal_stability(x[-STABILITY_WINDOW_CNT * block:], SAMPLING_RATE, window_ms),
+        "sqi":       report.sqi,
+    }
+
+
+# ---------------------------------------------------------------------------
+# Scenarios
+# ---------------------------------------------------------------------------
+
+def synthesised_scenarios():
+    """Same link model and grid as gen_streamv2.py, without touching disk."""
+    bits      = np.random.default_rng(SEED).integers(0, 2, N_BITS).astype(np.uint8)
+    converter = ToHeaderConverter(resolution=RESOLUTION)
+
+    for snr in SNR_RANGE:
+        for mod_label, (modem_cls, _) in MODULATIONS.items():
+            modem = modem_cls(SAMPLING_RATE, LINK_BW, ROLL_OFF)
+            _, clean, _ = modem.modulate(bits, fc=0.0, snr_db=snr, seed=SEED, amplitude=1.0)
+            for sk_label, phase_deg, amp_db, _ in SKEW_SCENARIOS:
+                yield mod_label, sk_label, snr, converter.complex_u16(apply_iq_skew(clean, phase_deg, amp_db))
+
+
+def file_scenarios(folder: Path):
+    """complex_<mod>_<skew label>_<snr>.u16 as written by gen_streamv2.py."""
+    for path in sorted(folder.glob("complex_*.u16")):
+        parts = path.stem.split("_")
+        if len(parts) < 4 or parts[1] not in MODULATIONS or not parts[-1].isdigit():
+            print(f"  skipping {path.name}: not complex_<mod>_<skew>_<snr>.u16", file=sys.stderr)
+            continue
+        yield parts[1], "_".join(parts[2:-1]), int(parts[-1]), np.fromfile(path, dtype="<u2")
+
+
+def loop_to(iq_u16: np.ndarray, n_pairs: int) -> np.ndarray:
+    reps = -(-n_pairs // (iq_u16.size // 2))
+    return np.tile(iq_u16[:(iq_u16.size // 2) * 2], reps)[:2 * n_pairs]
+
+
+# ---------------------------------------------------------------------------
+# Main
+# ---------------------------------------------------------------------------
+
+def main() -> int:
+    here   = Path(__file__).resolve().parent
+    parser = argparse.ArgumentParser(description="C-vs-Python golden comparison of MER, C/N0, skew, stability and SQI")
+    parser.add_argument("--lib",    default=str(here / "c_sim" / "build" / "libqlu_dsp.so"))
+    parser.add_argument("--dir",    type=Path, help="read gen_streamv2.py .u16 captures instead of synthesising")
+    parser.add_argument("--blocks", type=int, default=DEFAULT_BLOCKS)
+    parser.add_argument("--quiet",  action="store_true", help="only print failures and the summary")
+    args = parser.parse_args()
+
+    c_metrics = CMetrics(args.lib)
+    block     = c_metrics.block_size
+    scenarios = file_scenarios(args.dir) if args.dir else synthesised_scenarios()
+
+    print("=" * 110)
+    print(f"  Golden metrics: {Path(args.lib).name} vs modulations/metrics.py  "
+          f"({args.blocks} blocks of {block}, {'files in ' + str(args.dir) if args.dir else 'synthesised'})")
+    print("  tolerance: " + ", ".join(f"{k} {v}" for k, v in TOLERANCE.items()))
+    print("=" * 110)
+    print(f"  {'mod':<6} {'skew':<18} {'snr':>3} | {'MER C/py':>11} | {'C/N0 C/py':>11} | "
+          f"{'skew C/py':>11} | {'stab C/py':>11} | {'SQI C/py':>11} | check")
+
+    max_diff = {k: 0.0 for k in METRICS}
+    total = failed = 0
+    t0 = time.perf_counter()
+
+    for mod_label, sk_label, snr, iq_u16 in scenarios:
+        modem_cls, mod_index = MODULATIONS[mod_label]
+        iq = loop_to(iq_u16, args.blocks * block)
+
+        c  = c_metrics.run(mod_index, iq)
+        cv = {"mer": c.mer, "cn0": c.cn0, "skew": c.skew_score, "stability": c.stability, "sqi": c.sqi}
+        py = reference_metrics(u16_to_complex(iq, c.scale), modem_cls, int(c.samples_per_symbol), block)
+
+        bad     = [k for k in METRICS if abs(cv[k] - py[k]) > TOLERANCE[k]]
+        total  += 1
+        failed += bool(bad)
+        for k in METRICS:
+            max_diff[k] = max(max_diff[k], abs(cv[k] - py[k]))
+
+        status = ("FAIL " + ",".join(bad)) if bad else "ok"
+        if not args.quiet or bad:
+            print(f"  {mod_label:<6} {sk_label:<18} {snr:>3} | " +
+                  " | ".join(f"{cv[k]:5.1f}/{py[k]:5.1f}" for k in METRICS) + f" | {status}")
+
+    sec = time.perf_counter() - t0
+    print("-" * 110)
+    print(f"  {total} scenarios, {failed} out of tolerance, {sec:.1f} s")
+    print("  max |C - py|: " + ", ".join(f"{k} {v:.3f}" for k, v in max_diff.items()))
+
+    if total == 0:
+        print("  FAIL: no scenarios (no .u16 captures?)")
+        return 1
+    print("  FAIL: C and Python metrics disagree" if failed else "  OK: C matches the Python reference")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -80,10 +80,25 @@ class SignalReport:
 # MER — Modulation Error Ratio
 # ---------------------------------------------------------------------------
 
+def integrate_and_dump(complex_iq: np.ndarray, samples_per_symbol: int) -> np.ndarray:
+    """
+    Averages consecutive groups of samples_per_symbol samples into one symbol,
+    as the firmware symbol accumulator does (QLU/includes/qlu_metrics.h).
+    A trailing partial symbol is dropped.
+    """
+    sps = max(1, int(samples_per_symbol))
+    if sps == 1:
+        return complex_iq
+    n_symbols = len(complex_iq) // sps
+    return complex_iq[:n_symbols * sps].reshape(n_symbols, sps).mean(axis=1)
+
+
 def calculate_mer(
-    complex_iq:    np.ndarray,
-    modem_cls:     Type,
-    sampling_rate: float,
+    complex_iq:         np.ndarray,
+    modem_cls:          Type,
+    sampling_rate:      float,
+    samples_per_symbol: int  = 1,
+    normalise_power:    bool = True,
 ) -> float:
     """
     Computes MER (Modulation Error Ratio) in dB using a decision-directed slicer.
@@ -94,14 +109,21 @@ def calculate_mer(
     This is equivalent to EVM² inverted.
 
     Parameters:
-        complex_iq    : complex baseband samples
-        modem_cls     : BpskModem, QpskModem, or Qam16Modem class (not instance)
-        sampling_rate : sampling rate in Hz (used for reference only in this fn)
+        complex_iq         : complex baseband samples
+        modem_cls          : BpskModem, QpskModem, or Qam16Modem class (not instance)
+        sampling_rate      : sampling rate in Hz (used for reference only in this fn)
+        samples_per_symbol : > 1 slices integrate-and-dump symbols instead of
+                             raw samples (the MER the firmware reports); 1 gives
+                             the per-sample figure, i.e. the sample SNR
+        normalise_power    : scale to unit average power before slicing (blind
+                             AGC); False slices at the given scale, as the
+                             firmware does with the converter's fixed scale
 
     Returns:
         float: MER in dB. Higher is better.
                BPSK good: >12 dB | QPSK good: >15 dB | 16QAM good: >22 dB
     """
+    complex_iq = integrate_and_dump(complex_iq, samples_per_symbol)
     if len(complex_iq) == 0:
         return 0.0
 
@@ -109,7 +131,7 @@ def calculate_mer(
     avg_pwr = float(np.mean(np.abs(complex_iq) ** 2))
     if avg_pwr < 1e-12:
         return 0.0
-    y = complex_iq / np.sqrt(avg_pwr)
+    y = complex_iq / np.sqrt(avg_pwr) if normalise_power else complex_iq
 
     if modem_cls is BpskModem:
         # Ideal points: ±1 on I axis
@@ -233,21 +255,24 @@ def _normalise_cn0(cn0_dbhz: float) -> float:
 # ---------------------------------------------------------------------------
 
 def calculate_cn0(
-    complex_iq:    np.ndarray,
-    sampling_rate: float,
-    modem_cls:     Type,
+    complex_iq:         np.ndarray,
+    sampling_rate:      float,
+    modem_cls:          Type,
+    samples_per_symbol: int  = 1,
+    normalise_power:    bool = True,
 ) -> float:
     """
     Estimates C/N₀ using a decision-directed EVM method.
 
-    C/N₀ (dB-Hz) = SNR (dB) + 10·log10(sampling_rate)
+    C/N₀ (dB-Hz) = Es/N₀ (dB) + 10·log10(symbol_rate)
 
-    This is the same implementation from generate_stream.py, consolidated here
-    so metrics.py is a single import for the measurement pipeline.
+    with Es/N₀ the MER at the symbol decisions and symbol_rate =
+    sampling_rate / samples_per_symbol. With samples_per_symbol = 1 this is
+    the per-sample SNR + 10·log10(sampling_rate), the generate_stream.py form.
     """
-    # MER is numerically identical to SNR in the decision-directed model
-    snr_db = calculate_mer(complex_iq, modem_cls, sampling_rate)
-    return float(snr_db + 10.0 * np.log10(sampling_rate))
+    sps    = max(1, int(samples_per_symbol))
+    mer_db = calculate_mer(complex_iq, modem_cls, sampling_rate, sps, normalise_power)
+    return float(mer_db + 10.0 * np.log10(sampling_rate / sps))
 
 
 # ---------------------------------------------------------------------------
@@ -261,6 +286,8 @@ def calculate_sqi(
     amplitude_imbalance_db: float = 0.0,
     phase_imbalance_deg:    float = 0.0,
     window_size_ms:         float = 100.0,
+    samples_per_symbol:     int   = 1,
+    normalise_power:        bool  = True,
 ) -> SignalReport:
     """
     Computes the unified Signal Quality Index (SQI) and full SignalReport.
@@ -284,6 +311,9 @@ def calculate_sqi(
         amplitude_imbalance_db : IQ amplitude imbalance (from skew.measure_iq_imbalance)
         phase_imbalance_deg    : IQ phase imbalance in degrees
         window_size_ms         : window size for stability calculation
+        samples_per_symbol     : MER and C/N₀ on integrate-and-dump symbols
+                                 (see calculate_mer); 1 = per sample
+        normalise_power        : blind AGC before slicing (see calculate_mer)
 
     Returns:
         SignalReport dataclass with all raw and normalised metrics + SQI
@@ -295,8 +325,8 @@ def calculate_sqi(
     from modulations.skew import skew_score as _skew_score
 
     # --- Compute raw metrics ---
-    mer_db      = calculate_mer(complex_iq, modem_cls, sampling_rate)
-    cn0_dbhz    = calculate_cn0(complex_iq, sampling_rate, modem_cls)
+    mer_db      = calculate_mer(complex_iq, modem_cls, sampling_rate, samples_per_symbol, normalise_power)
+    cn0_dbhz    = calculate_cn0(complex_iq, sampling_rate, modem_cls, samples_per_symbol, normalise_power)
     stability   = signal_stability(complex_iq, sampling_rate, window_size_ms)
 
     # --- Normalise to 0–100 ---
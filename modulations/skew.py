@@ -62,7 +62,7 @@ def apply_iq_skew(
     return (I_out + 1j * Q_out).astype(np.complex64)
 
 
-def measure_iq_imbalance(complex_iq: np.ndarray, modem_cls=None):
+def measure_iq_imbalance(complex_iq: np.ndarray, modem_cls=None, normalise_power: bool = True):
     """
     Estimates IQ imbalance from received complex baseband samples using
     error-vector decomposition after decision-directed slicing.
@@ -80,6 +80,10 @@ def measure_iq_imbalance(complex_iq: np.ndarray, modem_cls=None):
         complex_iq : complex baseband samples
         modem_cls  : BpskModem / QpskModem / Qam16Modem class (for slicer).
                      If None, falls back to raw power-ratio (legacy behaviour).
+        normalise_power : scale to unit average power before slicing; False
+                          slices at the given scale, as the firmware does.
+                          An amplitude imbalance also moves the average
+                          power, so the two give different estimates.
 
     Returns:
         amplitude_imbalance_db  (float): positive = error_I stronger
@@ -97,7 +101,7 @@ def measure_iq_imbalance(complex_iq: np.ndarray, modem_cls=None):
         avg_pwr = float(np.mean(np.abs(complex_iq) ** 2))
         if avg_pwr < 1e-12:
             return 0.0, 0.0
-        y = complex_iq / np.sqrt(avg_pwr)
+        y = complex_iq / np.sqrt(avg_pwr) if normalise_power else complex_iq
 
         if modem_cls is BpskModem:
             ideal = np.sign(y.real) + 0j
@@ -1,4 +1,5 @@
 #include <driver/spi_master.h>
+#include "esp_rom_crc.h"
 #include "headers/simulation_base.h"
 
 #define SPI_HOST_ID   SPI2_HOST // FSPI
@@ -9,11 +10,27 @@
 #define PIN_NUM_CS    10
 
 const uint8_t SYNC_HEADER[4] = {0xFE, 0xCA, 0xFE, 0xCA};
-3
+
+// Frame v2: FE CA FE CA | ver | fmt | len (BE16) | seq (BE32) | payload | crc (BE32)
+// crc = CRC-32 (zlib) over ver..payload; fmt = format << 4 | (bits - 1)
+#define FRAME_VERSION      2
+#define FRAME_HEADER_SIZE  12
+#define FRAME_CRC_SIZE     4
+#define FRAME_FMT_IQ16_BE  ((0 << 4) | (16 - 1))
+#define FRAME_FMT_IQ12     ((1 << 4) | (12 - 1))
+#define FRAME_FMT_IQ8      ((2 << 4) | (8 - 1))
+
+static void put_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)(v & 0xFF);
+}
 struct SimulationConfig {
     Modulations modulation;
     SkewScenarios skew;
     int snr;
+    int bits;             // 16, 12 (packed) or 8 bits per I and per Q
     bool update_req;
 };
 
@@ -23,6 +40,44 @@ spi_device_handle_t spi_handle;
 Modulations global_mod = QAM16;
 SkewScenarios global_skew = SKEW_PERFECT;
 int global_snr = 1;
+int global_bits = 16;
+
+// Bytes per I/Q pair on the wire for each sample width
+size_t pairBytes(int bits) {
+    return (bits == 8) ? 2 : (bits == 12) ? 3 : 4;
+}
+
+uint8_t frameFormat(int bits) {
+    return (bits == 8) ? FRAME_FMT_IQ8 : (bits == 12) ? FRAME_FMT_IQ12 : FRAME_FMT_IQ16_BE;
+}
+
+// Packs interleaved I,Q 16-bit samples (with wraparound in the source) keeping
+// the top `bits` bits: 16 -> I MSB LSB Q MSB LSB, 12 -> I[11:4] I[3:0]Q[11:8]
+// Q[7:0], 8 -> I Q. Returns the payload size.
+size_t packSamples(uint8_t* dst, const stream_data_t* src, size_t src_offset,
+                   size_t total_samples, size_t pairs, int bits) {
+    uint8_t* out = dst;
+    for (size_t k = 0; k < pairs; k++) {
+        uint16_t i = src[(src_offset + 2 * k + 0) % total_samples];
+        uint16_t q = src[(src_offset + 2 * k + 1) % total_samples];
+        if (bits == 8) {
+            *out++ = (uint8_t)(i >> 8);
+            *out++ = (uint8_t)(q >> 8);
+        } else if (bits == 12) {
+            uint16_t i12 = i >> 4;
+            uint16_t q12 = q >> 4;
+            *out++ = (uint8_t)(i12 >> 4);
+            *out++ = (uint8_t)(((i12 & 0x0F) << 4) | (q12 >> 8));
+            *out++ = (uint8_t)(q12 & 0xFF);
+        } else {
+            *out++ = (uint8_t)(i >> 8);   // MSB
+            *out++ = (uint8_t)(i & 0xFF); // LSB
+            *out++ = (uint8_t)(q >> 8);
+            *out++ = (uint8_t)(q & 0xFF);
+        }
+    }
+    return (size_t)(out - dst);
+}
 
 // Find the closest available SNR to the requested value
 int findClosestSnr(int requested) {
@@ -58,6 +113,11 @@ void setup() {
 
     Serial.println("--- SDR Simulator Booting ---");
 
+    int bad_streams = simulation_streams_check();
+    if (bad_streams != 0) {
+        Serial.printf("[ERROR] %d streams do not match simulation_base.h, rerun gen_streamv2.py\n", bad_streams);
+    }
+
     initSPI();
 
     configQueue = xQueueCreate(1, sizeof(SimulationConfig));
@@ -114,7 +174,7 @@ void commandTask(void *pvParameters) {
     char rx_buffer[64];
     int rx_index = 0;
 
-    Serial.println("[Core 0] Command Task Started. Waiting for: AT, MODULACAO, SNR, SKEW");
+    Serial.println("[Core 0] Command Task Started. Waiting for: AT, MODULACAO, SNR, SKEW, BITS");
 
     while (true) {
         if (Serial.available()) {
@@ -145,6 +205,20 @@ bool parseCommand(String cmd) {
         Serial.printf("Modulacao: %s\n", GET_MODULATION_NAME(global_mod));
         Serial.printf("Skew: %s\n", GET_SKEW_NAME(global_skew));
         Serial.printf("SNR: %d dB\n", global_snr);
+        Serial.printf("Bits: %d\n", global_bits);
+        return true;
+    }
+
+    else if (cmd.startsWith("BITS:")) {
+        int bits = cmd.substring(5).toInt();
+        if (bits == 16 || bits == 12 || bits == 8) {
+            global_bits = bits;
+            SimulationConfig cfg = {global_mod, global_skew, global_snr, global_bits, true};
+            xQueueOverwrite(configQueue, &cfg);
+            Serial.printf("OK: Amostras de %d bits\n", global_bits);
+        } else {
+            Serial.println("ERRO: Bits invalidos. Use: 16, 12, 8");
+        }
         return true;
     }
 
@@ -159,7 +233,7 @@ bool parseCommand(String cmd) {
 
         if (new_mod != MODULATIONS_COUNT) {
             global_mod = new_mod;
-            SimulationConfig cfg = {global_mod, global_skew, global_snr, true};
+            SimulationConfig cfg = {global_mod, global_skew, global_snr, global_bits, true};
             xQueueOverwrite(configQueue, &cfg);
             Serial.printf("OK: Modulacao alterada para %s\n", arg.c_str());
         } else {
@@ -184,7 +258,7 @@ bool parseCommand(String cmd) {
 
         if (new_skew != SKEW_COUNT) {
             global_skew = new_skew;
-            SimulationConfig cfg = {global_mod, global_skew, global_snr, true};
+            SimulationConfig cfg = {global_mod, global_skew, global_snr, global_bits, true};
             xQueueOverwrite(configQueue, &cfg);
             Serial.printf("OK: Skew alterado para %s\n", GET_SKEW_NAME(global_skew));
         } else {
@@ -207,7 +281,7 @@ bool parseCommand(String cmd) {
         }
 
         global_snr = closest_snr;
-        SimulationConfig cfg = {global_mod, global_skew, global_snr, true};
+        SimulationConfig cfg = {global_mod, global_skew, global_snr, global_bits, true};
         xQueueOverwrite(configQueue, &cfg);
         Serial.printf("OK: MER alterado para %d dB\n", global_snr);
         return true;
@@ -230,21 +304,25 @@ void transmissionTask(void *pvParameters) {
     // Packet contains 256 I/Q pairs
     const size_t IQ_PAIRS_PER_PACKET = 256;
     const size_t ARRAY_ELEMENTS_PER_PACKET = IQ_PAIRS_PER_PACKET * 2; // 512 (interleaved I,Q)
-    const size_t PAYLOAD_BYTES = IQ_PAIRS_PER_PACKET * 4; // 1024 bytes
-    const size_t TOTAL_PACKET_SIZE = sizeof(SYNC_HEADER) + PAYLOAD_BYTES; // 1028 bytes
+    const size_t MAX_PAYLOAD_BYTES = IQ_PAIRS_PER_PACKET * 4; // 1024 bytes at 16 bits
+    const size_t MAX_PACKET_SIZE = FRAME_HEADER_SIZE + MAX_PAYLOAD_BYTES + FRAME_CRC_SIZE; // 1040 bytes
+    int bits = 16;
 
     SimulationConfig rxConfig;
     spi_transaction_t t;
 
-    uint8_t *tx_buffer = (uint8_t*) heap_caps_malloc(TOTAL_PACKET_SIZE, MALLOC_CAP_DMA);
+    uint8_t *tx_buffer = (uint8_t*) heap_caps_malloc(MAX_PACKET_SIZE, MALLOC_CAP_DMA);
     if (tx_buffer == NULL) {
         Serial.println("[ERROR] Failed to allocate DMA buffer!");
         vTaskDelete(NULL);
         return;
     }
     
-    // Copy sync header once (never changes)
+    // Marker and version never change; format and length follow BITS,
+    // seq and CRC change per packet
     memcpy(tx_buffer, SYNC_HEADER, sizeof(SYNC_HEADER));
+    tx_buffer[4] = FRAME_VERSION;
+    uint32_t frame_seq = 0;
 
     // Track position in source array
     size_t source_offset = 0;
@@ -264,11 +342,13 @@ void transmissionTask(void *pvParameters) {
         if (xQueueReceive(configQueue, &rxConfig, 0) == pdTRUE) {
             tx_ptr = GET_DATA(rxConfig.modulation, rxConfig.skew, rxConfig.snr);
             meta_ptr = GET_META(rxConfig.modulation, rxConfig.skew, rxConfig.snr);
+            bits = rxConfig.bits;
             source_offset = 0; // Reset position
             Serial.printf("[Core 1] Config changed: %s, Skew %s, MER %d dB\n",
                          GET_MODULATION_NAME(rxConfig.modulation),
                          GET_SKEW_NAME(rxConfig.skew),
                          rxConfig.snr);
+            Serial.printf("[Core 1] Sample width: %d bits\n", bits);
         }
 
         if (tx_ptr != nullptr && meta_ptr != nullptr) {
@@ -278,25 +358,26 @@ void transmissionTask(void *pvParameters) {
             uint64_t target_duration_us = ((uint64_t)IQ_PAIRS_PER_PACKET * 1000000ULL) / 
                                           (meta_ptr->sampling_rate / 2); // sampling_rate is for I+Q combined
 
-            // Fill packet payload with BIG ENDIAN data
-            size_t dest_offset = sizeof(SYNC_HEADER);
+            // Header: format, length and sequence; payload packed to `bits`
             size_t total_samples = meta_ptr->n_samples;
+            size_t payload_bytes = packSamples(tx_buffer + FRAME_HEADER_SIZE, tx_ptr, source_offset,
+                                               total_samples, IQ_PAIRS_PER_PACKET, bits);
+            size_t packet_size = FRAME_HEADER_SIZE + payload_bytes + FRAME_CRC_SIZE;
+            tx_buffer[5] = frameFormat(bits);
+            tx_buffer[6] = (uint8_t)(payload_bytes >> 8);
+            tx_buffer[7] = (uint8_t)(payload_bytes & 0xFF);
+            put_be32(tx_buffer + 8, frame_seq++);
             
-            for (size_t i = 0; i < ARRAY_ELEMENTS_PER_PACKET; i++) {
-                // Get next sample from source array (with wraparound)
-                size_t src_idx = (source_offset + i) % total_samples;
-                uint16_t sample = tx_ptr[src_idx];
-                
-                // Write in BIG ENDIAN format (MSB first, LSB second)
-                tx_buffer[dest_offset++] = (uint8_t)((sample >> 8) & 0xFF); // MSB
-                tx_buffer[dest_offset++] = (uint8_t)(sample & 0xFF);        // LSB
-            }
-            
+            // CRC over ver..payload (esp_rom_crc32_le(0, ...) == zlib crc32)
+            put_be32(tx_buffer + FRAME_HEADER_SIZE + payload_bytes,
+                     esp_rom_crc32_le(0, tx_buffer + sizeof(SYNC_HEADER),
+                                      FRAME_HEADER_SIZE - sizeof(SYNC_HEADER) + payload_bytes));
+
             // Advance source offset for next packet
             source_offset = (source_offset + ARRAY_ELEMENTS_PER_PACKET) % total_samples;
 
             // Transmit via SPI
-            t.length = TOTAL_PACKET_SIZE * 8; // Length in bits
+            t.length = packet_size * 8; // Length in bits
             t.tx_buffer = tx_buffer;
             t.rx_buffer = NULL;
 
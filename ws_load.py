@@ -0,0 +1,140 @@
+"""
+ws_load.py — websocket load generator for the QLU web side
+
+Opens N clients on each of the firmware's broadcast routes (/ws/stream JSON
+metrics, /ws/eye binary eye frames), keeps them reading for a fixed time and
+reports per route:
+    msgs/s, bytes/s   aggregated over the clients of the route
+    gap p50/p99/max   inter-arrival time of one client's messages, ms
+    drops             clients whose connection closed or stalled
+
+Meant for the host build of the firmware (QLU/host, lwIP on a tap netif),
+where it can run next to `perf record`; it works the same against a Pico W
+on its access point. Standard library only.
+
+Usage:
+    python3 ws_load.py [--host 192.168.4.1] [--port 80] [--clients 8]
+                       [--seconds 20] [--routes /ws/stream,/ws/eye]
+"""
+
+import argparse
+import base64
+import os
+import socket
+import struct
+import threading
+import time
+
+
+class Client(threading.Thread):
+    def __init__(self, host, port, route, seconds):
+        super().__init__(daemon=True)
+        self.host, self.port, self.route, self.seconds = host, port, route, seconds
+        self.msgs = 0
+        self.bytes = 0
+        self.gaps = []
+        self.error = None
+
+    def handshake(self, sock):
+        key = base64.b64encode(os.urandom(16)).decode()
+        req = (f"GET {self.route} HTTP/1.1\r\n"
+               f"Host: {self.host}\r\n"
+               "Upgrade: websocket\r\n"
+               "Connection: Upgrade\r\n"
+               f"Sec-WebSocket-Key: {key}\r\n"
+               "Sec-WebSocket-Version: 13\r\n\r\n")
+        sock.sendall(req.encode())
+        head = b""
+        while b"\r\n\r\n" not in head:
+            chunk = sock.recv(1024)
+            if not chunk:
+                raise ConnectionError("closed during handshake")
+            head += chunk
+        status = head.split(b"\r\n", 1)[0]
+        if b" 101 " not in status:
+            raise ConnectionError(status.decode(errors="replace"))
+        return head.split(b"\r\n\r\n", 1)[1]
+
+    def run(self):
+        try:
+            sock = socket.create_connection((self.host, self.port), timeout=5)
+            buf = self.handshake(sock)
+            end = time.monotonic() + self.seconds
+            last = None
+            while time.monotonic() < end:
+                # Server frames are unmasked: 2 byte header, 16/64 bit length
+                while True:
+                    n = frame_length(buf)
+                    if n is None or len(buf) < n:
+                        break
+                    now = time.monotonic()
+                    if last is not None:
+                        self.gaps.append(now - last)
+                    last = now
+                    self.msgs += 1
+                    self.bytes += n
+                    buf = buf[n:]
+                chunk = sock.recv(65536)
+                if not chunk:
+                    raise ConnectionError("closed by server")
+                buf += chunk
+            sock.close()
+        except (OSError, ConnectionError) as exc:
+            self.error = str(exc)
+
+
+def frame_length(buf):
+    """Total size of the first frame in buf, or None if the header is incomplete."""
+    if len(buf) < 2:
+        return None
+    n = buf[1] & 0x7F
+    if n == 126:
+        return None if len(buf) < 4 else 4 + struct.unpack(">H", buf[2:4])[0]
+    if n == 127:
+        return None if len(buf) < 10 else 10 + struct.unpack(">Q", buf[2:10])[0]
+    return 2 + n
+
+
+def percentile(values, q):
+    if not values:
+        return float("nan")
+    values = sorted(values)
+    return values[min(len(values) - 1, int(q * len(values)))]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--port", type=int, default=80)
+    ap.add_argument("--clients", type=int, default=8, help="clients per route")
+    ap.add_argument("--seconds", type=float, default=20.0)
+    ap.add_argument("--routes", default="/ws/stream,/ws/eye")
+    args = ap.parse_args()
+
+    routes = [r for r in args.routes.split(",") if r]
+    clients = {r: [Client(args.host, args.port, r, args.seconds) for _ in range(args.clients)]
+               for r in routes}
+    for group in clients.values():
+        for c in group:
+            c.start()
+    for group in clients.values():
+        for c in group:
+            c.join(args.seconds + 10)
+
+    print(f"{'route':<12} {'clients':>7} {'msgs/s':>9} {'bytes/s':>11} "
+          f"{'gap p50':>8} {'gap p99':>8} {'gap max':>8} {'drops':>5}")
+    for route, group in clients.items():
+        msgs = sum(c.msgs for c in group)
+        nbytes = sum(c.bytes for c in group)
+        gaps = [g for c in group for g in c.gaps]
+        drops = sum(1 for c in group if c.error or c.is_alive())
+        print(f"{route:<12} {len(group):>7} {msgs / args.seconds:>9.1f} {nbytes / args.seconds:>11.0f} "
+              f"{percentile(gaps, 0.50) * 1e3:>8.1f} {percentile(gaps, 0.99) * 1e3:>8.1f} "
+              f"{(max(gaps) if gaps else float('nan')) * 1e3:>8.1f} {drops:>5}")
+        for c in group:
+            if c.error:
+                print(f"    {route}: {c.error}")
+
+
+if __name__ == "__main__":
+    main()